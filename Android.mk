@@ -102,6 +102,7 @@ LOCAL_SRC_FILES := \
     src/agent/main.cpp \
     src/agent/ncp_wpantund.cpp \
     src/common/event_emitter.cpp \
+    src/common/flight_recorder.cpp \
     src/common/logging.cpp \
     src/utils/hex.cpp \
     src/utils/strcpy_utils.cpp \
@@ -218,7 +218,7 @@ void BorderAgent::SendToCommissioner(void *aContext, int aEvent, va_list aArgume
         VerifyOrExit(sent == static_cast<ssize_t>(length), perror("send to commissioner"));
     }
 
-    otbrLog(OTBR_LOG_DEBUG, "Sent to commissioner");
+    otbrLogRateLimited(OTBR_LOG_DEBUG, "Sent to commissioner");
 
 exit:
     return;
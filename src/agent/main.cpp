@@ -59,9 +59,13 @@ std::mutex  threadMutex;
 static const char kSyslogIdent[]          = "otbr-agent";
 static const char kDefaultInterfaceName[] = "wpan0";
 
+// Size of the flight recorder ring.
+static const size_t kFlightRecorderSize = 1024 * 1024;
+
 // Default poll timeout.
 static const struct timeval kPollTimeout = {10, 0};
 static const struct option  kOptions[]   = {{"debug-level", required_argument, NULL, 'd'},
+                                         {"flight-recorder", required_argument, NULL, 'F'},
                                          {"help", no_argument, NULL, 'h'},
                                          {"thread-ifname", required_argument, NULL, 'I'},
                                          {"verbose", no_argument, NULL, 'v'},
@@ -142,9 +146,12 @@ static int Mainloop(AgentInstance &aInstance)
 static void PrintHelp(const char *aProgramName)
 {
 #if OTBR_ENABLE_NCP_WPANTUND
-    fprintf(stderr, "Usage: %s [-I interfaceName] [-d DEBUG_LEVEL] [-v]\n", aProgramName);
+    fprintf(stderr, "Usage: %s [-I interfaceName] [-d DEBUG_LEVEL] [-F FLIGHT_RECORDER] [-v]\n", aProgramName);
 #else
-    fprintf(stderr, "Usage: %s [-I interfaceName] [-d DEBUG_LEVEL] [-v] [RADIO_DEVICE] [RADIO_CONFIG]\n", aProgramName);
+    fprintf(stderr,
+            "Usage: %s [-I interfaceName] [-d DEBUG_LEVEL] [-F FLIGHT_RECORDER] [-v] [RADIO_DEVICE] "
+            "[RADIO_CONFIG]\n",
+            aProgramName);
 #endif
 }
 
@@ -161,8 +168,9 @@ int main(int argc, char *argv[])
     const char *     interfaceName = kDefaultInterfaceName;
     Ncp::Controller *ncp           = NULL;
     bool             verbose       = false;
+    const char *     recorderFile  = NULL;
 
-    while ((opt = getopt_long(argc, argv, "d:hI:Vv", kOptions, NULL)) != -1)
+    while ((opt = getopt_long(argc, argv, "d:F:hI:Vv", kOptions, NULL)) != -1)
     {
         switch (opt)
         {
@@ -170,6 +178,10 @@ int main(int argc, char *argv[])
             logLevel = atoi(optarg);
             break;
 
+        case 'F':
+            recorderFile = optarg;
+            break;
+
         case 'I':
             interfaceName = optarg;
             break;
@@ -204,6 +216,11 @@ int main(int argc, char *argv[])
 
     otbrLogInit(kSyslogIdent, logLevel, verbose);
 
+    if (recorderFile != NULL)
+    {
+        otbrLogSetFlightRecorder(recorderFile, kFlightRecorderSize);
+    }
+
     otbrLog(OTBR_LOG_INFO, "Thread interface %s", interfaceName);
 
     {
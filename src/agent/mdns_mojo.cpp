@@ -31,6 +31,8 @@
  *   This file includes implementation for MDNS service based on mojo.
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_MDNS
+
 #include <unistd.h>
 
 #include <base/at_exit.h>
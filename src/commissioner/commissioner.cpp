@@ -31,6 +31,8 @@
  *   The file implements the commissioner class
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_COMMISSIONER
+
 #include <vector>
 
 #include <assert.h>
@@ -44,6 +46,7 @@
 #include "common/code_utils.hpp"
 #include "common/logging.hpp"
 #include "common/tlv.hpp"
+#include "common/trace.hpp"
 #include "utils/hex.hpp"
 #include "utils/pskc.hpp"
 #include "utils/strcpy_utils.hpp"
@@ -83,6 +86,19 @@ static void MBedDebugPrint(void *aCtx, int aLevel, const char *aFile, int aLine,
     (void)aCtx;
 }
 
+/** Returns the joiner IID as a trace correlation id */
+static uint64_t GetJoinerTraceId(const uint8_t *aJoinerIid)
+{
+    uint64_t id = 0;
+
+    for (size_t i = 0; i < 8; i++)
+    {
+        id = (id << 8) | aJoinerIid[i];
+    }
+
+    return id;
+}
+
 /** dummy function for mbed */
 static int DummyKeyExport(void *               aContext,
                           const unsigned char *aMasterSecret,
@@ -208,18 +224,22 @@ void Commissioner::CommissionerPetition(void)
     uint8_t buffer[kSizeMaxPacket];
     Tlv *   tlv = reinterpret_cast<Tlv *>(buffer);
 
-    Coap::Message *message;
-    uint16_t       token = ++mCoapToken;
+    uint16_t token = ++mCoapToken;
 
     otbrLog(OTBR_LOG_INFO, "COMM_PET.req: start");
+    otbrTraceBegin("commissioner", "petition", 0);
     if (mCommissionerState == CommissionerState::kStateRejected)
     {
         sleep(kPetitionAttemptDelay);
         retryCount++;
     }
-    token   = htons(token);
-    message = mCoapAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, reinterpret_cast<const uint8_t *>(&token),
-                                     sizeof(token));
+    token = htons(token);
+
+    Coap::MessageHandle message(*mCoapAgent,
+                                mCoapAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost,
+                                                       reinterpret_cast<const uint8_t *>(&token), sizeof(token)));
+    VerifyOrExit(message.Get() != NULL, otbrLog(OTBR_LOG_ERR, "COMM_PET.req: no message buffer"));
+
     tlv->SetType(Meshcop::kCommissionerId);
     tlv->SetValue(kCommissionerId, sizeof(kCommissionerId));
     tlv = tlv->GetNext();
@@ -228,9 +248,11 @@ void Commissioner::CommissionerPetition(void)
     message->SetPayload(buffer, Utils::LengthOf(buffer, tlv));
     otbrLog(OTBR_LOG_INFO, "COMM_PET.req: send");
     mCoapAgent->Send(*message, NULL, 0, HandleCommissionerPetition, this);
-    mCoapAgent->FreeMessage(message);
 
     otbrLog(OTBR_LOG_INFO, "COMM_PET.req: complete");
+
+exit:
+    return;
 }
 
 void Commissioner::LogMeshcopState(const char *aPrefix, int8_t aState)
@@ -250,7 +272,7 @@ void Commissioner::LogMeshcopState(const char *aPrefix, int8_t aState)
 }
 
 /** handle c/cp response */
-void Commissioner::HandleCommissionerPetition(const Coap::Message &aMessage, void *aContext)
+void Commissioner::HandleCommissionerPetition(const Coap::Message *aMessage, otbrError aError, void *aContext)
 {
     uint16_t       length;
     int            tlvType;
@@ -258,8 +280,12 @@ void Commissioner::HandleCommissionerPetition(const Coap::Message &aMessage, voi
     const uint8_t *payload;
     Commissioner * commissioner = static_cast<Commissioner *>(aContext);
 
+    otbrTraceEnd("commissioner", "petition", 0);
+    VerifyOrExit(aError == OTBR_ERROR_NONE, otbrLogResult("COMM_PET.rsp", aError),
+                 commissioner->mCommissionerState = CommissionerState::kStateRejected);
+
     otbrLog(OTBR_LOG_INFO, "COMM_PET.rsp: start");
-    payload = aMessage.GetPayload(length);
+    payload = aMessage->GetPayload(length);
     tlv     = reinterpret_cast<const Tlv *>(payload);
 
     while (Utils::LengthOf(payload, tlv) < length)
@@ -299,20 +325,23 @@ void Commissioner::HandleCommissionerPetition(const Coap::Message &aMessage, voi
     gettimeofday(&commissioner->mLastKeepAliveTime, NULL);
     otbrLog(OTBR_LOG_INFO, "COMM_PET.rsp: complete");
 
+exit:
     commissioner->CommissionerResponseNext();
 }
 
 void Commissioner::CommissionerSet(const SteeringData &aSteeringData)
 {
-    uint16_t       token = ++mCoapToken;
-    uint8_t        buffer[kSizeMaxPacket];
-    Tlv *          tlv = reinterpret_cast<Tlv *>(buffer);
-    Coap::Message *message;
+    uint16_t token = ++mCoapToken;
+    uint8_t  buffer[kSizeMaxPacket];
+    Tlv *    tlv = reinterpret_cast<Tlv *>(buffer);
 
     otbrLog(OTBR_LOG_INFO, "COMMISSIONER_SET.req: start");
-    token   = htons(token);
-    message = mCoapAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, reinterpret_cast<const uint8_t *>(&token),
-                                     sizeof(token));
+    token = htons(token);
+
+    Coap::MessageHandle message(*mCoapAgent,
+                                mCoapAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost,
+                                                       reinterpret_cast<const uint8_t *>(&token), sizeof(token)));
+    VerifyOrExit(message.Get() != NULL, otbrLog(OTBR_LOG_ERR, "COMMISSIONER_SET.req: no message buffer"));
 
     tlv->SetType(Meshcop::kCommissionerSessionId);
     tlv->SetValue(mCommissionerSessionId);
@@ -328,10 +357,12 @@ void Commissioner::CommissionerSet(const SteeringData &aSteeringData)
     message->SetPayload(buffer, Utils::LengthOf(buffer, tlv));
     otbrLog(OTBR_LOG_INFO, "COMMISSIONER_SET.req: sent");
     mCoapAgent->Send(*message, NULL, 0, HandleCommissionerSet, this);
-    mCoapAgent->FreeMessage(message);
+
+exit:
+    return;
 }
 
-void Commissioner::HandleCommissionerSet(const Coap::Message &aMessage, void *aContext)
+void Commissioner::HandleCommissionerSet(const Coap::Message *aMessage, otbrError aError, void *aContext)
 {
     uint16_t       length;
     int            tlvType;
@@ -339,8 +370,10 @@ void Commissioner::HandleCommissionerSet(const Coap::Message &aMessage, void *aC
     const uint8_t *payload;
     Commissioner * commissioner = static_cast<Commissioner *>(aContext);
 
+    VerifyOrExit(aError == OTBR_ERROR_NONE, otbrLogResult("COMMISSIONER_SET.rsp", aError));
+
     otbrLog(OTBR_LOG_INFO, "COMMISSIONER_SET.rsp: start");
-    payload = (aMessage.GetPayload(length));
+    payload = (aMessage->GetPayload(length));
     tlv     = reinterpret_cast<const Tlv *>(payload);
 
     while (Utils::LengthOf(payload, tlv) < length)
@@ -365,6 +398,7 @@ void Commissioner::HandleCommissionerSet(const Coap::Message &aMessage, void *aC
     }
     otbrLog(OTBR_LOG_INFO, "COMMISSIONER_SET.rsp: complete");
 
+exit:
     commissioner->CommissionerResponseNext();
 }
 
@@ -396,6 +430,7 @@ void Commissioner::UpdateFdSet(fd_set & aReadFdSet,
     aMaxFd = Utils::Max(mSslClientFd.fd, aMaxFd);
     FD_SET(mJoinerSessionClientFd, &aReadFdSet);
     aMaxFd = Utils::Max(mJoinerSessionClientFd, aMaxFd);
+    mCoapAgent->UpdateFdSet(aReadFdSet, aWriteFdSet, aErrorFdSet, aMaxFd, aTimeout);
     if (mJoinerSession)
     {
         mJoinerSession->UpdateFdSet(aReadFdSet, aWriteFdSet, aErrorFdSet, aMaxFd, aTimeout);
@@ -411,6 +446,7 @@ void Commissioner::Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet,
     {
         mJoinerSession->Process(aReadFdSet, aWriteFdSet, aErrorFdSet);
     }
+    mCoapAgent->Process(aReadFdSet, aWriteFdSet, aErrorFdSet);
     if (FD_ISSET(mSslClientFd.fd, &aReadFdSet))
     {
         int n = mbedtls_ssl_read(&mSsl, buffer, sizeof(buffer));
@@ -433,7 +469,7 @@ void Commissioner::Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet,
             {
                 char buf[kIPAddrNameBufSize];
                 GetIPString((struct sockaddr *)(&from_addr), buf, sizeof(buf));
-                otbrLog(OTBR_LOG_INFO, "relay from: %s\n", buf);
+                otbrLogRateLimited(OTBR_LOG_INFO, "relay from: %s", buf);
             }
             SendRelayTransmit(buffer, static_cast<uint16_t>(n));
         }
@@ -456,13 +492,15 @@ void Commissioner::Resign(void)
 
 void Commissioner::SendCommissionerKeepAlive(int8_t aState)
 {
-    uint8_t        buffer[kSizeMaxPacket];
-    Tlv *          tlv = reinterpret_cast<Tlv *>(buffer);
-    Coap::Message *message;
+    uint8_t buffer[kSizeMaxPacket];
+    Tlv *   tlv = reinterpret_cast<Tlv *>(buffer);
 
     mCoapToken++;
-    message = mCoapAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost,
-                                     reinterpret_cast<const uint8_t *>(&mCoapToken), sizeof(mCoapToken));
+
+    Coap::MessageHandle message(*mCoapAgent, mCoapAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost,
+                                                                     reinterpret_cast<const uint8_t *>(&mCoapToken),
+                                                                     sizeof(mCoapToken)));
+    VerifyOrExit(message.Get() != NULL, otbrLog(OTBR_LOG_ERR, "COMM_KA.req: no message buffer"));
 
     tlv->SetType(Meshcop::kState);
     tlv->SetValue(aState);
@@ -479,11 +517,13 @@ void Commissioner::SendCommissionerKeepAlive(int8_t aState)
     gettimeofday(&mLastKeepAliveTime, NULL);
     mKeepAliveTxCount += 1;
     mCoapAgent->Send(*message, NULL, 0, HandleCommissionerKeepAlive, this);
-    mCoapAgent->FreeMessage(message);
+
+exit:
+    return;
 }
 
 /** Handle a COMM_KA response */
-void Commissioner::HandleCommissionerKeepAlive(const Coap::Message &aMessage, void *aContext)
+void Commissioner::HandleCommissionerKeepAlive(const Coap::Message *aMessage, otbrError aError, void *aContext)
 {
     uint16_t       length;
     int            tlvType;
@@ -491,13 +531,16 @@ void Commissioner::HandleCommissionerKeepAlive(const Coap::Message &aMessage, vo
     const uint8_t *payload;
     Commissioner * commissioner = static_cast<Commissioner *>(aContext);
 
+    VerifyOrExit(aError == OTBR_ERROR_NONE, otbrLogResult("COMM_KA.rsp", aError),
+                 commissioner->mCommissionerState = CommissionerState::kStateRejected);
+
     otbrLog(OTBR_LOG_INFO, "COMM_KA.rsp: start");
 
     /* record stats */
     gettimeofday(&commissioner->mLastKeepAliveTime, NULL);
     commissioner->mKeepAliveRxCount += 1;
 
-    payload = (aMessage.GetPayload(length));
+    payload = (aMessage->GetPayload(length));
     tlv     = reinterpret_cast<const Tlv *>(payload);
 
     while (Utils::LengthOf(payload, tlv) < length)
@@ -530,6 +573,7 @@ void Commissioner::HandleCommissionerKeepAlive(const Coap::Message &aMessage, vo
     }
     otbrLog(OTBR_LOG_INFO, "COMM_KA.rsp: complete");
 
+exit:
     commissioner->CommissionerResponseNext();
 }
 
@@ -545,6 +589,7 @@ void Commissioner::HandleRelayReceive(const Coap::Resource &aResource,
     uint16_t       length;
     Commissioner * commissioner = static_cast<Commissioner *>(aContext);
     const uint8_t *payload      = aMessage.GetPayload(length);
+    TraceScope     trace("joiner", "relay-receive");
 
     for (const Tlv *requestTlv = reinterpret_cast<const Tlv *>(payload); Utils::LengthOf(payload, requestTlv) < length;
          requestTlv            = requestTlv->GetNext())
@@ -568,6 +613,11 @@ void Commissioner::HandleRelayReceive(const Coap::Resource &aResource,
             break;
 
         case Meshcop::kJoinerIid:
+            // the first relayed message of a joiner begins its join span
+            if (memcmp(commissioner->mJoinerIid, requestTlv->GetValue(), sizeof(commissioner->mJoinerIid)) != 0)
+            {
+                otbrTraceBegin("joiner", "join", GetJoinerTraceId(requestTlv->GetValue()));
+            }
             memcpy(commissioner->mJoinerIid, requestTlv->GetValue(), sizeof(commissioner->mJoinerIid));
             break;
 
@@ -583,6 +633,7 @@ void Commissioner::HandleRelayReceive(const Coap::Resource &aResource,
     }
 
 exit:
+    trace.SetId(GetJoinerTraceId(commissioner->mJoinerIid));
 
     (void)aResource;
     (void)aResponse;
@@ -594,6 +645,7 @@ exit:
 
 ssize_t Commissioner::SendRelayTransmit(uint8_t *aBuf, size_t aLength)
 {
+    ssize_t ret = -1;
     uint8_t payload[kSizeMaxPacket];
     Tlv *   responseTlv = reinterpret_cast<Tlv *>(payload);
 
@@ -622,6 +674,8 @@ ssize_t Commissioner::SendRelayTransmit(uint8_t *aBuf, size_t aLength)
         mJoinerSession->GetKek(kek, sizeof(kek));
         mJoinerSession->MarkKekSent();
         otbrLog(OTBR_LOG_INFO, "relay: KEK state");
+        otbrTraceInstant("joiner", "kek-relay", GetJoinerTraceId(mJoinerIid));
+        otbrTraceEnd("joiner", "join", GetJoinerTraceId(mJoinerIid));
         responseTlv->SetType(Meshcop::kJoinerRouterKek);
         responseTlv->SetValue(kek, sizeof(kek));
         responseTlv = responseTlv->GetNext();
@@ -629,19 +683,22 @@ ssize_t Commissioner::SendRelayTransmit(uint8_t *aBuf, size_t aLength)
     }
 
     {
-        Coap::Message *message;
-        uint16_t       token = ++mCoapToken;
+        uint16_t            token = ++mCoapToken;
+        Coap::MessageHandle message(*mCoapAgent,
+                                    mCoapAgent->NewMessage(Coap::kTypeNonConfirmable, Coap::kCodePost,
+                                                           reinterpret_cast<const uint8_t *>(&token), sizeof(token)));
 
-        message = mCoapAgent->NewMessage(Coap::kTypeNonConfirmable, Coap::kCodePost,
-                                         reinterpret_cast<const uint8_t *>(&token), sizeof(token));
+        VerifyOrExit(message.Get() != NULL, otbrLog(OTBR_LOG_ERR, "RELAY_tx.req: no message buffer"));
         message->SetPath(OT_URI_PATH_RELAY_TX);
         message->SetPayload(payload, Utils::LengthOf(payload, responseTlv));
         otbrLog(OTBR_LOG_INFO, "RELAY_tx.req: send");
         mCoapAgent->Send(*message, NULL, 0, NULL, this);
-        mCoapAgent->FreeMessage(message);
     }
 
-    return static_cast<ssize_t>(aLength);
+    ret = static_cast<ssize_t>(aLength);
+
+exit:
+    return ret;
 }
 
 int Commissioner::GetNumFinalizedJoiners(void) const
@@ -197,9 +197,9 @@ private:
 
     static void LogMeshcopState(const char *aPrefix, int8_t aState);
 
-    static void HandleCommissionerPetition(const Coap::Message &aMessage, void *aContext);
-    static void HandleCommissionerSet(const Coap::Message &aMessage, void *aContext);
-    static void HandleCommissionerKeepAlive(const Coap::Message &aMessage, void *aContext);
+    static void HandleCommissionerPetition(const Coap::Message *aMessage, otbrError aError, void *aContext);
+    static void HandleCommissionerSet(const Coap::Message *aMessage, otbrError aError, void *aContext);
+    static void HandleCommissionerKeepAlive(const Coap::Message *aMessage, otbrError aError, void *aContext);
     void        CommissionerResponseNext(void);
 
     static void HandleRelayReceive(const Coap::Resource &aResource,
@@ -30,6 +30,8 @@
  * @file
  *   The file implements the command line params for the commissioner test app.
  */
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_COMMISSIONER
+
 #include "commissioner_argcargv.hpp"
 
 #include <assert.h>
@@ -118,6 +120,7 @@ static void PrintUsage(const char *aProgram, FILE *aStream, int aExitCode)
             "    -D, --joiner-pskd          STRING      Joiner's base32-thread encoded PSK\n"
             "    -L, --steering-data-length NUMBER      Steering data length(1~16)\n"
             "    -l, --log-file             PATH        Log to file\n"
+            "    -t, --trace-file           PATH        Export Chrome trace of the commissioning to file\n"
             "    -i, --keep-alive-interval  NUMBER      COMM_KA requests interval\n"
             "    -d, --debug-level          NUMBER      Debug level(0~7)\n"
             "    -q, --disable-syslog                   Disable log via syslog\n"
@@ -139,6 +142,7 @@ otbrError ParseArgs(int aArgc, char *aArgv[], CommissionerArgs &aArgs)
                                       {"agent-port", required_argument, NULL, 'P'},
                                       {"steering-data-length", required_argument, NULL, 'L'},
                                       {"log-file", required_argument, NULL, 'l'},
+                                      {"trace-file", required_argument, NULL, 't'},
                                       {"disable-syslog", no_argument, NULL, 'q'},
                                       {"debug-level", required_argument, NULL, 'd'},
                                       {"keep-alive-interval", required_argument, NULL, 'i'},
@@ -167,7 +171,7 @@ otbrError ParseArgs(int aArgc, char *aArgv[], CommissionerArgs &aArgs)
 
     while (true)
     {
-        int option = getopt_long(aArgc, aArgv, "E:D:AC:N:X:H:P:L:l:qd:i:h", options, NULL);
+        int option = getopt_long(aArgc, aArgv, "E:D:AC:N:X:H:P:L:l:t:qd:i:h", options, NULL);
 
         if (option == -1)
         {
@@ -226,6 +230,9 @@ otbrError ParseArgs(int aArgc, char *aArgv[], CommissionerArgs &aArgs)
         case 'l':
             otbrLogSetFilename(optarg);
             break;
+        case 't':
+            aArgs.mTraceFile = optarg;
+            break;
         case 'd':
             aArgs.mDebugLevel = atoi(optarg);
             VerifyOrExit(aArgs.mDebugLevel >= 1 and aArgs.mDebugLevel <= 7,
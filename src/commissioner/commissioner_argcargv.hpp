@@ -55,6 +55,8 @@ struct CommissionerArgs
     int          mKeepAliveInterval;
 
     int mDebugLevel;
+
+    const char *mTraceFile;
 };
 
 otbrError ParseArgs(int aArgc, char *aArgv[], CommissionerArgs &aArgs);
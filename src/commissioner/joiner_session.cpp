@@ -31,11 +31,18 @@
  *   The file implements the dtls session class to communicate with the joiner
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_COMMISSIONER
+
 #include "joiner_session.hpp"
+
+#include <errno.h>
+
 #include "commissioner_utils.hpp"
 #include "agent/uris.hpp"
+#include "common/code_utils.hpp"
 #include "common/logging.hpp"
 #include "common/tlv.hpp"
+#include "common/trace.hpp"
 
 namespace ot {
 namespace BorderRouter {
@@ -45,6 +52,7 @@ JoinerSession::JoinerSession(uint16_t aInternalServerPort, const char *aPskdAsci
     , mCoapAgent(Coap::Agent::Create(JoinerSession::SendCoap, this))
     , mJoinerFinalizeHandler(OT_URI_PATH_JOINER_FINALIZE, HandleJoinerFinalize, this)
     , mNeedAppendKek(false)
+    , mNextPort(0)
 {
     mDtlsServer->SetPSK(reinterpret_cast<const uint8_t *>(aPskdAscii), static_cast<uint8_t>(strlen(aPskdAscii)));
     mDtlsServer->Start();
@@ -58,18 +66,40 @@ void JoinerSession::HandleSessionChange(Dtls::Session &aSession, Dtls::Session::
     switch (aState)
     {
     case Dtls::Session::kStateReady:
-        memcpy(joinerSession->mKek, aSession.GetKek(), sizeof(joinerSession->mKek));
-        aSession.SetDataHandler(JoinerSession::FeedCoap, joinerSession);
-        joinerSession->mDtlsSession = &aSession;
+    {
+        uint16_t port;
+
+        // each joiner is a distinct CoAP peer, so responses go back through its own session
+        do
+        {
+            port = ++joinerSession->mNextPort;
+        } while (port == 0 || joinerSession->mJoiners.count(port) != 0);
+
+        Joiner &joiner = joinerSession->mJoiners[port];
+
+        joiner.mJoinerSession = joinerSession;
+        joiner.mSession       = &aSession;
+        joiner.mPort          = port;
+        memcpy(joiner.mKek, aSession.GetKek(), sizeof(joiner.mKek));
+        aSession.SetDataHandler(JoinerSession::FeedCoap, &joiner);
         break;
+    }
 
     case Dtls::Session::kStateClose:
         break;
 
     case Dtls::Session::kStateError:
     case Dtls::Session::kStateEnd:
-        joinerSession->mDtlsSession = NULL;
+        for (JoinerMap::iterator it = joinerSession->mJoiners.begin(); it != joinerSession->mJoiners.end(); ++it)
+        {
+            if (it->second.mSession == &aSession)
+            {
+                joinerSession->mJoiners.erase(it);
+                break;
+            }
+        }
         break;
+
     default:
         break;
     }
@@ -81,12 +111,19 @@ ssize_t JoinerSession::SendCoap(const uint8_t *aBuffer,
                                 uint16_t       aPort,
                                 void *         aContext)
 {
-    ssize_t        ret           = 0;
-    JoinerSession *joinerSession = static_cast<JoinerSession *>(aContext);
+    ssize_t             ret           = 0;
+    JoinerSession *     joinerSession = static_cast<JoinerSession *>(aContext);
+    JoinerMap::iterator it            = joinerSession->mJoiners.find(aPort);
 
-    if (joinerSession->mDtlsSession)
+    if (it != joinerSession->mJoiners.end())
     {
-        ret = joinerSession->mDtlsSession->Write(aBuffer, aLength);
+        ret = it->second.mSession->Write(aBuffer, aLength);
+
+        if (ret == -1 && errno == EAGAIN)
+        {
+            // the agent retransmits a confirmable message, a lost response is replayed when the joiner retries
+            otbrLogRateLimited(OTBR_LOG_WARNING, "SendCoap: DTLS session congested");
+        }
     }
     else
     {
@@ -95,15 +132,14 @@ ssize_t JoinerSession::SendCoap(const uint8_t *aBuffer,
     }
 
     (void)aIp6;
-    (void)aPort;
 
     return ret;
 }
 
 void JoinerSession::FeedCoap(const uint8_t *aBuffer, uint16_t aLength, void *aContext)
 {
-    JoinerSession *joinerSession = static_cast<JoinerSession *>(aContext);
-    joinerSession->mCoapAgent->Input(aBuffer, aLength, NULL, 0);
+    Joiner *joiner = static_cast<Joiner *>(aContext);
+    joiner->mJoinerSession->mCoapAgent->Input(aBuffer, aLength, NULL, joiner->mPort);
 }
 
 void JoinerSession::HandleJoinerFinalize(const Coap::Resource &aResource,
@@ -113,11 +149,17 @@ void JoinerSession::HandleJoinerFinalize(const Coap::Resource &aResource,
                                          uint16_t              aPort,
                                          void *                aContext)
 {
-    JoinerSession *joinerSession = static_cast<JoinerSession *>(aContext);
-    uint8_t        payload[10];
-    Tlv *          responseTlv = reinterpret_cast<Tlv *>(payload);
+    JoinerSession *     joinerSession = static_cast<JoinerSession *>(aContext);
+    JoinerMap::iterator it            = joinerSession->mJoiners.find(aPort);
+    uint8_t             payload[10];
+    Tlv *               responseTlv = reinterpret_cast<Tlv *>(payload);
+
+    VerifyOrExit(it != joinerSession->mJoiners.end());
 
+    // relay the KEK of the joiner being finalized, not of whichever session got ready last
+    memcpy(joinerSession->mKek, it->second.mKek, sizeof(joinerSession->mKek));
     joinerSession->mNeedAppendKek = true;
+    otbrTraceInstant("dtls", "joiner-finalize", reinterpret_cast<uintptr_t>(it->second.mSession));
 
     responseTlv->SetType(Meshcop::kState);
     responseTlv->SetValue(static_cast<uint8_t>(Meshcop::kStateAccepted));
@@ -127,15 +169,16 @@ void JoinerSession::HandleJoinerFinalize(const Coap::Resource &aResource,
     aResponse.SetCode(Coap::kCodeChanged);
     aResponse.SetPayload(payload, Utils::LengthOf(payload, responseTlv));
 
+exit:
     (void)aResource;
     (void)aRequest;
     (void)aIp6;
-    (void)aPort;
 }
 
 void JoinerSession::Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet, const fd_set &aErrorFdSet)
 {
     mDtlsServer->Process(aReadFdSet, aWriteFdSet, aErrorFdSet);
+    mCoapAgent->Process(aReadFdSet, aWriteFdSet, aErrorFdSet);
 }
 
 void JoinerSession::UpdateFdSet(fd_set & aReadFdSet,
@@ -145,6 +188,7 @@ void JoinerSession::UpdateFdSet(fd_set & aReadFdSet,
                                 timeval &aTimeout)
 {
     mDtlsServer->UpdateFdSet(aReadFdSet, aWriteFdSet, aErrorFdSet, aMaxFd, aTimeout);
+    mCoapAgent->UpdateFdSet(aReadFdSet, aWriteFdSet, aErrorFdSet, aMaxFd, aTimeout);
 }
 
 bool JoinerSession::NeedAppendKek(void)
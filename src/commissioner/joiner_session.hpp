@@ -34,6 +34,8 @@
 #ifndef OTBR_JOINER_SESSION_HPP_
 #define OTBR_JOINER_SESSION_HPP_
 
+#include <map>
+
 #include <sys/socket.h>
 
 #include "commissioner_constants.hpp"
@@ -113,6 +115,20 @@ private:
     JoinerSession(const JoinerSession &);
     JoinerSession &operator=(const JoinerSession &);
 
+    /**
+     * This structure represents an established DTLS session with a joiner.
+     *
+     */
+    struct Joiner
+    {
+        JoinerSession *mJoinerSession; ///< The joiner session owning this joiner.
+        Dtls::Session *mSession;       ///< The DTLS session of this joiner.
+        uint16_t       mPort;          ///< The CoAP peer port identifying this joiner.
+        uint8_t        mKek[kKEKSize]; ///< The KEK derived by the handshake of this joiner.
+    };
+
+    typedef std::map<uint16_t, Joiner> JoinerMap;
+
     static void    HandleSessionChange(Dtls::Session &aSession, Dtls::Session::State aState, void *aContext);
     static ssize_t SendCoap(const uint8_t *aBuffer,
                             uint16_t       aLength,
@@ -127,13 +143,14 @@ private:
                                         uint16_t              aPort,
                                         void *                aContext);
 
-    uint8_t mKek[kKEKSize];
+    uint8_t mKek[kKEKSize]; ///< The KEK of the last finalized joiner, until relayed.
 
     Dtls::Server * mDtlsServer;
-    Dtls::Session *mDtlsSession;
     Coap::Agent *  mCoapAgent;
     Coap::Resource mJoinerFinalizeHandler;
     bool           mNeedAppendKek;
+    JoinerMap      mJoiners; ///< Established joiners keyed by their CoAP peer port.
+    uint16_t       mNextPort;
 };
 
 } // namespace BorderRouter
@@ -31,6 +31,8 @@
  *   The file is the entry point for commissioner
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_COMMISSIONER
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -41,11 +43,17 @@
 #include "commissioner_argcargv.hpp"
 #include "common/code_utils.hpp"
 #include "common/logging.hpp"
+#include "common/trace.hpp"
 #include "utils/hex.hpp"
 
 using namespace ot;
 using namespace ot::BorderRouter;
 
+enum
+{
+    kTraceCapacity = 65536, ///< Number of trace events kept for export.
+};
+
 static void HandleSignal(int aSignal)
 {
     signal(aSignal, SIG_DFL);
@@ -65,16 +73,23 @@ int main(int argc, char **argv)
 
     srand(static_cast<unsigned int>(time(0)));
 
+    if (args.mTraceFile != NULL)
+    {
+        otbrTraceInit(kTraceCapacity);
+    }
+
     {
         Commissioner commissioner(args.mPSKc, args.mKeepAliveInterval);
         bool         joinerSetDone = false;
 
         commissioner.InitDtls(args.mAgentHost, args.mAgentPort);
 
+        otbrTraceBegin("commissioner", "dtls-handshake", 0);
         do
         {
             ret = commissioner.TryDtlsHandshake();
         } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+        otbrTraceEnd("commissioner", "dtls-handshake", 0);
 
         if (commissioner.IsValid())
         {
@@ -110,6 +125,15 @@ int main(int argc, char **argv)
         }
     }
 
+    if (args.mTraceFile != NULL)
+    {
+        if (otbrTraceExport(args.mTraceFile) != OTBR_ERROR_NONE)
+        {
+            fprintf(stderr, "Cannot export trace to %s: %s\n", args.mTraceFile, strerror(errno));
+        }
+        otbrTraceDeinit();
+    }
+
 exit:
     return error;
 }
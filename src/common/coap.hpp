@@ -34,9 +34,13 @@
 #ifndef COAP_HPP_
 #define COAP_HPP_
 
+#include <assert.h>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 
+#include <sys/select.h>
+
 #include "types.hpp"
 
 namespace ot {
@@ -72,17 +76,86 @@ enum Type
  */
 enum Code
 {
-    kCodeEmpty   = 0x00, ///< Empty message code
-    kCodeGet     = 0x01, ///< Get
-    kCodePost    = 0x02, ///< Post
-    kCodePut     = 0x03, ///< Put
-    kCodeDelete  = 0x04, ///< Delete
-    kCodeCodeMin = 0x40, ///< 2.00
-    kCodeCreated = 0x41, ///< Created
-    kCodeDeleted = 0x42, ///< Deleted
-    kCodeValid   = 0x43, ///< Valid
-    kCodeChanged = 0x44, ///< Changed
-    kCodeContent = 0x45, ///< Content
+    kCodeEmpty    = 0x00, ///< Empty message code
+    kCodeGet      = 0x01, ///< Get
+    kCodePost     = 0x02, ///< Post
+    kCodePut      = 0x03, ///< Put
+    kCodeDelete   = 0x04, ///< Delete
+    kCodeCodeMin  = 0x40, ///< 2.00
+    kCodeCreated  = 0x41, ///< Created
+    kCodeDeleted  = 0x42, ///< Deleted
+    kCodeValid    = 0x43, ///< Valid
+    kCodeChanged  = 0x44, ///< Changed
+    kCodeContent  = 0x45, ///< Content
+    kCodeContinue = 0x5f, ///< Continue
+
+    kCodeBadRequest              = 0x80, ///< Bad Request
+    kCodeNotFound                = 0x84, ///< Not Found
+    kCodeMethodNotAllowed        = 0x85, ///< Method Not Allowed
+    kCodeRequestEntityIncomplete = 0x88, ///< Request Entity Incomplete
+    kCodeRequestEntityTooLarge   = 0x8d, ///< Request Entity Too Large
+};
+
+/**
+ * CoAP Option numbers.
+ *
+ */
+enum OptionNumber
+{
+    kOptionObserve = 6,  ///< Observe
+    kOptionUriPath = 11, ///< Uri-Path
+    kOptionBlock2  = 23, ///< Block2
+    kOptionBlock1  = 27, ///< Block1
+};
+
+/**
+ * CoAP Observe option values in requests.
+ *
+ */
+enum
+{
+    kObserveRegister   = 0, ///< Register as an observer.
+    kObserveDeregister = 1, ///< Deregister as an observer.
+};
+
+/**
+ * This structure represents the value of a Block1 or Block2 option.
+ *
+ */
+struct Block
+{
+    uint32_t mNumber; ///< The block number.
+    bool     mMore;   ///< Whether more blocks follow.
+    uint16_t mSize;   ///< The block size, a power of two from 16 to 1024.
+};
+
+/**
+ * This structure represents the metrics of a Uri Path, both as a resource of this agent and as requested by it.
+ *
+ */
+struct Metrics
+{
+    enum
+    {
+        kMaxPathLength = 32, ///< Max length of the path, including the null character.
+        kCodeClasses   = 8,  ///< Number of response code classes.
+        kRttBuckets    = 12, ///< Number of buckets of the round trip time histogram.
+        kRttMinBound   = 16, ///< Upper bound of the first bucket in milliseconds, doubling for each next bucket.
+    };
+
+    char     mPath[kMaxPathLength];            ///< The Uri Path, "*" for paths once the metrics table is full.
+    uint32_t mRequestsReceived;                ///< Number of requests handled, not counting duplicates.
+    uint32_t mDuplicatesReceived;              ///< Number of duplicate requests answered from the cache.
+    uint32_t mResponsesSent[kCodeClasses];     ///< Number of piggybacked responses sent, by code class.
+    uint32_t mRequestsSent;                    ///< Number of requests sent.
+    uint32_t mRetransmissions;                 ///< Number of retransmissions of requests sent.
+    uint32_t mTimeouts;                        ///< Number of requests sent that got no response.
+    uint32_t mResets;                          ///< Number of requests sent that were reset by the peer.
+    uint32_t mResponsesReceived[kCodeClasses]; ///< Number of responses received, by code class.
+    uint32_t mRtt[kRttBuckets];                ///< Round trip times from the first transmission to the response, the
+                                               ///< last bucket counts all longer than the bound of the previous one.
+    uint32_t mRttMax;                          ///< Max round trip time in milliseconds.
+    uint64_t mRttTotal;                        ///< Sum of round trip times in milliseconds.
 };
 
 /**
@@ -156,6 +229,8 @@ public:
     /**
      * This method returns the payload of this message.
      *
+     * For a received message, the payload is not copied and the pointer is only valid until the handler returns.
+     *
      * @param[out]  aLength     Number of bytes of the payload.
      *
      * @returns A pointer to the payload buffer.
@@ -170,8 +245,75 @@ public:
      *
      */
     virtual void SetPayload(const uint8_t *aPayload, uint16_t aLength) = 0;
+
+    /**
+     * This method returns a Block1 or Block2 option of this message.
+     *
+     * @param[in]   aOption     The option, kOptionBlock1 or kOptionBlock2.
+     * @param[out]  aBlock      A reference to where to store the block.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully got the block option.
+     * @retval  OTBR_ERROR_ERRNO    Failed to get the block option.
+     *                              - ENOENT The option is absent.
+     *                              - EBADMSG The option is malformed.
+     *
+     */
+    virtual otbrError GetBlock(OptionNumber aOption, Block &aBlock) const = 0;
+
+    /**
+     * This method sets a Block1 or Block2 option of this message, replacing any existing one.
+     *
+     * @param[in]   aOption     The option, kOptionBlock1 or kOptionBlock2.
+     * @param[in]   aBlock      A reference to the block.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully set the block option.
+     * @retval  OTBR_ERROR_ERRNO    Failed to set the block option.
+     *                              - EINVAL The block size or number is invalid.
+     *                              - EMSGSIZE No space left in the message.
+     *
+     */
+    virtual otbrError SetBlock(OptionNumber aOption, const Block &aBlock) = 0;
+
+    /**
+     * This method returns the Observe option of this message.
+     *
+     * @param[out]  aObserve    A reference to where to store the option value, 0 to register and 1 to deregister in
+     *                          requests, the sequence number in notifications.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully got the Observe option.
+     * @retval  OTBR_ERROR_ERRNO    Failed to get the Observe option.
+     *                              - ENOENT The option is absent.
+     *                              - EBADMSG The option is malformed.
+     *
+     */
+    virtual otbrError GetObserve(uint32_t &aObserve) const = 0;
+
+    /**
+     * This method sets the Observe option of this message, replacing any existing one.
+     *
+     * @param[in]   aObserve    The option value, only the lower 24 bits are used.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully set the Observe option.
+     * @retval  OTBR_ERROR_ERRNO    No space left in the message, errno is set to EMSGSIZE.
+     *
+     */
+    virtual otbrError SetObserve(uint32_t aObserve) = 0;
 };
 
+/**
+ * This function pointer is called to read the payload of a block-wise request, one block at a time.
+ *
+ * @param[in]   aOffset     The offset of the block in the payload.
+ * @param[out]  aBuffer     A pointer to where to store the block.
+ * @param[in]   aLength     The size of the block.
+ * @param[in]   aContext    A pointer to application-specific context.
+ *
+ * @returns Number of bytes read, less than @p aLength only for the last block. A negative value indicates failure
+ *          with errno set.
+ *
+ */
+typedef ssize_t (*BlockReader)(uint32_t aOffset, uint8_t *aBuffer, uint16_t aLength, void *aContext);
+
 /**
  * @typedef struct Resource
  *
@@ -199,36 +341,76 @@ typedef void (*RequestHandler)(const Resource &aResource,
                                void *          aContext);
 
 /**
- * This function pointer is called when a CoAP response received.
+ * This function pointer is called when a CoAP response received, or when the request failed.
  *
- * @param[in]   aMessage        A pointer to the response message.
+ * @param[in]   aMessage        A pointer to the response message, NULL if the request failed.
+ * @param[in]   aError          OTBR_ERROR_NONE if a response is received, otherwise OTBR_ERROR_ERRNO with errno set to
+ *                              - ETIMEDOUT No response after all retransmissions.
+ *                              - ECONNRESET The request was reset by the peer.
  * @param[in]   aContext        A pointer to application-specific context.
  *
  */
-typedef void (*ResponseHandler)(const Message &aMessage, void *aContext);
+typedef void (*ResponseHandler)(const Message *aMessage, otbrError aError, void *aContext);
 
 /**
- * This struct defines a CoAP resource and its handler.
+ * This struct defines a CoAP resource and its handlers.
+ *
+ * A last path segment of `*` makes a prefix resource, which also receives requests to any path under it, e.g. the
+ * path "d" followed by segment `*` receives requests to "d", "d/dg" and "d/dg/x". Resources with an exact path take
+ * precedence, then the longest prefix.
+ *
  */
 struct Resource
 {
-    void *         mContext; ///< A pointer to application-specific context.
-    const char *   mPath;    ///< The CoAP Uri Path.
-    RequestHandler mHandler; ///< The function to handle request to mPath.
+    enum
+    {
+        kMaxMethods = kCodeDelete, ///< Number of request methods, GET, POST, PUT and DELETE.
+    };
+
+    void *         mContext;               ///< A pointer to application-specific context.
+    const char *   mPath;                  ///< The CoAP Uri Path.
+    RequestHandler mHandlers[kMaxMethods]; ///< The functions to handle requests to mPath, indexed by method code - 1.
 
     /**
-     * The constructor to initialize a CoAP resource.
+     * The constructor to initialize a CoAP resource handling POST requests.
      *
      * @param[in]   aPath       The resource path.
-     * @param[in]   aHandler    The function to be called when received request to this resource.
-     * @param[in]   aContext        A pointer to application-specific context.
+     * @param[in]   aHandler    The function to be called when received POST request to this resource.
+     * @param[in]   aContext    A pointer to application-specific context.
      *
      */
     Resource(const char *aPath, RequestHandler aHandler, void *aContext)
         : mContext(aContext)
         , mPath(aPath)
-        , mHandler(aHandler)
     {
+        memset(mHandlers, 0, sizeof(mHandlers));
+        SetHandler(kCodePost, aHandler);
+    }
+
+    /**
+     * This method sets the handler of a request method.
+     *
+     * @param[in]   aMethod     The request method, one of kCodeGet, kCodePost, kCodePut and kCodeDelete.
+     * @param[in]   aHandler    The function to be called when received @p aMethod request, NULL to not allow it.
+     *
+     */
+    void SetHandler(Code aMethod, RequestHandler aHandler)
+    {
+        assert(aMethod >= kCodeGet && aMethod <= kCodeDelete);
+        mHandlers[aMethod - kCodeGet] = aHandler;
+    }
+
+    /**
+     * This method returns the handler of a request method.
+     *
+     * @param[in]   aMethod     The request method.
+     *
+     * @returns The function to handle @p aMethod requests, NULL if the method is not allowed.
+     *
+     */
+    RequestHandler GetHandler(Code aMethod) const
+    {
+        return (aMethod >= kCodeGet && aMethod <= kCodeDelete) ? mHandlers[aMethod - kCodeGet] : NULL;
     }
 };
 
@@ -257,6 +439,9 @@ public:
     /**
      * This method processes this CoAP message in @p aBuffer, which can be a request or response.
      *
+     * The message is parsed in place, so @p aBuffer is borrowed only for the duration of this call. Handlers get
+     * payloads and options pointing into it, and must copy anything they keep.
+     *
      * @param[in]   aBuffer     A pointer to decrypted data.
      * @param[in]   aLength     Number of bytes of @p aBuffer.
      * @param[in]   aIp6        A pointer to the source Ipv6 address of this request.
@@ -273,7 +458,7 @@ public:
      * @param[in]   aToken          The CoAP token.
      * @param[in]   aTokenLength    Number of bytes in @p aToken.
      *
-     * @returns The newly CoAP message.
+     * @returns The newly CoAP message, or NULL if no message is available.
      *
      */
     virtual Message *NewMessage(Type aType, Code aCode, const uint8_t *aToken, uint8_t aTokenLength) = 0;
@@ -317,9 +502,14 @@ public:
      * @param[in]   aHandler    A function poiner to be called when response is received if the message is a request.
      * @param[in]   aContext    A pointer to application-specific context.
      *
+     * Confirmable messages are retransmitted until acknowledged, and @p aHandler is called with an error if that never
+     * happens. The agent keeps its own copy of @p aMessage, which can be freed once this method returns.
+     *
      * @retval      OTBR_ERROR_NONE     Successfully sent the message.
      * @retval      OTBR_ERROR_ERRNO    Failed to send the message.
-     *                                  - EMSGSIZE No space for response handler.
+     *                                  - EMSGSIZE The message did not fit in its buffer.
+     *                                  - ENOBUFS No space for response handler or retransmission, which is
+     *                                    limited by both the transactions and the message pool of the agent.
      *
      */
     virtual otbrError Send(Message &       aMessage,
@@ -328,6 +518,102 @@ public:
                            ResponseHandler aHandler,
                            void *          aContext) = 0;
 
+    /**
+     * This method sends a request with a payload in Block1 blocks, read one block at a time.
+     *
+     * The next block is read and sent when the peer answers 2.31 Continue. If the final response comes in Block2
+     * blocks, @p aHandler is called with each block as it arrives and the next block is requested automatically.
+     *
+     * @param[in]   aRequest        A reference to the request, its payload is replaced by the first block.
+     * @param[in]   aBlockSize      The block size, a power of two from 16 to 1024.
+     * @param[in]   aReader         A function pointer to read the payload.
+     * @param[in]   aReaderContext  A pointer to application-specific context for @p aReader.
+     * @param[in]   aIp6            A pointer to the source Ipv6 address of this request.
+     * @param[in]   aPort           Source UDP port of this request.
+     * @param[in]   aHandler        A function poiner to be called when the final response is received.
+     * @param[in]   aContext        A pointer to application-specific context.
+     *
+     * @retval      OTBR_ERROR_NONE     Successfully sent the first block.
+     * @retval      OTBR_ERROR_ERRNO    Failed to send the first block.
+     *                                  - EINVAL The request or block size is invalid.
+     *
+     */
+    virtual otbrError SendBlockwise(Message &       aRequest,
+                                    uint16_t        aBlockSize,
+                                    BlockReader     aReader,
+                                    void *          aReaderContext,
+                                    const uint8_t * aIp6,
+                                    uint16_t        aPort,
+                                    ResponseHandler aHandler,
+                                    void *          aContext) = 0;
+
+    /**
+     * This method notifies all observers of a resource of its current state.
+     *
+     * The GET handler of the resource is called once for each observer to fill the notification. Observers are
+     * registered by GET requests with the Observe option kObserveRegister, and removed by kObserveDeregister, by a
+     * Reset or an unacknowledged notification, or by a notification that is not a success.
+     *
+     * @param[in]   aResource   A reference to the resource.
+     *
+     * @returns The number of notifications sent.
+     *
+     */
+    virtual unsigned int Notify(const Resource &aResource) = 0;
+
+    /**
+     * This method stops observing a resource.
+     *
+     * The transaction of the GET request with the Observe option kObserveRegister is released, so that further
+     * notifications are answered with a Reset, which removes the registration on the server.
+     *
+     * @param[in]   aToken          A pointer to the token of the registration request.
+     * @param[in]   aTokenLength    The token length.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully stopped observing.
+     * @retval  OTBR_ERROR_ERRNO    No such observation, errno is set to ENOENT.
+     *
+     */
+    virtual otbrError CancelObserve(const uint8_t *aToken, uint8_t aTokenLength) = 0;
+
+    /**
+     * This method returns the metrics of all Uri Paths seen by this agent.
+     *
+     * @param[out]  aCount  A reference to where to store the number of entries.
+     *
+     * @returns A pointer to the first entry.
+     *
+     */
+    virtual const Metrics *GetMetrics(size_t &aCount) const = 0;
+
+    /**
+     * This method updates the fd_set and timeout for mainloop.
+     *
+     * The agent has no file descriptors, @p aTimeout is shortened to the next retransmission or response timeout.
+     *
+     * @param[inout]    aReadFdSet      A reference to fd_set for polling read.
+     * @param[inout]    aWriteFdSet     A reference to fd_set for polling read.
+     * @param[inout]    aErrorFdSet     A reference to fd_set for polling error.
+     * @param[inout]    aMaxFd          A reference to the current max fd in @p aReadFdSet and @p aWriteFdSet.
+     * @param[inout]    aTimeout        A reference to the timeout.
+     *
+     */
+    virtual void UpdateFdSet(fd_set & aReadFdSet,
+                             fd_set & aWriteFdSet,
+                             fd_set & aErrorFdSet,
+                             int &    aMaxFd,
+                             timeval &aTimeout) = 0;
+
+    /**
+     * This method performs retransmissions and reports timeouts of the requests due.
+     *
+     * @param[in]   aReadFdSet      A reference to fd_set ready for reading.
+     * @param[in]   aWriteFdSet     A reference to fd_set ready for writing.
+     * @param[in]   aErrorFdSet     A reference to fd_set with error occurred.
+     *
+     */
+    virtual void Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet, const fd_set &aErrorFdSet) = 0;
+
     /**
      * This method creates a CoAP agent.
      *
@@ -349,6 +635,67 @@ public:
     virtual ~Agent(void) {}
 };
 
+/**
+ * This class holds a CoAP message and frees it to its agent when going out of scope.
+ *
+ */
+class MessageHandle
+{
+public:
+    /**
+     * The constructor to hold a message.
+     *
+     * @param[in]   aAgent      A reference to the agent which created @p aMessage.
+     * @param[in]   aMessage    A pointer to the message, can be NULL.
+     *
+     */
+    MessageHandle(Agent &aAgent, Message *aMessage)
+        : mAgent(aAgent)
+        , mMessage(aMessage)
+    {
+    }
+
+    ~MessageHandle(void)
+    {
+        if (mMessage != NULL)
+        {
+            mAgent.FreeMessage(mMessage);
+        }
+    }
+
+    /**
+     * This method returns the held message.
+     *
+     * @returns A pointer to the message, NULL if no message is held.
+     *
+     */
+    Message *Get(void) const { return mMessage; }
+
+    /**
+     * This method gives up the ownership of the held message.
+     *
+     * @returns A pointer to the message, which must be freed by the caller.
+     *
+     */
+    Message *Release(void)
+    {
+        Message *message = mMessage;
+
+        mMessage = NULL;
+        return message;
+    }
+
+    Message *operator->(void) const { return mMessage; }
+    Message &operator*(void) const { return *mMessage; }
+
+private:
+    MessageHandle(const MessageHandle &);
+    MessageHandle &operator=(const MessageHandle &);
+
+    Agent &  mAgent;
+    Message *mMessage;
+};
+
 /**
  * @}
  */
@@ -0,0 +1,1928 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   The file implements the native CoAP service.
+ */
+
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_COAP
+
+#include "coap_native.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "code_utils.hpp"
+#include "logging.hpp"
+#include "time.hpp"
+#include "types.hpp"
+
+namespace ot {
+
+namespace BorderRouter {
+
+namespace Coap {
+
+enum
+{
+    kOptionNibble1Byte   = 13,  ///< Option delta or length nibble followed by 1 extended byte.
+    kOptionNibble2Bytes  = 14,  ///< Option delta or length nibble followed by 2 extended bytes.
+    kOptionNibbleInvalid = 15,  ///< Option delta or length nibble reserved for the payload marker.
+    kOptionExtended1Byte = 13,  ///< Offset of values encoded in 1 extended byte.
+    kOptionExtended2Byte = 269, ///< Offset of values encoded in 2 extended bytes.
+};
+
+/** Returns the size of the extended bytes of an option delta or length */
+static uint16_t GetExtendedSize(uint16_t aValue)
+{
+    return (aValue < kOptionExtended1Byte ? 0 : (aValue < kOptionExtended2Byte ? 1 : 2));
+}
+
+/** Returns the size of an option header */
+static uint16_t GetOptionHeaderSize(uint16_t aDelta, uint16_t aLength)
+{
+    return static_cast<uint16_t>(1 + GetExtendedSize(aDelta) + GetExtendedSize(aLength));
+}
+
+/** Encode the nibble of an option delta or length, and its extended bytes at @p aExtended */
+static uint8_t EncodeOptionNibble(uint16_t aValue, uint8_t *&aExtended)
+{
+    uint8_t nibble;
+
+    if (aValue < kOptionExtended1Byte)
+    {
+        nibble = static_cast<uint8_t>(aValue);
+    }
+    else if (aValue < kOptionExtended2Byte)
+    {
+        nibble       = kOptionNibble1Byte;
+        *aExtended++ = static_cast<uint8_t>(aValue - kOptionExtended1Byte);
+    }
+    else
+    {
+        nibble       = kOptionNibble2Bytes;
+        aValue       = static_cast<uint16_t>(aValue - kOptionExtended2Byte);
+        *aExtended++ = static_cast<uint8_t>(aValue >> 8);
+        *aExtended++ = static_cast<uint8_t>(aValue & 0xff);
+    }
+
+    return nibble;
+}
+
+/** Encode an option header at @p aOut, returns the end of the header */
+static uint8_t *EncodeOptionHeader(uint8_t *aOut, uint16_t aDelta, uint16_t aLength)
+{
+    uint8_t *extended = aOut + 1;
+    uint8_t  delta    = EncodeOptionNibble(aDelta, extended);
+    uint8_t  length   = EncodeOptionNibble(aLength, extended);
+
+    *aOut = static_cast<uint8_t>((delta << 4) | length);
+
+    return extended;
+}
+
+/** Decode the extended bytes of an option delta or length, returns false if malformed */
+static bool DecodeOptionNibble(uint8_t aNibble, const uint8_t *&aCursor, const uint8_t *aEnd, uint32_t &aValue)
+{
+    bool ret = true;
+
+    switch (aNibble)
+    {
+    case kOptionNibble1Byte:
+        VerifyOrExit(aCursor + 1 <= aEnd, ret = false);
+        aValue = kOptionExtended1Byte + aCursor[0];
+        aCursor += 1;
+        break;
+
+    case kOptionNibble2Bytes:
+        VerifyOrExit(aCursor + 2 <= aEnd, ret = false);
+        aValue = kOptionExtended2Byte + ((aCursor[0] << 8) | aCursor[1]);
+        aCursor += 2;
+        break;
+
+    case kOptionNibbleInvalid:
+        ret = false;
+        break;
+
+    default:
+        aValue = aNibble;
+        break;
+    }
+
+exit:
+    return ret;
+}
+
+/** Decode an option header at @p aCursor and move past it, returns false if malformed */
+static bool DecodeOptionHeader(const uint8_t *&aCursor, const uint8_t *aEnd, uint32_t &aDelta, uint32_t &aLength)
+{
+    bool    ret = false;
+    uint8_t header;
+
+    VerifyOrExit(aCursor < aEnd);
+    header = *aCursor++;
+    VerifyOrExit(DecodeOptionNibble(header >> 4, aCursor, aEnd, aDelta));
+    VerifyOrExit(DecodeOptionNibble(header & 0x0f, aCursor, aEnd, aLength));
+    ret = true;
+
+exit:
+    return ret;
+}
+
+MessageNative::MessageNative(uint8_t *aBuffer, uint16_t aSize)
+    : mBuffer(aBuffer)
+    , mSize(aSize)
+    , mLength(0)
+    , mOptionsEnd(0)
+    , mTruncated(false)
+{
+}
+
+void MessageNative::Init(Type aType, Code aCode, uint16_t aMessageId, const uint8_t *aToken, uint8_t aTokenLength)
+{
+    assert(mSize >= kHeaderSize + kMaxTokenLength);
+
+    mBuffer[0]  = kVersion << 6;
+    mLength     = kHeaderSize;
+    mOptionsEnd = kHeaderSize;
+    mTruncated  = false;
+    SetType(aType);
+    SetCode(aCode);
+    SetMessageId(aMessageId);
+    SetToken(aToken, aTokenLength);
+}
+
+otbrError MessageNative::Parse(uint16_t aLength)
+{
+    otbrError      error  = OTBR_ERROR_ERRNO;
+    const uint8_t *end    = mBuffer + aLength;
+    uint32_t       number = 0;
+    const uint8_t *cursor;
+
+    VerifyOrExit(aLength >= kHeaderSize && aLength <= mSize, errno = EBADMSG);
+    VerifyOrExit((mBuffer[0] >> 6) == kVersion, errno = EBADMSG);
+    VerifyOrExit((mBuffer[0] & 0x0f) <= kMaxTokenLength && GetOptionsOffset() <= aLength, errno = EBADMSG);
+
+    // an empty message is only the header
+    VerifyOrExit(GetCode() != kCodeEmpty || aLength == kHeaderSize, errno = EBADMSG);
+
+    cursor = mBuffer + GetOptionsOffset();
+
+    while (cursor < end && *cursor != kPayloadMarker)
+    {
+        uint32_t delta;
+        uint32_t length;
+
+        VerifyOrExit(DecodeOptionHeader(cursor, end, delta, length), errno = EBADMSG);
+        number += delta;
+        VerifyOrExit(number <= 0xffff && length <= static_cast<uint32_t>(end - cursor), errno = EBADMSG);
+        cursor += length;
+    }
+
+    // the payload marker must be followed by a payload
+    VerifyOrExit(cursor == end || cursor + 1 < end, errno = EBADMSG);
+
+    mLength     = aLength;
+    mOptionsEnd = static_cast<uint16_t>(cursor - mBuffer);
+    mTruncated  = false;
+    error       = OTBR_ERROR_NONE;
+
+exit:
+    return error;
+}
+
+void MessageNative::CopyFrom(const MessageNative &aMessage)
+{
+    assert(aMessage.mLength <= mSize);
+
+    memcpy(mBuffer, aMessage.mBuffer, aMessage.mLength);
+    mLength     = aMessage.mLength;
+    mOptionsEnd = aMessage.mOptionsEnd;
+    mTruncated  = aMessage.mTruncated;
+}
+
+void MessageNative::SetMessageId(uint16_t aMessageId)
+{
+    mBuffer[2] = static_cast<uint8_t>(aMessageId >> 8);
+    mBuffer[3] = static_cast<uint8_t>(aMessageId & 0xff);
+}
+
+const uint8_t *MessageNative::GetToken(uint8_t &aLength) const
+{
+    aLength = mBuffer[0] & 0x0f;
+    return mBuffer + kHeaderSize;
+}
+
+void MessageNative::SetToken(const uint8_t *aToken, uint8_t aLength)
+{
+    uint8_t  oldLength = mBuffer[0] & 0x0f;
+    uint16_t tail      = static_cast<uint16_t>(kHeaderSize + oldLength);
+
+    VerifyOrExit(aLength <= kMaxTokenLength && mLength - oldLength + aLength <= mSize, mTruncated = true);
+
+    memmove(mBuffer + kHeaderSize + aLength, mBuffer + tail, mLength - tail);
+    if (aLength > 0)
+    {
+        memcpy(mBuffer + kHeaderSize, aToken, aLength);
+    }
+
+    mBuffer[0]  = static_cast<uint8_t>((mBuffer[0] & 0xf0) | aLength);
+    mLength     = static_cast<uint16_t>(mLength - oldLength + aLength);
+    mOptionsEnd = static_cast<uint16_t>(mOptionsEnd - oldLength + aLength);
+
+exit:
+    return;
+}
+
+otbrError MessageNative::InsertOption(uint16_t aNumber, const uint8_t *aValue, uint16_t aLength)
+{
+    otbrError error      = OTBR_ERROR_ERRNO;
+    uint16_t  offset     = GetOptionsOffset();
+    uint16_t  number     = 0;
+    bool      hasNext    = false;
+    uint16_t  nextNumber = 0;
+    uint16_t  nextLength = 0;
+    uint16_t  nextHeader = 0;
+    int       growth;
+    uint16_t  tail;
+    uint8_t * cursor;
+
+    VerifyOrExit(aLength <= kMaxOptionLength, mTruncated = true, errno = EMSGSIZE);
+
+    // find the first option with a larger number, the new option goes before it
+    while (offset < mOptionsEnd)
+    {
+        const uint8_t *header = mBuffer + offset;
+        uint32_t       delta;
+        uint32_t       length;
+
+        DecodeOptionHeader(header, mBuffer + mOptionsEnd, delta, length);
+
+        if (number + delta > aNumber)
+        {
+            hasNext    = true;
+            nextNumber = static_cast<uint16_t>(number + delta);
+            nextLength = static_cast<uint16_t>(length);
+            nextHeader = static_cast<uint16_t>(header - (mBuffer + offset));
+            break;
+        }
+
+        number = static_cast<uint16_t>(number + delta);
+        offset = static_cast<uint16_t>(header - mBuffer + length);
+    }
+
+    // the delta of the following option shrinks, which may shrink its header
+    growth = GetOptionHeaderSize(aNumber - number, aLength) + aLength;
+    if (hasNext)
+    {
+        growth += GetOptionHeaderSize(nextNumber - aNumber, nextLength) - nextHeader;
+    }
+
+    VerifyOrExit(mLength + growth <= mSize, mTruncated = true, errno = EMSGSIZE);
+
+    tail = static_cast<uint16_t>(offset + nextHeader);
+    memmove(mBuffer + tail + growth, mBuffer + tail, mLength - tail);
+
+    cursor = EncodeOptionHeader(mBuffer + offset, aNumber - number, aLength);
+    if (aLength > 0)
+    {
+        memcpy(cursor, aValue, aLength);
+        cursor += aLength;
+    }
+
+    if (hasNext)
+    {
+        EncodeOptionHeader(cursor, nextNumber - aNumber, nextLength);
+    }
+
+    mLength     = static_cast<uint16_t>(mLength + growth);
+    mOptionsEnd = static_cast<uint16_t>(mOptionsEnd + growth);
+    error       = OTBR_ERROR_NONE;
+
+exit:
+    return error;
+}
+
+void MessageNative::RemoveOption(uint16_t aNumber)
+{
+    uint16_t offset = GetOptionsOffset();
+    uint16_t number = 0;
+
+    while (offset < mOptionsEnd)
+    {
+        const uint8_t *cursor = mBuffer + offset;
+        uint8_t        header[5];
+        uint16_t       headerLength = 0;
+        uint16_t       removeEnd;
+        uint32_t       delta;
+        uint32_t       length;
+
+        DecodeOptionHeader(cursor, mBuffer + mOptionsEnd, delta, length);
+        removeEnd = static_cast<uint16_t>(cursor - mBuffer + length);
+
+        if (number + delta != aNumber)
+        {
+            number = static_cast<uint16_t>(number + delta);
+            offset = removeEnd;
+            continue;
+        }
+
+        // the delta of the removed option moves to the following option
+        if (removeEnd < mOptionsEnd)
+        {
+            const uint8_t *next = mBuffer + removeEnd;
+            uint32_t       nextDelta;
+            uint32_t       nextLength;
+
+            DecodeOptionHeader(next, mBuffer + mOptionsEnd, nextDelta, nextLength);
+            headerLength = static_cast<uint16_t>(EncodeOptionHeader(header, static_cast<uint16_t>(delta + nextDelta),
+                                                                    static_cast<uint16_t>(nextLength)) -
+                                                 header);
+            removeEnd = static_cast<uint16_t>(next - mBuffer);
+        }
+
+        memmove(mBuffer + offset + headerLength, mBuffer + removeEnd, mLength - removeEnd);
+        memcpy(mBuffer + offset, header, headerLength);
+        mLength     = static_cast<uint16_t>(mLength - (removeEnd - offset - headerLength));
+        mOptionsEnd = static_cast<uint16_t>(mOptionsEnd - (removeEnd - offset - headerLength));
+    }
+}
+
+otbrError MessageNative::GetUintOption(uint16_t aNumber, uint32_t &aValue) const
+{
+    otbrError ret = OTBR_ERROR_ERRNO;
+
+    for (OptionIterator option(*this); !option.IsDone(); option.Next())
+    {
+        if (option.GetNumber() != aNumber)
+        {
+            continue;
+        }
+
+        VerifyOrExit(option.GetLength() <= sizeof(aValue), errno = EBADMSG);
+
+        aValue = 0;
+
+        for (uint16_t i = 0; i < option.GetLength(); i++)
+        {
+            aValue = (aValue << 8) | option.GetValue()[i];
+        }
+
+        ExitNow(ret = OTBR_ERROR_NONE);
+    }
+
+    errno = ENOENT;
+
+exit:
+    return ret;
+}
+
+otbrError MessageNative::SetUintOption(uint16_t aNumber, uint32_t aValue)
+{
+    uint8_t  encoded[sizeof(aValue)];
+    uint16_t length = 0;
+
+    // unsigned option values are encoded in as few bytes as possible
+    for (uint32_t rest = aValue; rest != 0; rest >>= 8)
+    {
+        length++;
+    }
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        encoded[i] = static_cast<uint8_t>(aValue >> (8 * (length - i - 1)));
+    }
+
+    RemoveOption(aNumber);
+
+    return InsertOption(aNumber, encoded, length);
+}
+
+otbrError MessageNative::GetBlock(OptionNumber aOption, Block &aBlock) const
+{
+    otbrError ret = OTBR_ERROR_ERRNO;
+    uint32_t  value;
+
+    SuccessOrExit(ret = GetUintOption(aOption, value));
+
+    // at most 3 bytes and SZX 7 is reserved
+    VerifyOrExit(value <= 0xffffff && (value & 0x07) != 0x07, ret = OTBR_ERROR_ERRNO, errno = EBADMSG);
+
+    aBlock.mNumber = value >> 4;
+    aBlock.mMore   = (value & 0x08) != 0;
+    aBlock.mSize   = static_cast<uint16_t>(kMinBlockSize << (value & 0x07));
+
+exit:
+    return ret;
+}
+
+otbrError MessageNative::SetBlock(OptionNumber aOption, const Block &aBlock)
+{
+    otbrError ret = OTBR_ERROR_ERRNO;
+    uint8_t   szx = 0;
+
+    while ((kMinBlockSize << szx) < aBlock.mSize && szx < 6)
+    {
+        szx++;
+    }
+
+    VerifyOrExit((kMinBlockSize << szx) == aBlock.mSize && aBlock.mNumber < (1u << 20), errno = EINVAL);
+
+    ret = SetUintOption(aOption, (aBlock.mNumber << 4) | (aBlock.mMore ? 0x08 : 0) | szx);
+
+exit:
+    return ret;
+}
+
+otbrError MessageNative::GetObserve(uint32_t &aObserve) const
+{
+    otbrError ret;
+
+    SuccessOrExit(ret = GetUintOption(kOptionObserve, aObserve));
+    VerifyOrExit(aObserve <= 0xffffff, ret = OTBR_ERROR_ERRNO, errno = EBADMSG);
+
+exit:
+    return ret;
+}
+
+otbrError MessageNative::SetObserve(uint32_t aObserve)
+{
+    return SetUintOption(kOptionObserve, aObserve & 0xffffff);
+}
+
+void MessageNative::SetPath(const char *aPath)
+{
+    const char *segment = aPath;
+
+    while (*segment != 0)
+    {
+        const char *end = strchr(segment, '/');
+
+        if (end == NULL)
+        {
+            end = segment + strlen(segment);
+        }
+
+        if (end > segment)
+        {
+            SuccessOrExit(InsertOption(kOptionUriPath, reinterpret_cast<const uint8_t *>(segment),
+                                       static_cast<uint16_t>(end - segment)));
+        }
+
+        segment = (*end == '/' ? end + 1 : end);
+    }
+
+exit:
+    return;
+}
+
+void MessageNative::GetPath(char *aPath, size_t aSize) const
+{
+    size_t length = 0;
+
+    for (OptionIterator option(*this); !option.IsDone() && option.GetNumber() <= kOptionUriPath; option.Next())
+    {
+        size_t segmentLength;
+
+        if (option.GetNumber() != kOptionUriPath)
+        {
+            continue;
+        }
+
+        if (length > 0 && length + 1 < aSize)
+        {
+            aPath[length++] = '/';
+        }
+
+        segmentLength = std::min<size_t>(option.GetLength(), aSize - 1 - length);
+        memcpy(aPath + length, option.GetValue(), segmentLength);
+        length += segmentLength;
+    }
+
+    aPath[length] = '\0';
+}
+
+const uint8_t *MessageNative::GetPayload(uint16_t &aLength) const
+{
+    const uint8_t *payload = NULL;
+
+    aLength = 0;
+
+    if (mOptionsEnd < mLength)
+    {
+        payload = mBuffer + mOptionsEnd + 1;
+        aLength = static_cast<uint16_t>(mLength - mOptionsEnd - 1);
+    }
+
+    return payload;
+}
+
+void MessageNative::SetPayload(const uint8_t *aPayload, uint16_t aLength)
+{
+    uint32_t length = mOptionsEnd + (aLength > 0 ? 1 + aLength : 0);
+
+    VerifyOrExit(length <= mSize, mTruncated = true);
+
+    if (aLength > 0)
+    {
+        mBuffer[mOptionsEnd] = kPayloadMarker;
+        memmove(mBuffer + mOptionsEnd + 1, aPayload, aLength);
+    }
+
+    mLength = static_cast<uint16_t>(length);
+
+exit:
+    return;
+}
+
+OptionIterator::OptionIterator(const MessageNative &aMessage)
+    : mCursor(aMessage.mBuffer + aMessage.GetOptionsOffset())
+    , mEnd(aMessage.mBuffer + aMessage.mOptionsEnd)
+    , mValue(NULL)
+    , mNumber(0)
+    , mLength(0)
+{
+    Read();
+}
+
+void OptionIterator::Read(void)
+{
+    const uint8_t *cursor = mCursor;
+    uint32_t       delta;
+    uint32_t       length;
+
+    VerifyOrExit(!IsDone());
+
+    // options were validated when the message was parsed or built
+    DecodeOptionHeader(cursor, mEnd, delta, length);
+    mNumber = static_cast<uint16_t>(mNumber + delta);
+    mValue  = cursor;
+    mLength = static_cast<uint16_t>(length);
+
+exit:
+    return;
+}
+
+void OptionIterator::Next(void)
+{
+    VerifyOrExit(!IsDone());
+
+    mCursor = mValue + mLength;
+    Read();
+
+exit:
+    return;
+}
+
+static const uint32_t kFnvOffsetBasis = 2166136261u; ///< FNV-1a offset basis.
+static const uint32_t kFnvPrime       = 16777619u;   ///< FNV-1a prime.
+
+/** Hash one more segment of an Uri Path into @p aHash */
+static uint32_t HashPathSegment(uint32_t aHash, const char *aSegment, size_t aLength)
+{
+    aHash = (aHash ^ static_cast<uint8_t>('/')) * kFnvPrime;
+
+    for (size_t i = 0; i < aLength; i++)
+    {
+        aHash = (aHash ^ static_cast<uint8_t>(aSegment[i])) * kFnvPrime;
+    }
+
+    return aHash;
+}
+
+/** Returns the next non-empty segment of @p aCursor before @p aEnd, or NULL if no more segment */
+static const char *NextPathSegment(const char *&aCursor, const char *aEnd, size_t &aLength)
+{
+    const char *segment;
+
+    while (aCursor < aEnd && *aCursor == '/')
+    {
+        aCursor++;
+    }
+
+    VerifyOrExit(aCursor < aEnd, segment = NULL);
+
+    segment = aCursor;
+
+    while (aCursor < aEnd && *aCursor != '/')
+    {
+        aCursor++;
+    }
+
+    aLength = static_cast<size_t>(aCursor - segment);
+
+exit:
+    return segment;
+}
+
+uint32_t ResourceRouter::HashPath(const char *aPath, size_t &aPathLength, bool &aIsPrefix)
+{
+    uint32_t    hash   = kFnvOffsetBasis;
+    const char *cursor = aPath;
+    const char *end    = aPath + strlen(aPath);
+    const char *segment;
+    size_t      length;
+
+    aPathLength = static_cast<size_t>(end - aPath);
+    aIsPrefix   = false;
+
+    while ((segment = NextPathSegment(cursor, end, length)) != NULL)
+    {
+        if (length == 1 && *segment == '*' && cursor == end)
+        {
+            aPathLength = static_cast<size_t>(segment - aPath);
+            aIsPrefix   = true;
+            break;
+        }
+
+        hash = HashPathSegment(hash, segment, length);
+    }
+
+    return hash;
+}
+
+bool ResourceRouter::MatchPath(const Route &aRoute, const MessageNative &aRequest, bool aIsPrefix)
+{
+    const char *cursor = aRoute.mResource->mPath;
+    const char *end    = cursor + aRoute.mPathLength;
+    bool        ret    = false;
+    const char *segment;
+    size_t      length;
+
+    for (OptionIterator option(aRequest); !option.IsDone() && option.GetNumber() <= kOptionUriPath; option.Next())
+    {
+        if (option.GetNumber() != kOptionUriPath)
+        {
+            continue;
+        }
+
+        segment = NextPathSegment(cursor, end, length);
+        VerifyOrExit(segment != NULL, ret = aIsPrefix);
+        VerifyOrExit(length == option.GetLength() && memcmp(segment, option.GetValue(), length) == 0);
+    }
+
+    ret = (NextPathSegment(cursor, end, length) == NULL);
+
+exit:
+    return ret;
+}
+
+/** Returns whether two paths have the same segments */
+static bool SamePath(const char *aPath1, size_t aLength1, const char *aPath2, size_t aLength2)
+{
+    const char *end1 = aPath1 + aLength1;
+    const char *end2 = aPath2 + aLength2;
+    const char *segment1;
+    const char *segment2;
+    size_t      length1;
+    size_t      length2;
+    bool        ret = false;
+
+    do
+    {
+        segment1 = NextPathSegment(aPath1, end1, length1);
+        segment2 = NextPathSegment(aPath2, end2, length2);
+        VerifyOrExit((segment1 == NULL) == (segment2 == NULL));
+        VerifyOrExit(segment1 == NULL || (length1 == length2 && memcmp(segment1, segment2, length1) == 0));
+    } while (segment1 != NULL);
+
+    ret = true;
+
+exit:
+    return ret;
+}
+
+const Resource *ResourceRouter::Lookup(const Routes &       aRoutes,
+                                       uint32_t             aHash,
+                                       const MessageNative &aRequest,
+                                       bool                 aIsPrefix)
+{
+    const Resource *                                          resource = NULL;
+    std::pair<Routes::const_iterator, Routes::const_iterator> range    = aRoutes.equal_range(aHash);
+
+    // only hash collisions need more than one comparison
+    for (Routes::const_iterator it = range.first; it != range.second; ++it)
+    {
+        if (MatchPath(it->second, aRequest, aIsPrefix))
+        {
+            resource = it->second.mResource;
+            break;
+        }
+    }
+
+    return resource;
+}
+
+otbrError ResourceRouter::Add(const Resource &aResource)
+{
+    otbrError ret = OTBR_ERROR_ERRNO;
+    Route     route;
+    bool      isPrefix;
+    uint32_t  hash   = HashPath(aResource.mPath, route.mPathLength, isPrefix);
+    Routes &  routes = (isPrefix ? mPrefixRoutes : mExactRoutes);
+
+    std::pair<Routes::iterator, Routes::iterator> range = routes.equal_range(hash);
+
+    for (Routes::iterator it = range.first; it != range.second; ++it)
+    {
+        VerifyOrExit(!SamePath(it->second.mResource->mPath, it->second.mPathLength, aResource.mPath, route.mPathLength),
+                     errno = EEXIST);
+    }
+
+    route.mResource = &aResource;
+    routes.insert(Routes::value_type(hash, route));
+    ret = OTBR_ERROR_NONE;
+
+exit:
+    return ret;
+}
+
+otbrError ResourceRouter::Remove(const Resource &aResource)
+{
+    otbrError ret = OTBR_ERROR_ERRNO;
+    size_t    pathLength;
+    bool      isPrefix;
+    uint32_t  hash   = HashPath(aResource.mPath, pathLength, isPrefix);
+    Routes &  routes = (isPrefix ? mPrefixRoutes : mExactRoutes);
+
+    std::pair<Routes::iterator, Routes::iterator> range = routes.equal_range(hash);
+
+    for (Routes::iterator it = range.first; it != range.second; ++it)
+    {
+        if (it->second.mResource == &aResource)
+        {
+            routes.erase(it);
+            ExitNow(ret = OTBR_ERROR_NONE);
+        }
+    }
+
+    errno = ENOENT;
+
+exit:
+    return ret;
+}
+
+uint32_t ResourceRouter::HashRequestPath(const MessageNative &aMessage)
+{
+    uint32_t hash = kFnvOffsetBasis;
+
+    for (OptionIterator option(aMessage); !option.IsDone() && option.GetNumber() <= kOptionUriPath; option.Next())
+    {
+        if (option.GetNumber() == kOptionUriPath)
+        {
+            hash = HashPathSegment(hash, reinterpret_cast<const char *>(option.GetValue()), option.GetLength());
+        }
+    }
+
+    return hash;
+}
+
+const Resource *ResourceRouter::Find(const MessageNative &aRequest, uint32_t &aPathHash) const
+{
+    const Resource *resource        = NULL;
+    uint32_t        hash            = kFnvOffsetBasis;
+    bool            hasPrefixRoutes = !mPrefixRoutes.empty();
+
+    if (hasPrefixRoutes)
+    {
+        resource = Lookup(mPrefixRoutes, hash, aRequest, true);
+    }
+
+    for (OptionIterator option(aRequest); !option.IsDone() && option.GetNumber() <= kOptionUriPath; option.Next())
+    {
+        if (option.GetNumber() != kOptionUriPath)
+        {
+            continue;
+        }
+
+        hash = HashPathSegment(hash, reinterpret_cast<const char *>(option.GetValue()), option.GetLength());
+
+        // the longest matching prefix wins
+        if (hasPrefixRoutes)
+        {
+            const Resource *prefix = Lookup(mPrefixRoutes, hash, aRequest, true);
+
+            resource = (prefix != NULL ? prefix : resource);
+        }
+    }
+
+    {
+        const Resource *exact = Lookup(mExactRoutes, hash, aRequest, false);
+
+        resource = (exact != NULL ? exact : resource);
+    }
+
+    aPathHash = hash;
+
+    return resource;
+}
+
+MessagePool::MessagePool(void)
+    : mFreeCount(kSize)
+{
+    for (size_t i = 0; i < kSize; i++)
+    {
+        mFree[i] = &mMessages[i];
+    }
+
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+MessageBuffer *MessagePool::New(void)
+{
+    MessageBuffer *message = NULL;
+
+    VerifyOrExit(mFreeCount > 0, mStats.mAllocationFails++, errno = ENOBUFS);
+
+    message = mFree[--mFreeCount];
+    mStats.mAllocations++;
+    mStats.mInUse++;
+    mStats.mMaxInUse = std::max(mStats.mMaxInUse, mStats.mInUse);
+
+exit:
+    return message;
+}
+
+void MessagePool::Free(MessageBuffer *aMessage)
+{
+    assert(aMessage >= mMessages && aMessage < mMessages + kSize && mFreeCount < kSize);
+
+    mFree[mFreeCount++] = aMessage;
+    mStats.mInUse--;
+}
+
+AgentNative::AgentNative(NetworkSender aNetworkSender, void *aContext)
+    : mNetworkSender(aNetworkSender)
+    , mContext(aContext)
+    // message ids only need to differ from those of recent exchanges
+    , mMessageId(static_cast<uint16_t>(rand()))
+    , mObserveSequence(0)
+    , mObserverGeneration(0)
+    , mMetricsCount(0)
+{
+    memset(mTransactions, 0, sizeof(mTransactions));
+    memset(mObservers, 0, sizeof(mObservers));
+
+    for (size_t i = 0; i < kMaxRecentRequests; i++)
+    {
+        mRecentRequests[i].mValid = false;
+    }
+
+    memset(mMetrics, 0, sizeof(mMetrics));
+}
+
+Message *AgentNative::NewMessage(Type aType, Code aCode, const uint8_t *aToken, uint8_t aTokenLength)
+{
+    MessageBuffer *message = mMessagePool.New();
+
+    VerifyOrExit(message != NULL, otbrLogRateLimited(OTBR_LOG_WARNING, "CoAP message pool exhausted!"));
+    message->Init(aType, aCode, mMessageId++, aToken, aTokenLength);
+
+exit:
+    return message;
+}
+
+void AgentNative::FreeMessage(Message *aMessage)
+{
+    mMessagePool.Free(static_cast<MessageBuffer *>(aMessage));
+}
+
+otbrError AgentNative::Transmit(const MessageNative &aMessage, const uint8_t *aIp6, uint16_t aPort)
+{
+    otbrError error = OTBR_ERROR_ERRNO;
+
+    VerifyOrExit(!aMessage.IsTruncated(), errno = EMSGSIZE);
+    VerifyOrExit(mNetworkSender(aMessage.GetBuffer(), aMessage.GetLength(), aIp6, aPort, mContext) >= 0);
+    error = OTBR_ERROR_NONE;
+
+exit:
+    return error;
+}
+
+void AgentNative::SendEmpty(Type aType, uint16_t aMessageId, const uint8_t *aIp6, uint16_t aPort)
+{
+    uint8_t       buffer[MessageNative::kHeaderSize + MessageNative::kMaxTokenLength];
+    MessageNative message(buffer, sizeof(buffer));
+
+    message.Init(aType, kCodeEmpty, aMessageId, NULL, 0);
+
+    if (Transmit(message, aIp6, aPort) != OTBR_ERROR_NONE)
+    {
+        otbrLog(OTBR_LOG_WARNING, "CoAP failed to send empty message: %s", otbrErrorString(OTBR_ERROR_ERRNO));
+    }
+}
+
+otbrError AgentNative::Send(Message &       aMessage,
+                            const uint8_t * aIp6,
+                            uint16_t        aPort,
+                            ResponseHandler aHandler,
+                            void *          aContext)
+{
+    Transaction *transaction;
+
+    return SendMessage(static_cast<MessageNative &>(aMessage), aIp6, aPort, aHandler, aContext, transaction);
+}
+
+otbrError AgentNative::SendBlockwise(Message &       aRequest,
+                                     uint16_t        aBlockSize,
+                                     BlockReader     aReader,
+                                     void *          aReaderContext,
+                                     const uint8_t * aIp6,
+                                     uint16_t        aPort,
+                                     ResponseHandler aHandler,
+                                     void *          aContext)
+{
+    otbrError      error       = OTBR_ERROR_ERRNO;
+    MessageNative &request     = static_cast<MessageNative &>(aRequest);
+    Transaction *  transaction = NULL;
+    uint8_t        payload[MessageNative::kMaxBlockSize];
+    ssize_t        length;
+    Block          block;
+
+    // continuing needs the response to be matched
+    VerifyOrExit(request.IsRequest() && (aHandler != NULL || request.GetType() == kTypeConfirmable), errno = EINVAL);
+    VerifyOrExit(aBlockSize <= sizeof(payload), errno = EINVAL);
+    VerifyOrExit((length = aReader(0, payload, aBlockSize, aReaderContext)) >= 0);
+
+    block.mNumber = 0;
+    block.mMore   = (length == aBlockSize);
+    block.mSize   = aBlockSize;
+    SuccessOrExit(error = request.SetBlock(kOptionBlock1, block));
+    request.SetPayload(payload, static_cast<uint16_t>(length));
+
+    SuccessOrExit(error = SendMessage(request, aIp6, aPort, aHandler, aContext, transaction));
+    transaction->mBlockReader  = aReader;
+    transaction->mBlockContext = aReaderContext;
+    transaction->mBlockOffset  = static_cast<uint32_t>(length);
+    transaction->mBlockSize    = aBlockSize;
+    transaction->mBlockMore    = block.mMore;
+
+exit:
+    return error;
+}
+
+otbrError AgentNative::SendMessage(MessageNative & aMessage,
+                                   const uint8_t * aIp6,
+                                   uint16_t        aPort,
+                                   ResponseHandler aHandler,
+                                   void *          aContext,
+                                   Transaction *&  aTransaction)
+{
+    otbrError    error       = OTBR_ERROR_ERRNO;
+    Transaction *transaction = NULL;
+
+    VerifyOrExit(!aMessage.IsTruncated(), errno = EMSGSIZE);
+
+    if (aMessage.GetType() == kTypeConfirmable || (aHandler != NULL && aMessage.IsRequest()))
+    {
+        const uint8_t *token;
+
+        for (size_t i = 0; i < kMaxTransactions; i++)
+        {
+            if (!mTransactions[i].mValid)
+            {
+                transaction = &mTransactions[i];
+                break;
+            }
+        }
+
+        VerifyOrExit(transaction != NULL, errno = ENOBUFS);
+        memset(transaction, 0, sizeof(*transaction));
+
+        // keep a copy to retransmit and continue block-wise transfers, the caller frees the message once sent
+        VerifyOrExit((transaction->mMessage = mMessagePool.New()) != NULL);
+        transaction->mMessage->CopyFrom(aMessage);
+
+        if (aIp6 != NULL)
+        {
+            transaction->mHasIp6 = true;
+            memcpy(transaction->mIp6, aIp6, sizeof(transaction->mIp6));
+        }
+
+        token                   = aMessage.GetToken(transaction->mTokenLength);
+        transaction->mValid     = true;
+        transaction->mMessageId = aMessage.GetMessageId();
+        transaction->mHandler   = aHandler;
+        transaction->mContext   = aContext;
+        transaction->mPort      = aPort;
+        memcpy(transaction->mToken, token, transaction->mTokenLength);
+        ArmTransaction(*transaction);
+    }
+
+    error = Transmit(aMessage, aIp6, aPort);
+
+    // A busy link is what retransmission is for, the armed transaction sends the message when it is due.
+    if (error == OTBR_ERROR_ERRNO && errno == EAGAIN && aMessage.GetType() == kTypeConfirmable)
+    {
+        otbrLogRateLimited(OTBR_LOG_WARNING, "CoAP message %u deferred, link busy", aMessage.GetMessageId());
+        error = OTBR_ERROR_NONE;
+    }
+
+    if (error == OTBR_ERROR_NONE && aMessage.IsRequest())
+    {
+        Metrics *metrics = FindMetrics(aMessage, ResourceRouter::HashRequestPath(aMessage));
+
+        metrics->mRequestsSent++;
+
+        if (transaction != NULL)
+        {
+            transaction->mMetrics   = metrics;
+            transaction->mStartTime = GetNow();
+        }
+    }
+
+exit:
+    if (error != OTBR_ERROR_NONE)
+    {
+        if (transaction != NULL)
+        {
+            if (transaction->mMessage != NULL)
+            {
+                mMessagePool.Free(transaction->mMessage);
+            }
+
+            transaction->mValid = false;
+            transaction         = NULL;
+        }
+
+        otbrLog(OTBR_LOG_ERR, "CoAP failed to send message: %s", otbrErrorString(error));
+    }
+
+    aTransaction = transaction;
+
+    return error;
+}
+
+void AgentNative::ArmTransaction(Transaction &aTransaction)
+{
+    aTransaction.mAcknowledged    = false;
+    aTransaction.mRetransmitCount = 0;
+
+    if (aTransaction.mMessage->GetType() == kTypeConfirmable)
+    {
+        aTransaction.mRetransmitTimeout = kAckTimeout + static_cast<unsigned long>(rand()) % (kAckRandomRange + 1);
+        aTransaction.mTimeout           = GetNow() + aTransaction.mRetransmitTimeout;
+    }
+    else
+    {
+        aTransaction.mTimeout = GetNow() + kMaxTransmitWait;
+    }
+}
+
+void AgentNative::ContinueTransaction(Transaction &aTransaction)
+{
+    aTransaction.mMessageId = mMessageId++;
+    aTransaction.mMessage->SetMessageId(aTransaction.mMessageId);
+    ArmTransaction(aTransaction);
+
+    if (Transmit(*aTransaction.mMessage, aTransaction.mHasIp6 ? aTransaction.mIp6 : NULL, aTransaction.mPort) !=
+        OTBR_ERROR_NONE)
+    {
+        FinishTransaction(aTransaction, NULL, errno);
+    }
+}
+
+void AgentNative::SendNextBlock1(Transaction &aTransaction, const MessageNative &aResponse)
+{
+    MessageBuffer &request = *aTransaction.mMessage;
+    uint8_t        payload[MessageNative::kMaxBlockSize];
+    ssize_t        length;
+    Block          block;
+
+    // the server may ask for smaller blocks
+    if (aResponse.GetBlock(kOptionBlock1, block) == OTBR_ERROR_NONE && block.mSize < aTransaction.mBlockSize)
+    {
+        aTransaction.mBlockSize = block.mSize;
+    }
+
+    length = aTransaction.mBlockReader(aTransaction.mBlockOffset, payload, aTransaction.mBlockSize,
+                                       aTransaction.mBlockContext);
+    VerifyOrExit(length >= 0, FinishTransaction(aTransaction, NULL, errno));
+
+    block.mNumber = aTransaction.mBlockOffset / aTransaction.mBlockSize;
+    block.mMore   = (length == aTransaction.mBlockSize);
+    block.mSize   = aTransaction.mBlockSize;
+    VerifyOrExit(request.SetBlock(kOptionBlock1, block) == OTBR_ERROR_NONE,
+                 FinishTransaction(aTransaction, NULL, errno));
+    request.SetPayload(payload, static_cast<uint16_t>(length));
+
+    aTransaction.mBlockOffset += static_cast<uint32_t>(length);
+    aTransaction.mBlockMore = block.mMore;
+    ContinueTransaction(aTransaction);
+
+exit:
+    return;
+}
+
+void AgentNative::RequestNextBlock2(Transaction &aTransaction, const Block &aBlock)
+{
+    MessageBuffer &request = *aTransaction.mMessage;
+    Block          block;
+
+    block.mNumber = aBlock.mNumber + 1;
+    block.mMore   = false;
+    block.mSize   = aBlock.mSize;
+
+    // the request payload, if any, has been fully sent
+    request.RemoveOption(kOptionBlock1);
+    request.SetPayload(NULL, 0);
+    aTransaction.mBlockReader = NULL;
+
+    VerifyOrExit(request.SetBlock(kOptionBlock2, block) == OTBR_ERROR_NONE,
+                 FinishTransaction(aTransaction, NULL, errno));
+    ContinueTransaction(aTransaction);
+
+exit:
+    return;
+}
+
+void AgentNative::FinishTransaction(Transaction &aTransaction, const MessageNative *aResponse, int aErrno)
+{
+    ResponseHandler handler = aTransaction.mHandler;
+    void *          context = aTransaction.mContext;
+
+    RecordResult(aTransaction, aResponse, aErrno);
+
+    // a notification not acknowledged removes its observer, unless the slot has been registered again since
+    if (aTransaction.mObserver != NULL && aResponse == NULL && aTransaction.mObserver->mValid &&
+        aTransaction.mObserver->mGeneration == aTransaction.mObserverGeneration)
+    {
+        otbrLog(OTBR_LOG_INFO, "CoAP observer removed: %s", strerror(aErrno));
+        aTransaction.mObserver->mValid = false;
+    }
+
+    if (aTransaction.mMessage != NULL)
+    {
+        mMessagePool.Free(aTransaction.mMessage);
+        aTransaction.mMessage = NULL;
+    }
+
+    // release the transaction first, the handler may send another request
+    aTransaction.mValid = false;
+
+    if (handler != NULL)
+    {
+        errno = aErrno;
+        handler(aResponse, aResponse != NULL ? OTBR_ERROR_NONE : OTBR_ERROR_ERRNO, context);
+    }
+}
+
+bool AgentNative::GetNextTimeout(unsigned long &aTimeout) const
+{
+    bool found = false;
+
+    for (size_t i = 0; i < kMaxTransactions; i++)
+    {
+        const Transaction &transaction = mTransactions[i];
+
+        if (transaction.mValid && !transaction.mObserving &&
+            (!found || static_cast<long>(transaction.mTimeout - aTimeout) < 0))
+        {
+            aTimeout = transaction.mTimeout;
+            found    = true;
+        }
+    }
+
+    return found;
+}
+
+void AgentNative::HandleTimers(unsigned long aNow)
+{
+    for (size_t i = 0; i < kMaxTransactions; i++)
+    {
+        Transaction &transaction = mTransactions[i];
+
+        // observations last until canceled
+        if (!transaction.mValid || transaction.mObserving || static_cast<long>(transaction.mTimeout - aNow) > 0)
+        {
+            continue;
+        }
+
+        if (!transaction.mAcknowledged && transaction.mMessage->GetType() == kTypeConfirmable &&
+            transaction.mRetransmitCount < kMaxRetransmit)
+        {
+            transaction.mRetransmitCount++;
+            transaction.mRetransmitTimeout *= 2;
+
+            if (transaction.mMetrics != NULL)
+            {
+                transaction.mMetrics->mRetransmissions++;
+            }
+            transaction.mTimeout = aNow + transaction.mRetransmitTimeout;
+
+            otbrLog(OTBR_LOG_INFO, "CoAP retransmit message %u, attempt %u", transaction.mMessageId,
+                    transaction.mRetransmitCount);
+
+            if (Transmit(*transaction.mMessage, transaction.mHasIp6 ? transaction.mIp6 : NULL, transaction.mPort) !=
+                OTBR_ERROR_NONE)
+            {
+                otbrLog(OTBR_LOG_WARNING, "CoAP failed to retransmit: %s", otbrErrorString(OTBR_ERROR_ERRNO));
+            }
+        }
+        else
+        {
+            otbrLog(OTBR_LOG_WARNING, "CoAP message %u timed out!", transaction.mMessageId);
+            FinishTransaction(transaction, NULL, ETIMEDOUT);
+        }
+    }
+}
+
+void AgentNative::UpdateFdSet(fd_set & aReadFdSet,
+                              fd_set & aWriteFdSet,
+                              fd_set & aErrorFdSet,
+                              int &    aMaxFd,
+                              timeval &aTimeout)
+{
+    unsigned long timeout;
+
+    if (GetNextTimeout(timeout))
+    {
+        long    remaining = static_cast<long>(timeout - GetNow());
+        timeval next;
+
+        remaining    = (remaining > 0 ? remaining : 0);
+        next.tv_sec  = static_cast<time_t>(remaining / 1000);
+        next.tv_usec = static_cast<suseconds_t>((remaining % 1000) * 1000);
+
+        if (timercmp(&next, &aTimeout, <))
+        {
+            aTimeout = next;
+        }
+    }
+
+    (void)aReadFdSet;
+    (void)aWriteFdSet;
+    (void)aErrorFdSet;
+    (void)aMaxFd;
+}
+
+void AgentNative::Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet, const fd_set &aErrorFdSet)
+{
+    HandleTimers(GetNow());
+
+    (void)aReadFdSet;
+    (void)aWriteFdSet;
+    (void)aErrorFdSet;
+}
+
+void AgentNative::HandleRequest(const MessageNative &aRequest, const uint8_t *aIp6, uint16_t aPort)
+{
+    uint8_t         buffer[MessageNative::kMaxMessageSize];
+    MessageNative   response(buffer, sizeof(buffer));
+    uint32_t        pathHash;
+    const Resource *resource = mRouter.Find(aRequest, pathHash);
+    RequestHandler  handler  = (resource != NULL ? resource->GetHandler(aRequest.GetCode()) : NULL);
+    uint8_t         tokenLength;
+    const uint8_t * token = aRequest.GetToken(tokenLength);
+    Block           block;
+    Block           echo;
+    uint32_t        observe;
+    RecentRequest * recent = FindRecentRequest(aRequest, aIp6, aPort);
+
+    // a duplicate gets the same response without handling it again
+    if (recent != NULL)
+    {
+        otbrLog(OTBR_LOG_DEBUG, "CoAP duplicate request %u", aRequest.GetMessageId());
+        FindMetrics(aRequest, pathHash)->mDuplicatesReceived++;
+
+        if (recent->mHasResponse)
+        {
+            if (Transmit(recent->mResponse, aIp6, aPort) != OTBR_ERROR_NONE)
+            {
+                otbrLog(OTBR_LOG_WARNING, "CoAP failed to send response: %s", otbrErrorString(OTBR_ERROR_ERRNO));
+            }
+        }
+        else if (aRequest.GetType() == kTypeConfirmable)
+        {
+            SendEmpty(kTypeAcknowledgment, aRequest.GetMessageId(), aIp6, aPort);
+        }
+
+        ExitNow();
+    }
+
+    // piggyback the response on the ACK of a confirmable request
+    if (aRequest.GetType() == kTypeConfirmable)
+    {
+        response.Init(kTypeAcknowledgment, kCodeEmpty, aRequest.GetMessageId(), token, tokenLength);
+    }
+    else
+    {
+        response.Init(kTypeNonConfirmable, kCodeEmpty, mMessageId++, token, tokenLength);
+    }
+
+    if (resource == NULL)
+    {
+        otbrLog(OTBR_LOG_WARNING, "CoAP received unexpected request!");
+        response.SetCode(kCodeNotFound);
+    }
+    else if (handler == NULL)
+    {
+        response.SetCode(kCodeMethodNotAllowed);
+    }
+    else
+    {
+        // Code stays kCodeEmpty to use separate response if no response set by handler.
+        // Handler should later respond an Non-ACK response.
+        handler(*resource, aRequest, response, aIp6, aPort, resource->mContext);
+    }
+
+    if (resource != NULL && aRequest.GetCode() == kCodeGet && aRequest.GetObserve(observe) == OTBR_ERROR_NONE)
+    {
+        UpdateObserver(*resource, aRequest, observe, response, aIp6, aPort);
+    }
+
+    // a response to a block-wise request echoes its Block1 option unless the handler sets it
+    if (response.GetCode() != kCodeEmpty && aRequest.GetBlock(kOptionBlock1, block) == OTBR_ERROR_NONE &&
+        response.GetBlock(kOptionBlock1, echo) != OTBR_ERROR_NONE)
+    {
+        response.SetBlock(kOptionBlock1, block);
+    }
+
+    AddRecentRequest(aRequest, response, aIp6, aPort);
+
+    {
+        Metrics *metrics = FindMetrics(aRequest, pathHash);
+
+        metrics->mRequestsReceived++;
+
+        if (response.GetCode() != kCodeEmpty)
+        {
+            metrics->mResponsesSent[response.GetCode() >> 5]++;
+        }
+    }
+
+    if (response.GetCode() != kCodeEmpty)
+    {
+        if (Transmit(response, aIp6, aPort) != OTBR_ERROR_NONE)
+        {
+            otbrLog(OTBR_LOG_WARNING, "CoAP failed to send response: %s", otbrErrorString(OTBR_ERROR_ERRNO));
+        }
+    }
+    else if (aRequest.GetType() == kTypeConfirmable)
+    {
+        SendEmpty(kTypeAcknowledgment, aRequest.GetMessageId(), aIp6, aPort);
+    }
+
+exit:
+    return;
+}
+
+AgentNative::RecentRequest *AgentNative::FindRecentRequest(const MessageNative &aRequest,
+                                                           const uint8_t *      aIp6,
+                                                           uint16_t             aPort)
+{
+    RecentRequest *recent = NULL;
+    unsigned long  now    = GetNow();
+    uint8_t        tokenLength;
+    const uint8_t *token = aRequest.GetToken(tokenLength);
+
+    for (size_t i = 0; i < kMaxRecentRequests; i++)
+    {
+        RecentRequest &candidate = mRecentRequests[i];
+
+        if (!candidate.mValid)
+        {
+            continue;
+        }
+
+        // no duplicate can arrive after EXCHANGE_LIFETIME
+        if (now - candidate.mTime >= kExchangeLifetime)
+        {
+            candidate.mValid = false;
+            continue;
+        }
+
+        if (candidate.mMessageId == aRequest.GetMessageId() && candidate.mPort == aPort &&
+            candidate.mHasIp6 == (aIp6 != NULL) && (aIp6 == NULL || memcmp(candidate.mIp6, aIp6, 16) == 0) &&
+            candidate.mTokenLength == tokenLength && memcmp(candidate.mToken, token, tokenLength) == 0)
+        {
+            recent = &candidate;
+            break;
+        }
+    }
+
+    return recent;
+}
+
+void AgentNative::AddRecentRequest(const MessageNative &aRequest,
+                                   const MessageNative &aResponse,
+                                   const uint8_t *      aIp6,
+                                   uint16_t             aPort)
+{
+    RecentRequest *recent = &mRecentRequests[0];
+    uint8_t        tokenLength;
+    const uint8_t *token = aRequest.GetToken(tokenLength);
+
+    // reuse a free entry, or else the oldest one
+    for (size_t i = 0; i < kMaxRecentRequests && recent->mValid; i++)
+    {
+        RecentRequest &candidate = mRecentRequests[i];
+
+        if (!candidate.mValid || static_cast<long>(candidate.mTime - recent->mTime) < 0)
+        {
+            recent = &candidate;
+        }
+    }
+
+    recent->mValid       = true;
+    recent->mHasIp6      = (aIp6 != NULL);
+    recent->mPort        = aPort;
+    recent->mMessageId   = aRequest.GetMessageId();
+    recent->mTokenLength = tokenLength;
+    recent->mTime        = GetNow();
+    recent->mHasResponse = (aResponse.GetCode() != kCodeEmpty);
+    memcpy(recent->mToken, token, tokenLength);
+
+    if (aIp6 != NULL)
+    {
+        memcpy(recent->mIp6, aIp6, sizeof(recent->mIp6));
+    }
+
+    if (recent->mHasResponse)
+    {
+        recent->mResponse.CopyFrom(aResponse);
+    }
+}
+
+AgentNative::Transaction *AgentNative::FindTransaction(const MessageNative &aResponse,
+                                                      const uint8_t *      aIp6,
+                                                      uint16_t             aPort)
+{
+    Transaction *  transaction = NULL;
+    bool           byId        = (aResponse.GetType() == kTypeAcknowledgment || aResponse.GetType() == kTypeReset);
+    bool           byToken     = !byId || aResponse.GetCode() != kCodeEmpty;
+    uint8_t        tokenLength;
+    const uint8_t *token = aResponse.GetToken(tokenLength);
+
+    // ACK and RST echo the message id, separate and piggybacked responses the token, all come from the request peer
+    for (size_t i = 0; i < kMaxTransactions; i++)
+    {
+        Transaction &candidate = mTransactions[i];
+
+        if (!candidate.mValid || candidate.mPort != aPort || candidate.mHasIp6 != (aIp6 != NULL) ||
+            (aIp6 != NULL && memcmp(candidate.mIp6, aIp6, sizeof(candidate.mIp6)) != 0))
+        {
+            continue;
+        }
+
+        if ((byId ? candidate.mMessageId == aResponse.GetMessageId() : candidate.mHandler != NULL) &&
+            (!byToken || (candidate.mTokenLength == tokenLength && memcmp(candidate.mToken, token, tokenLength) == 0)))
+        {
+            transaction = &candidate;
+            break;
+        }
+    }
+
+    return transaction;
+}
+
+void AgentNative::HandleResponse(const MessageNative &aResponse, const uint8_t *aIp6, uint16_t aPort)
+{
+    Transaction *transaction = FindTransaction(aResponse, aIp6, aPort);
+    Block        block;
+    uint32_t     sequence;
+    uint32_t     observe;
+
+    if (transaction == NULL)
+    {
+        otbrLog(OTBR_LOG_DEBUG, "CoAP response not matched!");
+
+        if (aResponse.GetType() == kTypeConfirmable)
+        {
+            SendEmpty(kTypeReset, aResponse.GetMessageId(), aIp6, aPort);
+        }
+
+        ExitNow();
+    }
+
+    if (aResponse.GetType() == kTypeReset)
+    {
+        otbrLog(OTBR_LOG_WARNING, "CoAP request reset by peer!");
+        FinishTransaction(*transaction, NULL, ECONNRESET);
+        ExitNow();
+    }
+
+    // acknowledged, stop retransmitting
+    if (aResponse.GetType() == kTypeAcknowledgment)
+    {
+        transaction->mAcknowledged = true;
+        transaction->mTimeout      = GetNow() + kMaxTransmitWait;
+    }
+
+    if (aResponse.GetCode() == kCodeEmpty)
+    {
+        // the response to a request, if any is expected, will follow separately
+        if (transaction->mHandler == NULL || (!transaction->mObserving && !transaction->mMessage->IsRequest()))
+        {
+            FinishTransaction(*transaction, &aResponse, 0);
+        }
+
+        ExitNow();
+    }
+
+    if (aResponse.GetType() == kTypeConfirmable)
+    {
+        SendEmpty(kTypeAcknowledgment, aResponse.GetMessageId(), aIp6, aPort);
+    }
+
+    if (transaction->mHandler != NULL && aResponse.GetObserve(sequence) == OTBR_ERROR_NONE &&
+        (aResponse.GetCode() >> 5) == 2 &&
+        (transaction->mObserving || (transaction->mMessage->GetObserve(observe) == OTBR_ERROR_NONE &&
+                                     observe == kObserveRegister)))
+    {
+        HandleNotification(*transaction, aResponse, sequence);
+        ExitNow();
+    }
+
+    if (transaction->mBlockReader != NULL && transaction->mBlockMore && aResponse.GetCode() == kCodeContinue)
+    {
+        SendNextBlock1(*transaction, aResponse);
+        ExitNow();
+    }
+
+    if (transaction->mHandler != NULL && !transaction->mObserving &&
+        aResponse.GetBlock(kOptionBlock2, block) == OTBR_ERROR_NONE && block.mMore)
+    {
+        // stream each block to the handler as it arrives
+        transaction->mHandler(&aResponse, OTBR_ERROR_NONE, transaction->mContext);
+        RequestNextBlock2(*transaction, block);
+        ExitNow();
+    }
+
+    FinishTransaction(*transaction, &aResponse, 0);
+
+exit:
+    return;
+}
+
+void AgentNative::Input(const void *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort)
+{
+    // parsing never writes to the buffer
+    MessageNative message(const_cast<uint8_t *>(static_cast<const uint8_t *>(aBuffer)), aLength);
+
+    VerifyOrExit(message.Parse(aLength) == OTBR_ERROR_NONE, otbrLog(OTBR_LOG_WARNING, "CoAP dropped malformed message!"));
+
+    if (message.IsRequest())
+    {
+        HandleRequest(message, aIp6, aPort);
+    }
+    else if (message.GetCode() == kCodeEmpty && message.GetType() == kTypeConfirmable)
+    {
+        // CoAP ping
+        SendEmpty(kTypeReset, message.GetMessageId(), aIp6, aPort);
+    }
+    else
+    {
+        HandleResponse(message, aIp6, aPort);
+    }
+
+exit:
+    return;
+}
+
+otbrError AgentNative::AddResource(const Resource &aResource)
+{
+    otbrError ret = mRouter.Add(aResource);
+
+    if (ret != OTBR_ERROR_NONE)
+    {
+        otbrLog(OTBR_LOG_ERR, "CoAP resource already added!");
+    }
+
+    return ret;
+}
+
+otbrError AgentNative::RemoveResource(const Resource &aResource)
+{
+    otbrError ret;
+
+    SuccessOrExit(ret = mRouter.Remove(aResource));
+
+    for (size_t i = 0; i < kMaxObservers; i++)
+    {
+        if (mObservers[i].mResource == &aResource)
+        {
+            mObservers[i].mValid = false;
+        }
+    }
+
+exit:
+    return ret;
+}
+
+Metrics *AgentNative::FindMetrics(const MessageNative &aMessage, uint32_t aPathHash)
+{
+    std::unordered_map<uint32_t, Metrics *>::const_iterator it = mMetricsByPath.find(aPathHash);
+    Metrics *                                               metrics;
+
+    // paths whose hashes collide share an entry, like those counted in "*"
+    VerifyOrExit(it == mMetricsByPath.end(), metrics = it->second);
+
+    // the last entry collects all paths once the others are taken
+    if (mMetricsCount == kMaxMetrics)
+    {
+        ExitNow(metrics = &mMetrics[kMaxMetrics - 1]);
+    }
+
+    metrics = &mMetrics[mMetricsCount++];
+
+    if (mMetricsCount == kMaxMetrics)
+    {
+        strcpy(metrics->mPath, "*");
+    }
+    else
+    {
+        aMessage.GetPath(metrics->mPath, sizeof(metrics->mPath));
+        mMetricsByPath[aPathHash] = metrics;
+    }
+
+exit:
+    return metrics;
+}
+
+void AgentNative::RecordResult(Transaction &aTransaction, const MessageNative *aResponse, int aErrno)
+{
+    Metrics *metrics = aTransaction.mMetrics;
+
+    VerifyOrExit(metrics != NULL);
+
+    // recorded once for each request
+    aTransaction.mMetrics = NULL;
+
+    if (aResponse != NULL && aResponse->GetCode() != kCodeEmpty)
+    {
+        unsigned long rtt    = GetNow() - aTransaction.mStartTime;
+        size_t        bucket = 0;
+
+        while (bucket + 1 < Metrics::kRttBuckets &&
+               rtt >= (static_cast<unsigned long>(Metrics::kRttMinBound) << bucket))
+        {
+            bucket++;
+        }
+
+        metrics->mResponsesReceived[aResponse->GetCode() >> 5]++;
+        metrics->mRtt[bucket]++;
+        metrics->mRttTotal += rtt;
+        metrics->mRttMax = std::max(metrics->mRttMax, static_cast<uint32_t>(rtt));
+    }
+    else if (aErrno == ETIMEDOUT)
+    {
+        metrics->mTimeouts++;
+    }
+    else if (aErrno == ECONNRESET)
+    {
+        metrics->mResets++;
+    }
+
+exit:
+    return;
+}
+
+const Metrics *AgentNative::GetMetrics(size_t &aCount) const
+{
+    aCount = mMetricsCount;
+
+    return mMetrics;
+}
+
+void AgentNative::HandleNotification(Transaction &aTransaction, const MessageNative &aNotification, uint32_t aSequence)
+{
+    unsigned long now = GetNow();
+
+    // RFC 7641 section 3.4, notifications may arrive out of order
+    if (aTransaction.mObserving && !((aTransaction.mObserveSequence < aSequence &&
+                                      aSequence - aTransaction.mObserveSequence < kObserveWindow) ||
+                                     (aTransaction.mObserveSequence > aSequence &&
+                                      aTransaction.mObserveSequence - aSequence > kObserveWindow) ||
+                                     now - aTransaction.mObserveTime > kObserveFreshness))
+    {
+        otbrLog(OTBR_LOG_DEBUG, "CoAP dropped stale notification %u", aSequence);
+        ExitNow();
+    }
+
+    if (aTransaction.mMessage != NULL)
+    {
+        mMessagePool.Free(aTransaction.mMessage);
+        aTransaction.mMessage = NULL;
+    }
+
+    // the registration completes with its first notification
+    RecordResult(aTransaction, &aNotification, 0);
+
+    aTransaction.mObserving       = true;
+    aTransaction.mAcknowledged    = true;
+    aTransaction.mObserveSequence = aSequence;
+    aTransaction.mObserveTime     = now;
+
+    // the handler may cancel the observation
+    aTransaction.mHandler(&aNotification, OTBR_ERROR_NONE, aTransaction.mContext);
+
+exit:
+    return;
+}
+
+otbrError AgentNative::CancelObserve(const uint8_t *aToken, uint8_t aTokenLength)
+{
+    otbrError ret = OTBR_ERROR_ERRNO;
+
+    for (size_t i = 0; i < kMaxTransactions; i++)
+    {
+        Transaction &transaction = mTransactions[i];
+
+        if (transaction.mValid && transaction.mTokenLength == aTokenLength &&
+            memcmp(transaction.mToken, aToken, aTokenLength) == 0 &&
+            (transaction.mObserving || transaction.mMessage->IsRequest()))
+        {
+            if (transaction.mMessage != NULL)
+            {
+                mMessagePool.Free(transaction.mMessage);
+                transaction.mMessage = NULL;
+            }
+
+            transaction.mValid = false;
+            ExitNow(ret = OTBR_ERROR_NONE);
+        }
+    }
+
+    errno = ENOENT;
+
+exit:
+    return ret;
+}
+
+AgentNative::Observer *AgentNative::FindObserver(const Resource &aResource, const uint8_t *aIp6, uint16_t aPort)
+{
+    Observer *observer = NULL;
+
+    for (size_t i = 0; i < kMaxObservers; i++)
+    {
+        Observer &candidate = mObservers[i];
+
+        if (candidate.mValid && candidate.mResource == &aResource && candidate.mPort == aPort &&
+            candidate.mHasIp6 == (aIp6 != NULL) && (aIp6 == NULL || memcmp(candidate.mIp6, aIp6, 16) == 0))
+        {
+            observer = &candidate;
+            break;
+        }
+    }
+
+    return observer;
+}
+
+void AgentNative::UpdateObserver(const Resource &     aResource,
+                                 const MessageNative &aRequest,
+                                 uint32_t             aObserve,
+                                 MessageNative &      aResponse,
+                                 const uint8_t *      aIp6,
+                                 uint16_t             aPort)
+{
+    Observer *     observer = FindObserver(aResource, aIp6, aPort);
+    uint8_t        tokenLength;
+    const uint8_t *token = aRequest.GetToken(tokenLength);
+    char           path[kMaxObservedPath + 1];
+
+    aRequest.GetPath(path, sizeof(path));
+
+    // only successful responses keep an observer registered, and only if its path can be replayed in full
+    if (aObserve != kObserveRegister || (aResponse.GetCode() >> 5) != 2 || strlen(path) >= kMaxObservedPath)
+    {
+        if (observer != NULL)
+        {
+            observer->mValid = false;
+        }
+
+        ExitNow();
+    }
+
+    for (size_t i = 0; observer == NULL && i < kMaxObservers; i++)
+    {
+        if (!mObservers[i].mValid)
+        {
+            observer = &mObservers[i];
+        }
+    }
+
+    VerifyOrExit(observer != NULL, otbrLogRateLimited(OTBR_LOG_WARNING, "CoAP too many observers!"));
+
+    // a registration from the same endpoint replaces the previous one
+    observer->mValid       = true;
+    observer->mResource    = &aResource;
+    observer->mHasIp6      = (aIp6 != NULL);
+    observer->mPort        = aPort;
+    observer->mTokenLength = tokenLength;
+    observer->mGeneration  = mObserverGeneration++;
+    memcpy(observer->mToken, token, tokenLength);
+    strcpy(observer->mPath, path);
+
+    if (aIp6 != NULL)
+    {
+        memcpy(observer->mIp6, aIp6, sizeof(observer->mIp6));
+    }
+
+    aResponse.SetObserve(mObserveSequence++);
+
+exit:
+    return;
+}
+
+unsigned int AgentNative::Notify(const Resource &aResource)
+{
+    unsigned int count = 0;
+
+    for (size_t i = 0; i < kMaxObservers; i++)
+    {
+        if (mObservers[i].mValid && mObservers[i].mResource == &aResource)
+        {
+            SendNotification(mObservers[i]);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void AgentNative::SendNotification(Observer &aObserver)
+{
+    const Resource &resource = *aObserver.mResource;
+    RequestHandler  handler  = resource.GetHandler(kCodeGet);
+    const uint8_t * ip6      = aObserver.mHasIp6 ? aObserver.mIp6 : NULL;
+    uint8_t         requestBuffer[MessageNative::kMaxMessageSize];
+    uint8_t         responseBuffer[MessageNative::kMaxMessageSize];
+    MessageNative   request(requestBuffer, sizeof(requestBuffer));
+    MessageNative   response(responseBuffer, sizeof(responseBuffer));
+    Transaction *   transaction;
+
+    VerifyOrExit(handler != NULL, aObserver.mValid = false);
+
+    // the handler fills the notification as if answering the registration again
+    request.Init(kTypeNonConfirmable, kCodeGet, 0, aObserver.mToken, aObserver.mTokenLength);
+    request.SetPath(aObserver.mPath);
+    request.SetObserve(kObserveRegister);
+
+    // confirmable, so that observers which have gone away are detected
+    response.Init(kTypeConfirmable, kCodeEmpty, mMessageId++, aObserver.mToken, aObserver.mTokenLength);
+    handler(resource, request, response, ip6, aObserver.mPort, resource.mContext);
+    VerifyOrExit(response.GetCode() != kCodeEmpty);
+
+    if ((response.GetCode() >> 5) == 2)
+    {
+        response.SetObserve(mObserveSequence++);
+    }
+    else
+    {
+        aObserver.mValid = false;
+    }
+
+    SuccessOrExit(SendMessage(response, ip6, aObserver.mPort, NULL, NULL, transaction));
+    transaction->mObserver           = &aObserver;
+    transaction->mObserverGeneration = aObserver.mGeneration;
+
+exit:
+    return;
+}
+
+Agent *Agent::Create(NetworkSender aNetworkSender, void *aContext)
+{
+    return new AgentNative(aNetworkSender, aContext);
+}
+
+void Agent::Destroy(Agent *aAgent)
+{
+    delete static_cast<AgentNative *>(aAgent);
+}
+
+} // namespace Coap
+
+} // namespace BorderRouter
+
+} // namespace ot
@@ -0,0 +1,963 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file includes definition for the native CoAP service.
+ */
+
+#ifndef COAP_NATIVE_HPP_
+#define COAP_NATIVE_HPP_
+
+#if HAVE_CONFIG_H
+#include "otbr-config.h"
+#endif
+
+#include <unordered_map>
+
+#include "coap.hpp"
+
+/**
+ * Number of CoAP messages an agent can hold at the same time.
+ *
+ * Every message waiting for an acknowledgment or a response holds one, so the default leaves room for all
+ * transactions plus the message being built.
+ *
+ */
+#ifndef OTBR_COAP_MESSAGE_POOL_SIZE
+#define OTBR_COAP_MESSAGE_POOL_SIZE 17
+#endif
+
+/**
+ * Number of recent CoAP requests an agent remembers to detect duplicates.
+ *
+ */
+#ifndef OTBR_COAP_DEDUP_CACHE_SIZE
+#define OTBR_COAP_DEDUP_CACHE_SIZE 8
+#endif
+
+namespace ot {
+
+namespace BorderRouter {
+
+namespace Coap {
+
+/**
+ * @addtogroup border-router-coap
+ *
+ * @brief
+ *   This module includes definition for the native CoAP service.
+ *
+ * @{
+ */
+
+/**
+ * This class implements CoAP message functionality directly on a buffer owned by the caller.
+ *
+ * Received messages are parsed in place and messages to send are built in place, so the buffer is exactly what goes
+ * on the wire.
+ *
+ */
+class MessageNative : public Message
+{
+public:
+    enum
+    {
+        kVersion         = 1,    ///< CoAP version.
+        kHeaderSize      = 4,    ///< Size of the fixed CoAP header.
+        kMaxTokenLength  = 8,    ///< Max length of a token.
+        kMaxMessageSize  = 1280, ///< Max size of a CoAP message, the IPv6 minimum MTU.
+        kPayloadMarker   = 0xff, ///< Marker between options and payload.
+        kMaxOptionLength = 1034, ///< Max length of an option value this codec encodes.
+        kMinBlockSize    = 16,   ///< Min size of a block in block-wise transfers.
+        kMaxBlockSize    = 1024, ///< Max size of a block in block-wise transfers.
+    };
+
+    /**
+     * The constructor to initialize a CoAP message on a buffer.
+     *
+     * @param[in]   aBuffer     A pointer to the buffer.
+     * @param[in]   aSize       Size of @p aBuffer in bytes.
+     *
+     */
+    MessageNative(uint8_t *aBuffer, uint16_t aSize);
+
+    virtual ~MessageNative(void) {}
+
+    /**
+     * This method initializes an empty message with the given header.
+     *
+     * @param[in]   aType           The CoAP type.
+     * @param[in]   aCode           The CoAP code.
+     * @param[in]   aMessageId      The CoAP message id.
+     * @param[in]   aToken          The CoAP token.
+     * @param[in]   aTokenLength    Number of bytes in @p aToken.
+     *
+     */
+    void Init(Type aType, Code aCode, uint16_t aMessageId, const uint8_t *aToken, uint8_t aTokenLength);
+
+    /**
+     * This method parses a received message of @p aLength bytes at the beginning of the buffer.
+     *
+     * @param[in]   aLength     Number of bytes of the message.
+     *
+     * @retval OTBR_ERROR_NONE      Successfully parsed the message.
+     * @retval OTBR_ERROR_ERRNO     The message is malformed, errno is set to EBADMSG.
+     *
+     */
+    otbrError Parse(uint16_t aLength);
+
+    /**
+     * This method copies another message into this message.
+     *
+     * @param[in]   aMessage    A reference to the message to copy, which must fit in the buffer of this message.
+     *
+     */
+    void CopyFrom(const MessageNative &aMessage);
+
+    /**
+     * This method returns the CoAP code of this message.
+     *
+     * @returns the CoAP code of the message.
+     *
+     */
+    Code GetCode(void) const { return static_cast<Code>(mBuffer[1]); }
+
+    /**
+     * This method sets the CoAP code of this message.
+     *
+     * @param[in]   aCode   The CoAP code.
+     *
+     */
+    void SetCode(Code aCode) { mBuffer[1] = static_cast<uint8_t>(aCode); }
+
+    /**
+     * This method returns the CoAP type of this message.
+     *
+     * @returns The CoAP type of the message.
+     *
+     */
+    Type GetType(void) const { return static_cast<Type>((mBuffer[0] >> 4) & 0x03); }
+
+    /**
+     * This method sets the CoAP type of this message.
+     *
+     * @param[in]   aType   The CoAP type.
+     *
+     */
+    void SetType(Type aType) { mBuffer[0] = static_cast<uint8_t>((mBuffer[0] & 0xcf) | (aType << 4)); }
+
+    /**
+     * This method returns the message id of this message.
+     *
+     * @returns The message id of the message.
+     *
+     */
+    uint16_t GetMessageId(void) const { return static_cast<uint16_t>((mBuffer[2] << 8) | mBuffer[3]); }
+
+    /**
+     * This method sets the message id of this message.
+     *
+     * @param[in]   aMessageId  The message id.
+     *
+     */
+    void SetMessageId(uint16_t aMessageId);
+
+    /**
+     * This method returns the token of this message.
+     *
+     * @param[out]    aLength       Number of bytes of the token.
+     *
+     * @returns A pointer to the token.
+     *
+     */
+    const uint8_t *GetToken(uint8_t &aLength) const;
+
+    /**
+     * This method sets the token of this message.
+     *
+     * @param[in]   aToken          A pointer to the token.
+     * @param[in]   aLength         Number of bytes of the token.
+     *
+     */
+    void SetToken(const uint8_t *aToken, uint8_t aLength);
+
+    /**
+     * This method sets the CoAP Uri Path of this message.
+     *
+     * @param[in]   aPath           A pointer to to the null-terminated string of Uri Path.
+     *
+     */
+    void SetPath(const char *aPath);
+
+    /**
+     * This method returns the CoAP Uri Path of this message.
+     *
+     * @param[out]  aPath           A pointer to where to store the null-terminated string of Uri Path.
+     * @param[in]   aSize           Size of @p aPath, a longer path is truncated.
+     *
+     */
+    void GetPath(char *aPath, size_t aSize) const;
+
+    /**
+     * This method returns the payload of this message.
+     *
+     * @param[out]  aLength         Number of bytes of the payload.
+     *
+     * @returns A pointer to the payload buffer.
+     */
+    const uint8_t *GetPayload(uint16_t &aLength) const;
+
+    /**
+     * This method sets the payload of this message.
+     *
+     * @param[in]   aPayload        A pointer to the payload.
+     * @param[in]   aLength         Number of bytes of the payload.
+     *
+     */
+    void SetPayload(const uint8_t *aPayload, uint16_t aLength);
+
+    /**
+     * This method inserts an option, keeping options ordered by number.
+     *
+     * Options of the same number keep the order they are inserted in.
+     *
+     * @param[in]   aNumber     The option number.
+     * @param[in]   aValue      A pointer to the option value.
+     * @param[in]   aLength     Number of bytes of @p aValue.
+     *
+     * @retval OTBR_ERROR_NONE      Successfully inserted the option.
+     * @retval OTBR_ERROR_ERRNO     No space left in the buffer, errno is set to EMSGSIZE.
+     *
+     */
+    otbrError InsertOption(uint16_t aNumber, const uint8_t *aValue, uint16_t aLength);
+
+    /**
+     * This method removes all options of a number.
+     *
+     * @param[in]   aNumber     The option number.
+     *
+     */
+    void RemoveOption(uint16_t aNumber);
+
+    /**
+     * This method returns a Block1 or Block2 option of this message.
+     *
+     * @param[in]   aOption     The option, kOptionBlock1 or kOptionBlock2.
+     * @param[out]  aBlock      A reference to where to store the block.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully got the block option.
+     * @retval  OTBR_ERROR_ERRNO    Failed to get the block option.
+     *                              - ENOENT The option is absent.
+     *                              - EBADMSG The option is malformed.
+     *
+     */
+    otbrError GetBlock(OptionNumber aOption, Block &aBlock) const;
+
+    /**
+     * This method sets a Block1 or Block2 option of this message, replacing any existing one.
+     *
+     * @param[in]   aOption     The option, kOptionBlock1 or kOptionBlock2.
+     * @param[in]   aBlock      A reference to the block.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully set the block option.
+     * @retval  OTBR_ERROR_ERRNO    Failed to set the block option.
+     *                              - EINVAL The block size or number is invalid.
+     *                              - EMSGSIZE No space left in the message.
+     *
+     */
+    otbrError SetBlock(OptionNumber aOption, const Block &aBlock);
+
+    /**
+     * This method returns the Observe option of this message.
+     *
+     * @param[out]  aObserve    A reference to where to store the option value.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully got the Observe option.
+     * @retval  OTBR_ERROR_ERRNO    Failed to get the Observe option.
+     *                              - ENOENT The option is absent.
+     *                              - EBADMSG The option is malformed.
+     *
+     */
+    otbrError GetObserve(uint32_t &aObserve) const;
+
+    /**
+     * This method sets the Observe option of this message, replacing any existing one.
+     *
+     * @param[in]   aObserve    The option value, only the lower 24 bits are used.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully set the Observe option.
+     * @retval  OTBR_ERROR_ERRNO    No space left in the message, errno is set to EMSGSIZE.
+     *
+     */
+    otbrError SetObserve(uint32_t aObserve);
+
+    /**
+     * This method returns the value of an unsigned integer option of this message.
+     *
+     * @param[in]   aNumber     The option number.
+     * @param[out]  aValue      A reference to where to store the value.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully got the option.
+     * @retval  OTBR_ERROR_ERRNO    Failed to get the option.
+     *                              - ENOENT The option is absent.
+     *                              - EBADMSG The option is longer than 4 bytes.
+     *
+     */
+    otbrError GetUintOption(uint16_t aNumber, uint32_t &aValue) const;
+
+    /**
+     * This method sets an unsigned integer option of this message in as few bytes as possible, replacing any
+     * existing one.
+     *
+     * @param[in]   aNumber     The option number.
+     * @param[in]   aValue      The value.
+     *
+     * @retval OTBR_ERROR_NONE      Successfully set the option.
+     * @retval OTBR_ERROR_ERRNO     No space left in the buffer, errno is set to EMSGSIZE.
+     *
+     */
+    otbrError SetUintOption(uint16_t aNumber, uint32_t aValue);
+
+    /**
+     * This method returns the encoded message.
+     *
+     * @returns A pointer to the encoded message.
+     *
+     */
+    const uint8_t *GetBuffer(void) const { return mBuffer; }
+
+    /**
+     * This method returns the buffer of this message, e.g. to receive a message before Parse().
+     *
+     * @returns A pointer to the buffer.
+     *
+     */
+    uint8_t *GetBuffer(void) { return mBuffer; }
+
+    /**
+     * This method returns the length of the encoded message.
+     *
+     * @returns Number of bytes of the encoded message.
+     *
+     */
+    uint16_t GetLength(void) const { return mLength; }
+
+    /**
+     * This method indicates whether something did not fit in the buffer while building this message.
+     *
+     * @returns Whether the message is truncated.
+     *
+     */
+    bool IsTruncated(void) const { return mTruncated; }
+
+    /**
+     * This method indicates whether this message is a request.
+     *
+     * @returns Whether the message is a request.
+     *
+     */
+    bool IsRequest(void) const { return GetCode() >= kCodeGet && GetCode() < kCodeCodeMin; }
+
+    /**
+     * This method indicates whether this message is a response.
+     *
+     * @returns Whether the message is a response.
+     *
+     */
+    bool IsResponse(void) const { return GetCode() >= kCodeCodeMin; }
+
+private:
+    friend class OptionIterator;
+
+    uint16_t GetOptionsOffset(void) const { return static_cast<uint16_t>(kHeaderSize + (mBuffer[0] & 0x0f)); }
+
+    uint8_t *mBuffer;
+    uint16_t mSize;
+    uint16_t mLength;
+    uint16_t mOptionsEnd;
+    bool     mTruncated;
+};
+
+/**
+ * This class iterates the options of a message in order.
+ *
+ */
+class OptionIterator
+{
+public:
+    /**
+     * The constructor to iterate the options of @p aMessage.
+     *
+     * @param[in]   aMessage    A reference to a parsed or built message.
+     *
+     */
+    explicit OptionIterator(const MessageNative &aMessage);
+
+    /**
+     * This method indicates whether all options have been iterated.
+     *
+     * @returns Whether the iteration is done.
+     *
+     */
+    bool IsDone(void) const { return mCursor >= mEnd; }
+
+    /**
+     * This method returns the number of the current option.
+     *
+     * @returns The option number.
+     *
+     */
+    uint16_t GetNumber(void) const { return mNumber; }
+
+    /**
+     * This method returns the value of the current option.
+     *
+     * @returns A pointer to the option value.
+     *
+     */
+    const uint8_t *GetValue(void) const { return mValue; }
+
+    /**
+     * This method returns the length of the current option.
+     *
+     * @returns Number of bytes of the option value.
+     *
+     */
+    uint16_t GetLength(void) const { return mLength; }
+
+    /**
+     * This method moves to the next option.
+     *
+     */
+    void Next(void);
+
+private:
+    void Read(void);
+
+    const uint8_t *mCursor;
+    const uint8_t *mEnd;
+    const uint8_t *mValue;
+    uint16_t       mNumber;
+    uint16_t       mLength;
+};
+
+/**
+ * This class implements a CoAP message with its own storage.
+ *
+ */
+class MessageBuffer : public MessageNative
+{
+public:
+    /**
+     * The constructor to initialize an empty message.
+     *
+     */
+    MessageBuffer(void)
+        : MessageNative(mStorage, sizeof(mStorage))
+    {
+    }
+
+private:
+    uint8_t mStorage[kMaxMessageSize];
+};
+
+/**
+ * This class routes requests to resources by the hash of their Uri Path.
+ *
+ * Path hashes of resources are computed when they are added, and the hash of a request path is computed while walking
+ * its Uri-Path options once, so dispatch does not depend on the number of resources.
+ *
+ */
+class ResourceRouter
+{
+public:
+    /**
+     * This method adds a resource.
+     *
+     * @param[in]   aResource   A reference to the resource.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully added the resource.
+     * @retval  OTBR_ERROR_ERRNO    A resource with the same path already exists, errno is set to EEXIST.
+     *
+     */
+    otbrError Add(const Resource &aResource);
+
+    /**
+     * This method removes a resource.
+     *
+     * @param[in]   aResource   A reference to the resource.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully removed the resource.
+     * @retval  OTBR_ERROR_ERRNO    The resource was not added, errno is set to ENOENT.
+     *
+     */
+    otbrError Remove(const Resource &aResource);
+
+    /**
+     * This method finds the resource of a request.
+     *
+     * @param[in]   aRequest    A reference to the request.
+     * @param[out]  aPathHash   The hash of the request Uri Path, as returned by HashRequestPath().
+     *
+     * @returns A pointer to the resource, NULL if no resource matches the request path.
+     *
+     */
+    const Resource *Find(const MessageNative &aRequest, uint32_t &aPathHash) const;
+
+    /**
+     * This method hashes the Uri Path of a message.
+     *
+     * @param[in]   aMessage    A reference to the message.
+     *
+     * @returns The hash of the Uri Path.
+     *
+     */
+    static uint32_t HashRequestPath(const MessageNative &aMessage);
+
+private:
+    /** A resource and the length of its path without the prefix wildcard */
+    struct Route
+    {
+        const Resource *mResource;
+        size_t          mPathLength;
+    };
+
+    typedef std::unordered_multimap<uint32_t, Route> Routes;
+
+    static uint32_t        HashPath(const char *aPath, size_t &aPathLength, bool &aIsPrefix);
+    static bool            MatchPath(const Route &aRoute, const MessageNative &aRequest, bool aIsPrefix);
+    static const Resource *Lookup(const Routes &       aRoutes,
+                                  uint32_t             aHash,
+                                  const MessageNative &aRequest,
+                                  bool                 aIsPrefix);
+
+    Routes mExactRoutes;
+    Routes mPrefixRoutes;
+};
+
+/**
+ * This class implements a fixed-size pool of CoAP messages.
+ *
+ */
+class MessagePool
+{
+public:
+    enum
+    {
+        kSize = OTBR_COAP_MESSAGE_POOL_SIZE, ///< Number of messages in the pool.
+    };
+
+    /**
+     * This structure represents the usage statistics of a pool.
+     *
+     */
+    struct Stats
+    {
+        size_t mInUse;           ///< Number of messages currently allocated.
+        size_t mMaxInUse;        ///< Max number of messages allocated at the same time.
+        size_t mAllocations;     ///< Number of successful allocations.
+        size_t mAllocationFails; ///< Number of allocations failed because the pool was exhausted.
+    };
+
+    /**
+     * The constructor to initialize a pool with all messages free.
+     *
+     */
+    MessagePool(void);
+
+    /**
+     * This method allocates a message.
+     *
+     * @returns A pointer to the message, or NULL with errno set to ENOBUFS if the pool is exhausted.
+     *
+     */
+    MessageBuffer *New(void);
+
+    /**
+     * This method returns a message to the pool.
+     *
+     * @param[in]   aMessage    A pointer to a message allocated from this pool.
+     *
+     */
+    void Free(MessageBuffer *aMessage);
+
+    /**
+     * This method returns the usage statistics of this pool.
+     *
+     * @returns A reference to the statistics.
+     *
+     */
+    const Stats &GetStats(void) const { return mStats; }
+
+private:
+    MessageBuffer  mMessages[kSize];
+    MessageBuffer *mFree[kSize];
+    size_t         mFreeCount;
+    Stats          mStats;
+};
+
+/**
+ * This class implements the native CoAP agent.
+ *
+ */
+class AgentNative : public Agent
+{
+public:
+    /**
+     * The constructor to initialize a CoAP agent.
+     *
+     * @param[in]   aNetworkSender      A pointer to the function that actually sends the data.
+     * @param[in]   aContext            A pointer to application-specific context.
+     *
+     */
+    AgentNative(NetworkSender aNetworkSender, void *aContext);
+
+    /**
+     * This method processes this CoAP message in @p aBuffer, which can be a request or response.
+     *
+     * The message is parsed in place, @p aBuffer is neither copied nor modified.
+     *
+     * @param[in]   aBuffer         A pointer to decrypted data.
+     * @param[in]   aLength         Number of bytes of @p aBuffer.
+     * @param[in]   aIp6            A pointer to the source Ipv6 address of this request.
+     * @param[in]   aPort           Source UDP port of this request.
+     *
+     */
+    void Input(const void *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort);
+
+    /**
+     * This method sends the CoAP message, which can be a request or response.
+     *
+     * @param[in]   aMessage    A reference to the message to send.
+     * @param[in]   aIp6        A pointer to the source Ipv6 address of this request.
+     * @param[in]   aPort       Source UDP port of this request.
+     * @param[in]   aHandler    A function poiner to be called when response is received if the message is a request.
+     * @param[in]   aContext    A pointer to application-specific context.
+     *
+     * @retval      OTBR_ERROR_NONE     Successfully sent the message.
+     * @retval      OTBR_ERROR_ERRNO    Failed to send the message.
+     *                                  - EMSGSIZE The message did not fit in its buffer.
+     *                                  - ENOBUFS No space for response handler or retransmission.
+     *
+     */
+    otbrError Send(Message &aMessage, const uint8_t *aIp6, uint16_t aPort, ResponseHandler aHandler, void *aContext);
+
+    /**
+     * This method sends a request with a payload in Block1 blocks, read one block at a time.
+     *
+     * @param[in]   aRequest        A reference to the request, its payload is replaced by the first block.
+     * @param[in]   aBlockSize      The block size, a power of two from 16 to 1024.
+     * @param[in]   aReader         A function pointer to read the payload.
+     * @param[in]   aReaderContext  A pointer to application-specific context for @p aReader.
+     * @param[in]   aIp6            A pointer to the source Ipv6 address of this request.
+     * @param[in]   aPort           Source UDP port of this request.
+     * @param[in]   aHandler        A function poiner to be called when the final response is received.
+     * @param[in]   aContext        A pointer to application-specific context.
+     *
+     * @retval      OTBR_ERROR_NONE     Successfully sent the first block.
+     * @retval      OTBR_ERROR_ERRNO    Failed to send the first block.
+     *
+     */
+    otbrError SendBlockwise(Message &       aRequest,
+                            uint16_t        aBlockSize,
+                            BlockReader     aReader,
+                            void *          aReaderContext,
+                            const uint8_t * aIp6,
+                            uint16_t        aPort,
+                            ResponseHandler aHandler,
+                            void *          aContext);
+
+    /**
+     * This method notifies all observers of a resource of its current state.
+     *
+     * @param[in]   aResource   A reference to the resource.
+     *
+     * @returns The number of notifications sent.
+     *
+     */
+    unsigned int Notify(const Resource &aResource);
+
+    /**
+     * This method stops observing a resource.
+     *
+     * @param[in]   aToken          A pointer to the token of the registration request.
+     * @param[in]   aTokenLength    The token length.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully stopped observing.
+     * @retval  OTBR_ERROR_ERRNO    No such observation, errno is set to ENOENT.
+     *
+     */
+    otbrError CancelObserve(const uint8_t *aToken, uint8_t aTokenLength);
+
+    /**
+     * This method updates the fd_set and timeout for mainloop.
+     *
+     * @param[inout]    aReadFdSet      A reference to fd_set for polling read.
+     * @param[inout]    aWriteFdSet     A reference to fd_set for polling read.
+     * @param[inout]    aErrorFdSet     A reference to fd_set for polling error.
+     * @param[inout]    aMaxFd          A reference to the current max fd in @p aReadFdSet and @p aWriteFdSet.
+     * @param[inout]    aTimeout        A reference to the timeout.
+     *
+     */
+    void UpdateFdSet(fd_set &aReadFdSet, fd_set &aWriteFdSet, fd_set &aErrorFdSet, int &aMaxFd, timeval &aTimeout);
+
+    /**
+     * This method performs retransmissions and reports timeouts of the requests due.
+     *
+     * @param[in]   aReadFdSet      A reference to fd_set ready for reading.
+     * @param[in]   aWriteFdSet     A reference to fd_set ready for writing.
+     * @param[in]   aErrorFdSet     A reference to fd_set with error occurred.
+     *
+     */
+    void Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet, const fd_set &aErrorFdSet);
+
+    /**
+     * This method performs retransmissions and reports timeouts of the requests due at @p aNow.
+     *
+     * @param[in]   aNow    The current timestamp in milliseconds.
+     *
+     */
+    void HandleTimers(unsigned long aNow);
+
+    /**
+     * This method returns the timestamp of the next retransmission or response timeout.
+     *
+     * @param[out]  aTimeout    The timestamp in milliseconds.
+     *
+     * @returns Whether any timer is pending.
+     *
+     */
+    bool GetNextTimeout(unsigned long &aTimeout) const;
+
+    /**
+     * This method creates a CoAP message with the given arguments.
+     *
+     * @param[in]   aType           The CoAP type.
+     * @param[in]   aCode           The CoAP code.
+     * @param[in]   aToken          The CoAP token.
+     * @param[in]   aTokenLength    Number of bytes in @p aToken.
+     *
+     * @returns The pointer to the newly created CoAP message.
+     *
+     */
+    Message *NewMessage(Type aType, Code aCode, const uint8_t *aToken, uint8_t aTokenLength);
+
+    /**
+     * This method frees a CoAP message.
+     *
+     * @param[in]   aMessage        A pointer to the message to free.
+     *
+     */
+    void FreeMessage(Message *aMessage);
+
+    /**
+     * This method registers a CoAP resource.
+     *
+     * @param[in]   aResource       A reference to the resource.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully added the resource.
+     * @retval  OTBR_ERROR_ERRNO    A resource with the same path already exists, errno is set to EEXIST.
+     *
+     */
+    otbrError AddResource(const Resource &aResource);
+
+    /**
+     * This method Deregisters a CoAP resource.
+     *
+     * @param[in]   aResource       A reference to the resource.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully removed the resource.
+     * @retval  OTBR_ERROR_ERRNO    The resource was not added, errno is set to ENOENT.
+     *
+     */
+    otbrError RemoveResource(const Resource &aResource);
+
+    /**
+     * This method returns the usage statistics of the message pool.
+     *
+     * @returns A reference to the statistics.
+     *
+     */
+    const MessagePool::Stats &GetMessagePoolStats(void) const { return mMessagePool.GetStats(); }
+
+    /**
+     * This method returns the metrics of all Uri Paths seen by this agent.
+     *
+     * @param[out]  aCount  A reference to where to store the number of entries.
+     *
+     * @returns A pointer to the first entry.
+     *
+     */
+    const Metrics *GetMetrics(size_t &aCount) const;
+
+private:
+    enum
+    {
+        kMaxTransactions  = 16,      ///< Max number of messages waiting for an acknowledgment or a response.
+        kAckTimeout       = 2000,    ///< ACK_TIMEOUT in milliseconds.
+        kAckRandomRange   = 1000,    ///< ACK_TIMEOUT * (ACK_RANDOM_FACTOR - 1) in milliseconds.
+        kMaxRetransmit    = 4,       ///< MAX_RETRANSMIT.
+        kMaxTransmitWait  = 93000,   ///< MAX_TRANSMIT_WAIT in milliseconds, how long to wait for a response.
+        kMaxObservers     = 8,       ///< Max number of observers of all resources.
+        kMaxObservedPath  = 64,      ///< Max length of the Uri Path of an observation, including the null character.
+        kObserveWindow    = 1 << 23, ///< Notifications with sequence numbers ahead by less than this are fresh.
+        kObserveFreshness = 128000,  ///< Notifications this many milliseconds apart are always fresh.
+        kExchangeLifetime = 247000,  ///< EXCHANGE_LIFETIME in milliseconds, how long a request may be duplicated.
+    };
+
+    enum
+    {
+        kMaxRecentRequests = OTBR_COAP_DEDUP_CACHE_SIZE, ///< Max number of requests remembered to detect duplicates.
+        kMaxMetrics        = 16,                         ///< Max number of Uri Paths to keep metrics of.
+    };
+
+    struct Observer;
+
+    /** A message waiting for its acknowledgment or response */
+    struct Transaction
+    {
+        bool            mValid;
+        uint16_t        mMessageId;
+        uint8_t         mTokenLength;
+        uint8_t         mToken[MessageNative::kMaxTokenLength];
+        ResponseHandler mHandler;
+        void *          mContext;
+        MessageBuffer * mMessage; ///< The copy to retransmit and to continue block-wise transfers.
+        bool            mHasIp6;
+        uint8_t         mIp6[16];
+        uint16_t        mPort;
+        bool            mAcknowledged;
+        uint8_t         mRetransmitCount;
+        unsigned long   mRetransmitTimeout; ///< Milliseconds between the last transmission and the next one.
+        unsigned long   mTimeout;           ///< Timestamp of the next retransmission or of giving up.
+        BlockReader     mBlockReader;       ///< The reader of the remaining Block1 payload, NULL if none.
+        void *          mBlockContext;
+        uint32_t        mBlockOffset; ///< Number of payload bytes sent in blocks.
+        uint16_t        mBlockSize;
+        bool            mBlockMore;
+        Metrics *       mMetrics;         ///< The metrics of the request path, NULL if not a request.
+        unsigned long   mStartTime;       ///< Timestamp of the first transmission.
+        bool            mObserving;          ///< Whether notifications are being received, the copy is freed then.
+        uint32_t        mObserveSequence;    ///< The sequence number of the latest notification.
+        unsigned long   mObserveTime;        ///< Timestamp of the latest notification.
+        Observer *      mObserver;           ///< The observer notified, NULL if not a notification.
+        uint32_t        mObserverGeneration; ///< The generation of the observer when notified.
+    };
+
+    /** A request recently handled, with the response to replay to its duplicates */
+    struct RecentRequest
+    {
+        bool          mValid;
+        bool          mHasIp6;
+        uint8_t       mIp6[16];
+        uint16_t      mPort;
+        uint16_t      mMessageId;
+        uint8_t       mTokenLength;
+        uint8_t       mToken[MessageNative::kMaxTokenLength];
+        unsigned long mTime;        ///< Timestamp of receiving the request.
+        bool          mHasResponse; ///< Whether a response was sent, otherwise it will be sent separately.
+        MessageBuffer mResponse;
+    };
+
+    /** A client observing a resource of this agent */
+    struct Observer
+    {
+        bool            mValid;
+        const Resource *mResource;
+        bool            mHasIp6;
+        uint8_t         mIp6[16];
+        uint16_t        mPort;
+        uint8_t         mTokenLength;
+        uint8_t         mToken[MessageNative::kMaxTokenLength];
+        uint32_t        mGeneration;             ///< Changes on each registration, so that a reused slot is told apart.
+        char            mPath[kMaxObservedPath]; ///< The Uri Path of the registration, e.g. of a prefix resource.
+    };
+
+    void           HandleRequest(const MessageNative &aRequest, const uint8_t *aIp6, uint16_t aPort);
+    void           HandleResponse(const MessageNative &aResponse, const uint8_t *aIp6, uint16_t aPort);
+    Transaction *  FindTransaction(const MessageNative &aResponse, const uint8_t *aIp6, uint16_t aPort);
+    otbrError      SendMessage(MessageNative & aMessage,
+                               const uint8_t * aIp6,
+                               uint16_t        aPort,
+                               ResponseHandler aHandler,
+                               void *          aContext,
+                               Transaction *&  aTransaction);
+    void           ArmTransaction(Transaction &aTransaction);
+    void           ContinueTransaction(Transaction &aTransaction);
+    void           SendNextBlock1(Transaction &aTransaction, const MessageNative &aResponse);
+    void           RequestNextBlock2(Transaction &aTransaction, const Block &aBlock);
+    void           FinishTransaction(Transaction &aTransaction, const MessageNative *aResponse, int aErrno);
+    void           HandleNotification(Transaction &        aTransaction,
+                                      const MessageNative &aNotification,
+                                      uint32_t             aSequence);
+    RecentRequest *FindRecentRequest(const MessageNative &aRequest, const uint8_t *aIp6, uint16_t aPort);
+    void           AddRecentRequest(const MessageNative &aRequest,
+                                    const MessageNative &aResponse,
+                                    const uint8_t *      aIp6,
+                                    uint16_t             aPort);
+    Observer *     FindObserver(const Resource &aResource, const uint8_t *aIp6, uint16_t aPort);
+    void           UpdateObserver(const Resource &     aResource,
+                                  const MessageNative &aRequest,
+                                  uint32_t             aObserve,
+                                  MessageNative &      aResponse,
+                                  const uint8_t *      aIp6,
+                                  uint16_t             aPort);
+    void           SendNotification(Observer &aObserver);
+    Metrics *      FindMetrics(const MessageNative &aMessage, uint32_t aPathHash);
+    void           RecordResult(Transaction &aTransaction, const MessageNative *aResponse, int aErrno);
+    void           SendEmpty(Type aType, uint16_t aMessageId, const uint8_t *aIp6, uint16_t aPort);
+    otbrError      Transmit(const MessageNative &aMessage, const uint8_t *aIp6, uint16_t aPort);
+
+    NetworkSender  mNetworkSender;
+    void *         mContext;
+    uint16_t       mMessageId;
+    ResourceRouter mRouter;
+    Transaction    mTransactions[kMaxTransactions];
+    MessagePool    mMessagePool;
+    Observer       mObservers[kMaxObservers];
+    RecentRequest  mRecentRequests[kMaxRecentRequests];
+    uint32_t       mObserveSequence;
+    uint32_t       mObserverGeneration;
+    Metrics        mMetrics[kMaxMetrics];
+    size_t         mMetricsCount;
+
+    std::unordered_map<uint32_t, Metrics *> mMetricsByPath; ///< The metrics entries by Uri Path hash.
+};
+
+/**
+ * @}
+ */
+
+} // namespace Coap
+
+} // namespace BorderRouter
+
+} // namespace ot
+
+#endif // COAP_NATIVE_HPP_
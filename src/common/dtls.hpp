@@ -92,6 +92,8 @@ public:
     /**
      * This function pointer is called when decrypted data are ready for use.
      *
+     * @p aBuffer is only valid during the call, so the data can be parsed in place without copying.
+     *
      * @param[in]   aBuffer         A pointer to decrypted data.
      * @param[in]   aLength         Number of bytes of @p aBuffer.
      * @param[in]   aContext        A pointer to application-specific context.
@@ -111,10 +113,14 @@ public:
     /**
      * This method sends data through the session.
      *
+     * This method never blocks. Data the socket cannot take right now is queued and sent once it becomes writable,
+     * and is reported as sent.
+     *
      * @param[in]   aBuffer         A pointer to plain data.
      * @param[in]   aLength         Number of bytes of @p aBuffer.
      *
-     * @returns number of bytes successfully sended, a negative value indicates failure.
+     * @returns number of bytes successfully sended, a negative value indicates failure, -1 with errno set to EAGAIN
+     *          if the queue is full.
      *
      */
     virtual ssize_t Write(const uint8_t *aBuffer, uint16_t aLength) = 0;
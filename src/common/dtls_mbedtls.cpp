@@ -30,6 +30,8 @@
  * This file implements the DTLS service.
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_DTLS
+
 #ifdef __APPLE__
 #define __APPLE_USE_RFC_3542
 #endif
@@ -40,12 +42,14 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include "code_utils.hpp"
 #include "logging.hpp"
 #include "time.hpp"
+#include "trace.hpp"
 #include "types.hpp"
 
 namespace ot {
@@ -58,7 +62,7 @@ static int FromOtbrLogLevel(void)
 {
     int level = 0;
 
-    switch (otbrLogGetLevel())
+    switch (otbrLogGetModuleLevel(OTBR_LOG_MODULE_DTLS))
     {
     case OTBR_LOG_EMERG:
     case OTBR_LOG_ALERT:
@@ -90,6 +94,117 @@ static int FromOtbrLogLevel(void)
     return level;
 }
 
+SessionTable::SessionTable(void)
+    : mSlots(kInitialCapacity, NULL)
+    , mSize(0)
+{
+}
+
+size_t SessionTable::Hash(const sockaddr_in6 &aRemoteSock)
+{
+    // FNV-1a over the fields IsSamePeer() compares, never over padding.
+    size_t hash = 2166136261U;
+
+    for (size_t i = 0; i < sizeof(aRemoteSock.sin6_addr); ++i)
+    {
+        hash = (hash ^ aRemoteSock.sin6_addr.s6_addr[i]) * 16777619U;
+    }
+
+    hash = (hash ^ aRemoteSock.sin6_port) * 16777619U;
+    hash = (hash ^ aRemoteSock.sin6_scope_id) * 16777619U;
+
+    return hash;
+}
+
+bool SessionTable::IsSamePeer(const sockaddr_in6 &aLeft, const sockaddr_in6 &aRight)
+{
+    return aLeft.sin6_port == aRight.sin6_port && aLeft.sin6_scope_id == aRight.sin6_scope_id &&
+           memcmp(&aLeft.sin6_addr, &aRight.sin6_addr, sizeof(aLeft.sin6_addr)) == 0;
+}
+
+size_t SessionTable::FindSlot(const sockaddr_in6 &aRemoteSock) const
+{
+    size_t mask = mSlots.size() - 1;
+    size_t slot = Hash(aRemoteSock) & mask;
+
+    // linear probing, the load factor keeps at least one slot empty
+    while (mSlots[slot] != NULL && !IsSamePeer(mSlots[slot]->GetRemoteSock(), aRemoteSock))
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+MbedtlsSession *SessionTable::Find(const sockaddr_in6 &aRemoteSock) const
+{
+    return mSlots[FindSlot(aRemoteSock)];
+}
+
+void SessionTable::Insert(MbedtlsSession &aSession)
+{
+    size_t slot;
+
+    if ((mSize + 1) * 4 > mSlots.size() * 3)
+    {
+        Grow();
+    }
+
+    slot = FindSlot(aSession.GetRemoteSock());
+
+    // a peer has one session, the one of a previous connection is removed first
+    assert(mSlots[slot] == NULL);
+
+    mSlots[slot] = &aSession;
+    ++mSize;
+}
+
+void SessionTable::Remove(const MbedtlsSession &aSession)
+{
+    size_t mask = mSlots.size() - 1;
+    size_t hole = FindSlot(aSession.GetRemoteSock());
+
+    VerifyOrExit(mSlots[hole] == &aSession);
+
+    mSlots[hole] = NULL;
+    --mSize;
+
+    // Shift back the following entries of the probe sequence rather than leaving tombstones.
+    for (size_t slot = (hole + 1) & mask; mSlots[slot] != NULL; slot = (slot + 1) & mask)
+    {
+        size_t home = Hash(mSlots[slot]->GetRemoteSock()) & mask;
+
+        // the entry stays if its home lies cyclically in (hole, slot]
+        if (((slot - home) & mask) < ((slot - hole) & mask))
+        {
+            continue;
+        }
+
+        mSlots[hole] = mSlots[slot];
+        mSlots[slot] = NULL;
+        hole         = slot;
+    }
+
+exit:
+    return;
+}
+
+void SessionTable::Grow(void)
+{
+    std::vector<MbedtlsSession *> slots(mSlots.size() * 2, NULL);
+
+    slots.swap(mSlots);
+    mSize = 0;
+
+    for (std::vector<MbedtlsSession *>::iterator it = slots.begin(); it != slots.end(); ++it)
+    {
+        if (*it != NULL)
+        {
+            Insert(**it);
+        }
+    }
+}
+
 void MbedtlsServer::MbedtlsDebug(void *aContext, int aLevel, const char *aFile, int aLine, const char *aMessage)
 {
     static_cast<MbedtlsServer *>(aContext)->MbedtlsDebug(aLevel, aFile, aLine, aMessage);
@@ -127,7 +242,7 @@ void MbedtlsServer::MbedtlsDebug(int aLevel, const char *aFile, int aLine, const
 
     if (level != 0)
     {
-        otbrLog(aLevel, "DTLS[:%hu] %s:%04d: %s", mPort, aFile, aLine, aMessage);
+        otbrLog(level, "DTLS[:%hu] %s:%04d: %s", mPort, aFile, aLine, aMessage);
     }
 }
 
@@ -163,22 +278,28 @@ otbrError MbedtlsServer::Start(void)
     SuccessOrExit(error = mbedtls_ssl_config_defaults(&mConf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_DATAGRAM,
                                                       MBEDTLS_SSL_PRESET_DEFAULT));
 
-    mbedtls_ssl_conf_rng(&mConf, mbedtls_ctr_drbg_random, &mCtrDrbg);
+    mbedtls_ssl_conf_rng(&mConf, Random, this);
     mbedtls_ssl_conf_min_version(&mConf, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
     mbedtls_ssl_conf_max_version(&mConf, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
     mbedtls_ssl_conf_dbg(&mConf, MbedtlsDebug, this);
     mbedtls_ssl_conf_ciphersuites(&mConf, ciphersuites);
     mbedtls_ssl_conf_read_timeout(&mConf, 0);
+    mbedtls_ssl_conf_handshake_timeout(&mConf, MbedtlsSession::kHandshakeInterval, MbedtlsSession::kHandshakeTimeout);
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    SuccessOrExit(error = mbedtls_ssl_conf_cid(&mConf, MbedtlsSession::kCidLength, MBEDTLS_SSL_UNEXPECTED_CID_IGNORE));
+#endif
 
 #if defined(MBEDTLS_SSL_CACHE_C)
-    mbedtls_ssl_conf_session_cache(&mConf, &mCache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+    mbedtls_ssl_conf_session_cache(&mConf, this, GetCachedSession, SetCachedSession);
 #endif
 
     SuccessOrExit(error = mbedtls_ssl_cookie_setup(&mCookie, mbedtls_ctr_drbg_random, &mCtrDrbg));
 
-    mbedtls_ssl_conf_dtls_cookies(&mConf, mbedtls_ssl_cookie_write, mbedtls_ssl_cookie_check, &mCookie);
+    mbedtls_ssl_conf_dtls_cookies(&mConf, WriteCookie, CheckCookie, this);
 
     SuccessOrExit(ret = Bind());
+    SuccessOrExit(ret = mHandshakePool.Start(OTBR_DTLS_HANDSHAKE_THREADS));
 
 exit:
 
@@ -207,6 +328,8 @@ otbrError MbedtlsServer::Bind(void)
     // This option allows binding to the same address.
     SuccessOrExit(setsockopt(mSocket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)));
     SuccessOrExit(bind(mSocket, reinterpret_cast<struct sockaddr *>(&sin6), sizeof(sin6)));
+    // All sessions share this socket, which is drained until it would block.
+    SuccessOrExit(fcntl(mSocket, F_SETFL, fcntl(mSocket, F_GETFL, 0) | O_NONBLOCK));
 
     otbrLog(OTBR_LOG_INFO, "DTLS bound to port %u.", mPort);
     ret = OTBR_ERROR_NONE;
@@ -224,6 +347,16 @@ void MbedtlsSession::SetState(State aState)
 {
     mState = aState;
     mServer.HandleSessionState(*this, aState);
+
+    if (!IsActive())
+    {
+        mServer.RetireSession(*this);
+    }
+    else if (aState == kStateReady)
+    {
+        // trade the deadline of the handshake for the timeout of an established session
+        mServer.RefreshSession(*this);
+    }
 }
 
 void MbedtlsSession::SetDataHandler(DataHandler aDataHandler, void *aContext)
@@ -234,27 +367,67 @@ void MbedtlsSession::SetDataHandler(DataHandler aDataHandler, void *aContext)
 
 ssize_t MbedtlsSession::Write(const uint8_t *aBuffer, uint16_t aLength)
 {
-    int ret;
+    ssize_t ret = aLength;
 
-    do
+    if (mOutbound.empty())
     {
-        ret = mbedtls_ssl_write(&mSsl, aBuffer, aLength);
-    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+        int rval = mbedtls_ssl_write(&mSsl, aBuffer, aLength);
 
-    if (ret < 0)
+        VerifyOrExit(rval < 0, ret = rval);
+        VerifyOrExit(rval == MBEDTLS_ERR_SSL_WANT_READ || rval == MBEDTLS_ERR_SSL_WANT_WRITE, ret = rval,
+                     SetState(kStateError));
+
+        // mbedTLS keeps the record and expects the same message once the socket is writable
+        mServer.mCongestedSessions++;
+    }
+    else
     {
-        SetState(kStateError);
+        VerifyOrExit(mOutbound.size() < kMaxOutbound, errno = EAGAIN, ret = -1);
     }
 
+    mOutbound.push_back(std::vector<uint8_t>(aBuffer, aBuffer + aLength));
+
+exit:
     return ret;
 }
 
+void MbedtlsSession::Flush(void)
+{
+    while (!mOutbound.empty())
+    {
+        int rval = mbedtls_ssl_write(&mSsl, mOutbound.front().data(), mOutbound.front().size());
+
+        if (rval == MBEDTLS_ERR_SSL_WANT_READ || rval == MBEDTLS_ERR_SSL_WANT_WRITE)
+        {
+            break;
+        }
+
+        mOutbound.pop_front();
+
+        if (rval < 0)
+        {
+            otbrLog(OTBR_LOG_ERR, "DTLS write error: -0x%04x!", -rval);
+            mOutbound.clear();
+            SetState(kStateError);
+        }
+    }
+
+    if (mOutbound.empty())
+    {
+        mServer.mCongestedSessions--;
+    }
+}
+
 void MbedtlsSession::Close(void)
 {
     VerifyOrExit(mState != kStateError && mState != kStateEnd);
 
-    while (mbedtls_ssl_close_notify(&mSsl) == MBEDTLS_ERR_SSL_WANT_WRITE)
-        ;
+    // Best effort, as any other datagram the alert could be lost anyway.
+    if (mbedtls_ssl_close_notify(&mSsl) == MBEDTLS_ERR_SSL_WANT_WRITE)
+    {
+        otbrLog(OTBR_LOG_WARNING, "DTLS close notify not sent, socket busy.");
+    }
+
     SetState(kStateEnd);
 
 exit:
@@ -263,33 +436,61 @@ exit:
 
 MbedtlsSession::~MbedtlsSession(void)
 {
-    Close();
-    // In case session socket is not actually created.
-    if (mNet.fd != mServer.mSocket)
+    // a handshake cut short, e.g. expired or evicted, still ends its span
+    if (mState == kStateHandshaking)
     {
-        mbedtls_net_free(&mNet);
+        otbrTraceEnd("dtls", "handshake", reinterpret_cast<uintptr_t>(this));
     }
+
+    Close();
     mbedtls_ssl_free(&mSsl);
     otbrLog(OTBR_LOG_INFO, "DTLS session destroyed: %d.", mState);
 }
 
-void MbedtlsSession::Process(void)
+void MbedtlsSession::Process(const uint8_t *aBuffer, uint16_t aLength)
 {
-    mExpiration = GetNow() + kSessionTimeout;
+    if (mIsOffloaded)
+    {
+        // a handshake worker owns the session, the datagram waits until it is given back
+        VerifyOrExit(mBacklog.size() < kMaxBacklog, otbrLog(OTBR_LOG_WARNING, "DTLS handshake backlog full!"));
+        mBacklog.push_back(std::vector<uint8_t>(aBuffer, aBuffer + aLength));
+        ExitNow();
+    }
 
     switch (mState)
     {
     case kStateHandshaking:
-        Handshake();
+        Handshake(aBuffer, aLength);
         break;
 
     case kStateReady:
-        Read();
+        // a datagram may carry more than one record, mbedTLS gets them one by one so that the sequence number of
+        // the record read is known
+        while (aLength > 0 && mState == kStateReady)
+        {
+            uint16_t length = ParseRecord(aBuffer, aLength, mReceivedSequence);
+
+            mReceived       = aBuffer;
+            mReceivedLength = length;
+
+            while (Read() > 0)
+            {
+            }
+
+            aBuffer += length;
+            aLength = static_cast<uint16_t>(aLength - length);
+        }
+
+        // the datagram is only valid during this call
+        mReceived = NULL;
         break;
 
     default:
         break;
     }
+
+exit:
+    return;
 }
 
 int MbedtlsSession::Read(void)
@@ -299,8 +500,23 @@ int MbedtlsSession::Read(void)
 
     ret = mbedtls_ssl_read(&mSsl, buffer, sizeof(buffer));
 
+    // the handler borrows the record, e.g. CoAP parses it in place
     if (ret > 0)
     {
+        // Only an authenticated record newer than any before moves the session, a delayed one of the old path
+        // must not move it back, RFC 9146 section 6.
+        if (mRoamingRemoteSock != NULL && mReceivedSequence > mLastSequence)
+        {
+            mServer.MoveSession(*this, *mRoamingRemoteSock, *mRoamingLocalSock);
+            mRoamingRemoteSock = NULL;
+            mRoamingLocalSock  = NULL;
+        }
+
+        if (mReceivedSequence > mLastSequence)
+        {
+            mLastSequence = mReceivedSequence;
+        }
+
         mDataHandler(buffer, (uint16_t)ret, mContext);
     }
 
@@ -320,6 +536,7 @@ int MbedtlsSession::Read(void)
 
         case MBEDTLS_ERR_SSL_CLIENT_RECONNECT:
             otbrLog(OTBR_LOG_WARNING, "DTLS session reconnecting.");
+            otbrTraceBegin("dtls", "handshake", reinterpret_cast<uintptr_t>(this));
             SetState(kStateHandshaking);
             break;
 
@@ -341,6 +558,34 @@ int MbedtlsSession::Read(void)
     return ret;
 } // namespace Dtls
 
+uint16_t MbedtlsSession::ParseRecord(const uint8_t *aBuffer, uint16_t aLength, uint64_t &aSequence)
+{
+    uint16_t headerSize = MbedtlsServer::kSizeOfRecordHeader;
+    uint16_t length     = aLength;
+
+    aSequence = 0;
+
+    // a record carrying a connection ID has it between the sequence number and the length
+    if (aBuffer[0] == MbedtlsServer::kContentTypeCid)
+    {
+        headerSize = static_cast<uint16_t>(headerSize + kCidLength);
+    }
+
+    // mbedTLS drops what is left of a malformed datagram
+    VerifyOrExit(aLength >= headerSize);
+
+    for (size_t i = MbedtlsServer::kOffsetOfSequence; i < MbedtlsServer::kOffsetOfCid; i++)
+    {
+        aSequence = (aSequence << 8) | aBuffer[i];
+    }
+
+    length = static_cast<uint16_t>(headerSize + ((aBuffer[headerSize - 2] << 8) | aBuffer[headerSize - 1]));
+    length = std::min(length, aLength);
+
+exit:
+    return length;
+}
+
 int MbedtlsSession::ExportKeys(void *               aContext,
                                const unsigned char *aMasterSecret,
                                const unsigned char *aKeyBlock,
@@ -360,14 +605,22 @@ int MbedtlsSession::ExportKeys(void *               aContext,
 }
 
 MbedtlsSession::MbedtlsSession(MbedtlsServer &            aServer,
-                               const mbedtls_net_context &aNet,
                                const struct sockaddr_in6 &aRemoteSock,
                                const sockaddr_in6 &       aLocalSock)
-    : mNet(aNet)
-    , mRemoteSock(aRemoteSock)
+    : mRemoteSock(aRemoteSock)
     , mLocalSock(aLocalSock)
     , mServer(aServer)
     , mIsTimerSet(false)
+    , mReceived(NULL)
+    , mReceivedLength(0)
+    , mExpiryPrev(NULL)
+    , mExpiryNext(NULL)
+    , mIsOffloaded(false)
+    , mHandshakeResult(0)
+    , mRoamingRemoteSock(NULL)
+    , mRoamingLocalSock(NULL)
+    , mReceivedSequence(0)
+    , mLastSequence(0)
 {
 }
 
@@ -427,8 +680,12 @@ otbrError MbedtlsSession::Init(void)
     otbrError error = OTBR_ERROR_NONE;
     int       rval  = 0;
 
+    // The copy shares everything the server config points to and must not be freed on its own.
+    mConf = mServer.mConf;
+    mbedtls_ssl_conf_export_keys_cb(&mConf, ExportKeys, this);
+
     mbedtls_ssl_init(&mSsl);
-    SuccessOrExit(rval = mbedtls_ssl_setup(&mSsl, &mServer.mConf));
+    SuccessOrExit(rval = mbedtls_ssl_setup(&mSsl, &mConf));
 
     mbedtls_ssl_set_timer_cb(&mSsl, this, SetDelay, GetDelay);
 
@@ -438,7 +695,18 @@ otbrError MbedtlsSession::Init(void)
                       &mSsl, reinterpret_cast<const unsigned char *>(&mRemoteSock), sizeof(mRemoteSock)));
     mbedtls_ssl_set_bio(&mSsl, this, SendMbedtls, ReadMbedtls, NULL);
 
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    // The peer puts this ID in its records, so they still reach this session after its address changed.
+    do
+    {
+        SuccessOrExit(rval = MbedtlsServer::Random(&mServer, mCid, sizeof(mCid)));
+    } while (mServer.FindSessionByCid(mCid) != NULL);
+
+    SuccessOrExit(rval = mbedtls_ssl_set_cid(&mSsl, MBEDTLS_SSL_CID_ENABLED, mCid, sizeof(mCid)));
+#endif
+
     mState = kStateHandshaking;
+    otbrTraceBegin("dtls", "handshake", reinterpret_cast<uintptr_t>(this));
 
 exit:
     if (rval)
@@ -452,62 +720,263 @@ exit:
 
 int MbedtlsSession::ReadMbedtls(unsigned char *aBuffer, size_t aLength)
 {
-    return mbedtls_net_recv(&mNet, aBuffer, aLength);
+    int ret = MBEDTLS_ERR_SSL_WANT_READ;
+
+    VerifyOrExit(mReceived != NULL);
+
+    // like recv(), a datagram larger than the buffer is truncated
+    ret = static_cast<int>(std::min(aLength, static_cast<size_t>(mReceivedLength)));
+    memcpy(aBuffer, mReceived, static_cast<size_t>(ret));
+    mReceived = NULL;
+
+exit:
+    return ret;
 }
 
 int MbedtlsSession::SendMbedtls(const unsigned char *aBuffer, size_t aLength)
 {
-    int  opt = 1;
-    int &fd  = mNet.fd;
-    int  ret = 0;
+    return mServer.SendTo(aBuffer, aLength, mRemoteSock, mLocalSock);
+}
+
+void MbedtlsSession::Handshake(const uint8_t *aBuffer, uint16_t aLength)
+{
+    VerifyOrExit(mState == kStateHandshaking, otbrLog(OTBR_LOG_ERR, "Invalid DTLS session state!"));
 
-    VerifyOrExit((fd = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP)) != -1, ret = -1);
-    SuccessOrExit(ret = setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)));
-    SuccessOrExit(ret = bind(fd, reinterpret_cast<const struct sockaddr *>(&mLocalSock), sizeof(mLocalSock)));
-    SuccessOrExit(ret = connect(fd, reinterpret_cast<const struct sockaddr *>(&mRemoteSock), sizeof(mRemoteSock)));
-    SuccessOrExit(ret = mbedtls_net_set_nonblock(&mNet));
-    mbedtls_ssl_set_bio(&mSsl, &mNet, mbedtls_net_send, mbedtls_net_recv, NULL);
-    VerifyOrExit((ret = mbedtls_net_send(&mNet, aBuffer, aLength)) != -1);
+    otbrLog(OTBR_LOG_INFO, "DTLS handshaking...");
+
+    if (mServer.mHandshakePool.IsEnabled())
+    {
+        // The worker reads the datagram after the caller's buffer is gone.
+        mHandshakeInput.assign(aBuffer, aBuffer + aLength);
+        mReceived       = mHandshakeInput.data();
+        mReceivedLength = aLength;
+        mIsOffloaded    = true;
+        mServer.mHandshakePool.Submit(*this);
+    }
+    else
+    {
+        mReceived       = aBuffer;
+        mReceivedLength = aLength;
+        HandleHandshake(RunHandshake());
+    }
 
 exit:
+    return;
+}
+
+int MbedtlsSession::RunHandshake(void)
+{
+    TraceScope trace("dtls", "handshake-step", reinterpret_cast<uintptr_t>(this));
+    int        ret = mbedtls_ssl_handshake(&mSsl);
+
+    mReceived = NULL;
+
     return ret;
 }
 
-int MbedtlsSession::Handshake(void)
+void MbedtlsSession::HandleHandshake(int aResult)
 {
-    int ret = 0;
+    if (aResult == 0)
+    {
+        otbrLog(OTBR_LOG_INFO, "DTLS session ready.");
+        otbrTraceEnd("dtls", "handshake", reinterpret_cast<uintptr_t>(this));
 
-    VerifyOrExit(mState == kStateHandshaking, otbrLog(OTBR_LOG_ERR, "Invalid DTLS session state!"));
+        SetState(kStateReady);
+    }
+    else if (aResult == MBEDTLS_ERR_SSL_WANT_READ || aResult == MBEDTLS_ERR_SSL_WANT_WRITE)
+    {
+        otbrLog(OTBR_LOG_INFO, "DTLS handshake pending: -0x%04x.", -aResult);
+    }
+    else
+    {
+        otbrLog(OTBR_LOG_ERR, "DTLS handshake failed: -0x%04x!", -aResult);
+        if (aResult != MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED)
+        {
+            mbedtls_ssl_send_alert_message(&mSsl, MBEDTLS_SSL_ALERT_LEVEL_FATAL,
+                                           MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE);
+        }
+        mState = kStateError;
+        otbrTraceEnd("dtls", "handshake", reinterpret_cast<uintptr_t>(this));
+    }
+}
 
-    otbrLog(OTBR_LOG_INFO, "DTLS handshaking...");
+void MbedtlsSession::FinishHandshake(void)
+{
+    mIsOffloaded = false;
+    HandleHandshake(mHandshakeResult);
+
+    // Replay what arrived meanwhile, until the session is handed to a worker again.
+    while (!mIsOffloaded && !mBacklog.empty())
+    {
+        std::vector<uint8_t> datagram;
+
+        datagram.swap(mBacklog.front());
+        mBacklog.pop_front();
+        Process(datagram.data(), static_cast<uint16_t>(datagram.size()));
+    }
+}
+
+size_t MbedtlsSession::EstimateMemory(bool aIsHandshaking)
+{
+    size_t estimate = sizeof(MbedtlsSession) + 2 * (MBEDTLS_SSL_MAX_CONTENT_LEN + kRecordOverhead) + kTransformOverhead;
+
+    if (aIsHandshaking)
+    {
+        estimate += kHandshakeOverhead;
+    }
+
+    return estimate;
+}
+
+size_t MbedtlsSession::GetMemoryEstimate(void) const
+{
+    size_t estimate = EstimateMemory(mState == kStateHandshaking) + mHandshakeInput.capacity();
+
+    for (std::deque<std::vector<uint8_t>>::const_iterator it = mBacklog.begin(); it != mBacklog.end(); ++it)
+    {
+        estimate += it->capacity();
+    }
+
+    for (std::deque<std::vector<uint8_t>>::const_iterator it = mOutbound.begin(); it != mOutbound.end(); ++it)
+    {
+        estimate += it->capacity();
+    }
+
+    return estimate;
+}
+
+HandshakePool::HandshakePool(void)
+    : mIsStopping(false)
+{
+    mPipe[0] = -1;
+    mPipe[1] = -1;
+}
 
-    SuccessOrExit(ret = mbedtls_ssl_handshake(&mSsl));
+HandshakePool::~HandshakePool(void)
+{
+    Stop();
+}
 
-    otbrLog(OTBR_LOG_INFO, "DTLS session ready.");
+otbrError HandshakePool::Start(size_t aThreads)
+{
+    otbrError ret = OTBR_ERROR_ERRNO;
 
-    SetState(kStateReady);
+    VerifyOrExit(aThreads > 0, ret = OTBR_ERROR_NONE);
+    VerifyOrExit(pipe(mPipe) == 0);
+
+    // a self-pipe rather than eventfd, which is Linux only
+    for (size_t i = 0; i < sizeof(mPipe) / sizeof(mPipe[0]); ++i)
+    {
+        VerifyOrExit(fcntl(mPipe[i], F_SETFL, fcntl(mPipe[i], F_GETFL) | O_NONBLOCK) == 0, Stop());
+        VerifyOrExit(fcntl(mPipe[i], F_SETFD, fcntl(mPipe[i], F_GETFD) | FD_CLOEXEC) == 0, Stop());
+    }
+
+    mIsStopping = false;
+
+    for (size_t i = 0; i < aThreads; ++i)
+    {
+        mThreads.push_back(std::thread(&HandshakePool::Run, this));
+    }
+
+    otbrLog(OTBR_LOG_INFO, "DTLS handshakes run on %zu threads.", aThreads);
+    ret = OTBR_ERROR_NONE;
 
 exit:
+    return ret;
+}
 
-    if (ret)
+void HandshakePool::Stop(void)
+{
     {
-        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mIsStopping = true;
+    }
+
+    mCondition.notify_all();
+
+    for (std::vector<std::thread>::iterator it = mThreads.begin(); it != mThreads.end(); ++it)
+    {
+        it->join();
+    }
+
+    mThreads.clear();
+
+    for (size_t i = 0; i < sizeof(mPipe) / sizeof(mPipe[0]); ++i)
+    {
+        if (mPipe[i] != -1)
         {
-            otbrLog(OTBR_LOG_INFO, "DTLS handshake pending: -0x%04x.", -ret);
+            close(mPipe[i]);
+            mPipe[i] = -1;
         }
-        else
+    }
+}
+
+void HandshakePool::Submit(MbedtlsSession &aSession)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mPending.push_back(&aSession);
+    }
+
+    mCondition.notify_one();
+}
+
+void HandshakePool::Collect(std::deque<MbedtlsSession *> &aFinished)
+{
+    uint8_t buffer[16];
+    ssize_t rval;
+
+    // only clears the readiness, the queue tells which sessions are done
+    while ((rval = read(mPipe[0], buffer, sizeof(buffer))) > 0)
+    {
+    }
+
+    if (rval < 0 && errno != EAGAIN)
+    {
+        otbrLog(OTBR_LOG_WARNING, "DTLS failed to read handshake event: %s.", strerror(errno));
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    aFinished.insert(aFinished.end(), mFinished.begin(), mFinished.end());
+    mFinished.clear();
+}
+
+void HandshakePool::Run(void)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (true)
+    {
+        MbedtlsSession *session;
+        uint8_t         one = 1;
+        ssize_t         rval;
+
+        while (!mIsStopping && mPending.empty())
         {
-            otbrLog(OTBR_LOG_ERR, "DTLS handshake failed: -0x%04x!", -ret);
-            if (ret != MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED)
-            {
-                mbedtls_ssl_send_alert_message(&mSsl, MBEDTLS_SSL_ALERT_LEVEL_FATAL,
-                                               MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE);
-            }
-            mState = kStateError;
+            mCondition.wait(lock);
         }
-    }
 
-    return ret;
+        if (mIsStopping)
+        {
+            break;
+        }
+
+        session = mPending.front();
+        mPending.pop_front();
+
+        lock.unlock();
+        session->mHandshakeResult = session->RunHandshake();
+        lock.lock();
+
+        mFinished.push_back(session);
+
+        // this only fails when the pipe is full, and it is readable then anyway
+        rval = write(mPipe[1], &one, sizeof(one));
+        (void)rval;
+    }
 }
 
 void MbedtlsServer::UpdateFdSet(fd_set & aReadFdSet,
@@ -519,46 +988,41 @@ void MbedtlsServer::UpdateFdSet(fd_set & aReadFdSet,
     unsigned long now     = GetNow();
     unsigned long timeout = GetTimestamp(aTimeout);
 
-    for (SessionSet::iterator it = mSessions.begin(); it != mSessions.end();)
+    // Sessions are ordered by expiration, and retired ones are moved to the front.
+    while (mExpiryHead != NULL)
     {
-        MbedtlsSession *session = *it;
+        MbedtlsSession *session = mExpiryHead;
 
-        if (session->GetExpiration() <= now)
+        if (session->IsActive() && session->GetExpiration() > now)
         {
-            otbrLog(OTBR_LOG_INFO, "DTLS session timeout!");
-            HandleSessionState(*session, Session::kStateExpired);
-            delete session;
-            it = mSessions.erase(it);
-        }
-        else if (session->GetState() == Session::kStateReady || session->GetState() == Session::kStateHandshaking)
-        {
-            int fd = session->GetFd();
-
-            otbrLog(OTBR_LOG_INFO, "DTLS session[%d] alive.", fd);
-            FD_SET(fd, &aReadFdSet);
-
-            if (aMaxFd < fd)
-            {
-                aMaxFd = fd;
-            }
-
             if (static_cast<long>(session->GetExpiration() - (now + timeout)) < 0)
             {
                 timeout = static_cast<unsigned long>(session->GetExpiration() - now);
             }
 
-            // TODO error set
-            ++it;
+            break;
         }
-        else
+
+        if (session->mIsOffloaded)
         {
-            delete session;
-            it = mSessions.erase(it);
+            // never freed under a worker, its handshake step just counts as activity
+            RefreshSession(*session);
+            continue;
         }
+
+        if (session->IsActive())
+        {
+            otbrLog(OTBR_LOG_INFO, "DTLS session timeout!");
+            HandleSessionState(*session, Session::kStateExpired);
+        }
+
+        RemoveSession(*session);
+        delete session;
     }
 
     if (mSocket >= 0)
     {
+        // every session is demultiplexed from this one descriptor
         FD_SET(mSocket, &aReadFdSet);
 
         if (aMaxFd < mSocket)
@@ -567,10 +1031,29 @@ void MbedtlsServer::UpdateFdSet(fd_set & aReadFdSet,
         }
     }
 
+    if (mSocket >= 0 && mCongestedSessions > 0)
+    {
+        FD_SET(mSocket, &aWriteFdSet);
+
+        if (aMaxFd < mSocket)
+        {
+            aMaxFd = mSocket;
+        }
+    }
+
+    if (mHandshakePool.GetEventFd() >= 0)
+    {
+        FD_SET(mHandshakePool.GetEventFd(), &aReadFdSet);
+
+        if (aMaxFd < mHandshakePool.GetEventFd())
+        {
+            aMaxFd = mHandshakePool.GetEventFd();
+        }
+    }
+
     aTimeout.tv_sec  = timeout / 1000;
     aTimeout.tv_usec = (timeout % 1000) * 1000;
 
-    (void)aWriteFdSet;
     (void)aErrorFdSet;
 }
 
@@ -587,99 +1070,567 @@ void MbedtlsServer::ProcessServer(const fd_set &aReadFdSet, const fd_set &aWrite
 {
     uint8_t       packet[kMaxSizeOfPacket];
     uint8_t       control[kMaxSizeOfControl];
-    otbrError     error = OTBR_ERROR_ERRNO; // Assume error
     sockaddr_in6  src;
     sockaddr_in6  dst;
     struct msghdr msghdr;
     struct iovec  iov[1];
 
     /* Connection is not alive yet, or is shut down */
-    VerifyOrExit(mSocket >= 0, error = OTBR_ERROR_NONE);
+    VerifyOrExit(mSocket >= 0);
 
     /* If this is not set, then some other handle became rd/wr able, it is not an error */
-    VerifyOrExit(FD_ISSET(mSocket, &aReadFdSet), error = OTBR_ERROR_NONE);
+    VerifyOrExit(FD_ISSET(mSocket, &aReadFdSet));
 
-    otbrLog(OTBR_LOG_INFO, "Trying to accept connection...");
-    memset(&src, 0, sizeof(src));
-    memset(&dst, 0, sizeof(dst));
-    memset(&msghdr, 0, sizeof(msghdr));
-    msghdr.msg_name    = &src;
-    msghdr.msg_namelen = sizeof(src);
-    memset(&iov, 0, sizeof(iov));
-    iov[0].iov_base       = packet;
-    iov[0].iov_len        = kMaxSizeOfPacket;
-    msghdr.msg_iov        = iov;
-    msghdr.msg_iovlen     = 1;
-    msghdr.msg_control    = control;
-    msghdr.msg_controllen = sizeof(control);
+    // Bounded so that a flood on the server socket cannot starve the rest of the main loop.
+    for (int i = 0; i < kMaxDatagramsPerProcess; ++i)
+    {
+        ssize_t length;
+
+        memset(&src, 0, sizeof(src));
+        memset(&dst, 0, sizeof(dst));
+        memset(&msghdr, 0, sizeof(msghdr));
+        msghdr.msg_name    = &src;
+        msghdr.msg_namelen = sizeof(src);
+        memset(&iov, 0, sizeof(iov));
+        iov[0].iov_base       = packet;
+        iov[0].iov_len        = kMaxSizeOfPacket;
+        msghdr.msg_iov        = iov;
+        msghdr.msg_iovlen     = 1;
+        msghdr.msg_control    = control;
+        msghdr.msg_controllen = sizeof(control);
+
+        length = recvmsg(mSocket, &msghdr, 0);
+
+        if (length < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                otbrLog(OTBR_LOG_WARNING, "DTLS failed to receive: %s.", strerror(errno));
+            }
+
+            break;
+        }
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msghdr); cmsg != NULL; cmsg = CMSG_NXTHDR(&msghdr, cmsg))
+        {
+            if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO)
+            {
+                const struct in6_pktinfo *pktinfo = reinterpret_cast<const struct in6_pktinfo *>(CMSG_DATA(cmsg));
+                memcpy(dst.sin6_addr.s6_addr, pktinfo->ipi6_addr.s6_addr, sizeof(dst.sin6_addr));
+                dst.sin6_family   = AF_INET6;
+                dst.sin6_port     = htons(mPort);
+                dst.sin6_scope_id = pktinfo->ipi6_ifindex;
+                break;
+            }
+        }
+
+        if (length == 0 || memcmp(dst.sin6_addr.s6_addr, in6addr_any.s6_addr, sizeof(dst.sin6_addr)) == 0)
+        {
+            otbrLog(OTBR_LOG_WARNING, "DTLS dropped datagram without destination address.");
+            continue;
+        }
+
+        HandleDatagram(packet, static_cast<uint16_t>(length), src, dst);
+    }
 
-    VerifyOrExit(recvmsg(mSocket, &msghdr, MSG_PEEK) > 0);
+exit:
+    (void)aWriteFdSet;
+    (void)aErrorFdSet;
+}
 
-    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msghdr); cmsg != NULL; cmsg = CMSG_NXTHDR(&msghdr, cmsg))
+void MbedtlsServer::HandleDatagram(const uint8_t *     aBuffer,
+                                   uint16_t            aLength,
+                                   const sockaddr_in6 &aSrc,
+                                   const sockaddr_in6 &aDst)
+{
+    MbedtlsSession *session = mSessions.Find(aSrc);
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    // A record of an unknown address may come from a peer that moved, e.g. after a NAT rebinding.
+    if ((session == NULL || !session->IsActive()) && aLength > kOffsetOfCid + MbedtlsSession::kCidLength &&
+        aBuffer[0] == kContentTypeCid)
     {
-        if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO)
+        session = FindSessionByCid(aBuffer + kOffsetOfCid);
+        VerifyOrExit(session != NULL && session->mState == Session::kStateReady && !session->mIsOffloaded,
+                     session = NULL);
+
+        session->mRoamingRemoteSock = &aSrc;
+        session->mRoamingLocalSock  = &aDst;
+        ExitNow();
+    }
+#endif
+
+    // Retransmitted ClientHellos and later records of a live session go to that session.
+    if (session == NULL || !session->IsActive())
+    {
+        // Nothing is allocated for a peer until it proves it receives at its source address.
+        VerifyOrExit(ExchangeCookie(aBuffer, aLength, aSrc, aDst), session = NULL);
+
+        if (session != NULL)
         {
-            const struct in6_pktinfo *pktinfo = reinterpret_cast<const struct in6_pktinfo *>(CMSG_DATA(cmsg));
-            memcpy(dst.sin6_addr.s6_addr, pktinfo->ipi6_addr.s6_addr, sizeof(dst.sin6_addr));
-            dst.sin6_family = AF_INET6;
-            dst.sin6_port   = ntohs(mPort);
-            break;
+            // The peer is starting over after its previous session ended.
+            RemoveSession(*session);
+            delete session;
         }
+
+        VerifyOrExit(AdmitSession(), session = NULL);
+
+        otbrLog(OTBR_LOG_INFO, "DTLS new session, %zu active.", mSessions.GetSize());
+        session = new MbedtlsSession(*this, aSrc, aDst);
+
+        VerifyOrExit(session->Init() == OTBR_ERROR_NONE, otbrLog(OTBR_LOG_ERR, "DTLS failed to initiate new session!"),
+                     delete session, session = NULL);
+
+        AddSession(*session);
+    }
+
+exit:
+    if (session != NULL)
+    {
+        RefreshSession(*session);
+        session->Process(aBuffer, aLength);
+
+        // the addresses are only valid during this call
+        session->mRoamingRemoteSock = NULL;
+        session->mRoamingLocalSock  = NULL;
+
+        // a failed handshake does not go through SetState()
+        if (!session->IsActive())
+        {
+            RetireSession(*session);
+        }
+    }
+}
+
+bool MbedtlsServer::AdmitSession(void)
+{
+    size_t          handshakes = 0;
+    size_t          memory     = 0;
+    bool            isAdmitted = false;
+    MbedtlsSession *halfOpen   = NULL;
+
+    for (MbedtlsSession *session = mExpiryHead; session != NULL; session = session->mExpiryNext)
+    {
+        if (session->GetState() == Session::kStateHandshaking)
+        {
+            ++handshakes;
+
+            // handshakes share one timeout, so the first one found has been silent the longest
+            if (halfOpen == NULL && !session->mIsOffloaded)
+            {
+                halfOpen = session;
+            }
+        }
+
+        memory += session->GetMemoryEstimate();
+    }
+
+    // A handshake whose peer missed its first retransmission is likely abandoned, and gives way to a new one.
+    if (handshakes >= kMaxHandshakes && halfOpen != NULL &&
+        static_cast<long>(GetNow() + MbedtlsSession::kHandshakeTimeout - halfOpen->mExpiration) >=
+            MbedtlsSession::kHandshakeInterval)
+    {
+        otbrLog(OTBR_LOG_INFO, "DTLS evicting half-open session.");
+        HandleSessionState(*halfOpen, Session::kStateExpired);
+        memory -= halfOpen->GetMemoryEstimate();
+        RemoveSession(*halfOpen);
+        delete halfOpen;
+        --handshakes;
+    }
+
+    // Other handshakes in progress are completed before new ones are started, the peer retransmits its ClientHello.
+    VerifyOrExit(handshakes < kMaxHandshakes,
+                 otbrLogRateLimited(OTBR_LOG_WARNING, "DTLS refused session, %zu handshakes in progress.", handshakes));
+
+    while (mSessions.GetSize() >= kMaxSessions || memory + MbedtlsSession::EstimateMemory(true) > kMemoryBudget)
+    {
+        MbedtlsSession *victim = mExpiryHead;
+
+        // The expiry list is ordered by last activity, its first established session is the least recently used.
+        while (victim != NULL && victim->IsActive() &&
+               (victim->GetState() != Session::kStateReady || victim->mIsOffloaded))
+        {
+            victim = victim->mExpiryNext;
+        }
+
+        VerifyOrExit(victim != NULL,
+                     otbrLogRateLimited(OTBR_LOG_WARNING, "DTLS refused session, no established session to evict."));
+
+        if (victim->IsActive())
+        {
+            otbrLog(OTBR_LOG_INFO, "DTLS evicting least recently used session.");
+            HandleSessionState(*victim, Session::kStateExpired);
+        }
+
+        memory -= victim->GetMemoryEstimate();
+        RemoveSession(*victim);
+        delete victim;
     }
 
-    VerifyOrExit(memcmp(dst.sin6_addr.s6_addr, in6addr_any.s6_addr, sizeof(dst.sin6_addr)) != 0, errno = EDESTADDRREQ);
+    isAdmitted = true;
 
-    // TODO Should check if this client has an existing session.
+exit:
+    return isAdmitted;
+}
+
+bool MbedtlsServer::ExchangeCookie(const uint8_t *     aBuffer,
+                                   uint16_t            aLength,
+                                   const sockaddr_in6 &aSrc,
+                                   const sockaddr_in6 &aDst)
+{
+    const uint8_t *cursor    = aBuffer + kSizeOfRecordHeader + kSizeOfHandshakeHeader;
+    const uint8_t *end       = aBuffer + aLength;
+    bool           isValid   = false;
+    uint32_t       msgLength = 0;
+    uint8_t        cookieLength;
+
+    // Only an unfragmented ClientHello in a handshake record of epoch 0 may start a session.
+    VerifyOrExit(aLength >= kSizeOfRecordHeader + kSizeOfHandshakeHeader);
+    VerifyOrExit(aBuffer[0] == kContentTypeHandshake && aBuffer[3] == 0 && aBuffer[4] == 0);
+    VerifyOrExit(aBuffer[kSizeOfRecordHeader] == kHandshakeTypeClientHello);
+
+    msgLength = (static_cast<uint32_t>(aBuffer[14]) << 16) | (static_cast<uint32_t>(aBuffer[15]) << 8) | aBuffer[16];
+    VerifyOrExit(memcmp(&aBuffer[14], &aBuffer[22], 3) == 0 && aBuffer[19] == 0 && aBuffer[20] == 0 &&
+                 aBuffer[21] == 0);
+    VerifyOrExit(msgLength <= static_cast<uint32_t>(end - cursor));
+    end = cursor + msgLength;
+
+    // skip client_version, random and session_id
+    cursor += kSizeOfClientHelloFixedPart;
+    VerifyOrExit(cursor < end);
+    cursor += 1 + *cursor;
+    VerifyOrExit(cursor < end);
+
+    cookieLength = *cursor++;
+    VerifyOrExit(cookieLength <= end - cursor);
+
+    if (cookieLength != 0)
     {
-        mbedtls_net_context net = {mSocket};
+        const unsigned char *clientId = reinterpret_cast<const unsigned char *>(&aSrc);
 
-        MbedtlsSession *session = new MbedtlsSession(*this, net, src, dst);
+        VerifyOrExit(CheckCookie(this, cursor, cookieLength, clientId, sizeof(aSrc)) != 0, isValid = true);
+    }
+
+    SendHelloVerifyRequest(aBuffer, aSrc, aDst);
+
+exit:
+    return isValid;
+}
 
-        VerifyOrExit(session->Init() == OTBR_ERROR_NONE, delete session);
+void MbedtlsServer::SendHelloVerifyRequest(const uint8_t *     aClientHello,
+                                           const sockaddr_in6 &aSrc,
+                                           const sockaddr_in6 &aDst)
+{
+    uint8_t  packet[kSizeOfRecordHeader + kSizeOfHandshakeHeader + kSizeOfHelloVerifyFixedPart + kMaxSizeOfCookie];
+    uint8_t *cookie    = packet + kSizeOfRecordHeader + kSizeOfHandshakeHeader + kSizeOfHelloVerifyFixedPart;
+    uint8_t *cookieEnd = cookie;
+    uint8_t  cookieLength;
+    uint16_t msgLength;
+    int      ret;
+
+    // The cookie binds the same transport id as the session later checks against, see MbedtlsSession::Init().
+    SuccessOrExit(ret = WriteCookie(this, &cookieEnd, packet + sizeof(packet),
+                                    reinterpret_cast<const unsigned char *>(&aSrc), sizeof(aSrc)));
+
+    cookieLength = static_cast<uint8_t>(cookieEnd - cookie);
+    msgLength    = static_cast<uint16_t>(kSizeOfHelloVerifyFixedPart + cookieLength);
+
+    // Record header, reusing the epoch and sequence number of the ClientHello as RFC 6347 4.2.1 requires.
+    packet[0] = kContentTypeHandshake;
+    packet[1] = kDtlsVersionMajor;
+    packet[2] = kDtlsVersionMinor;
+    memcpy(&packet[3], &aClientHello[3], 8);
+    packet[11] = static_cast<uint8_t>((kSizeOfHandshakeHeader + msgLength) >> 8);
+    packet[12] = static_cast<uint8_t>(kSizeOfHandshakeHeader + msgLength);
+
+    // Handshake header, reusing the message_seq of the ClientHello, unfragmented.
+    packet[13] = kHandshakeTypeHelloVerifyRequest;
+    packet[14] = 0;
+    packet[15] = static_cast<uint8_t>(msgLength >> 8);
+    packet[16] = static_cast<uint8_t>(msgLength);
+    memcpy(&packet[17], &aClientHello[17], 2);
+    memset(&packet[19], 0, 3);
+    memcpy(&packet[22], &packet[14], 3);
+
+    // server_version and cookie
+    packet[25] = kDtlsVersionMajor;
+    packet[26] = kDtlsVersionMinor;
+    packet[27] = cookieLength;
+
+    ret = SendTo(packet, static_cast<size_t>(cookieEnd - packet), aSrc, aDst);
+    VerifyOrExit(ret >= 0);
+    ret = 0;
 
-        mSessions.push_back(session);
-        mbedtls_ssl_conf_export_keys_cb(&mConf, MbedtlsSession::ExportKeys, session);
-        session->Process();
+exit:
+    if (ret != 0)
+    {
+        otbrLog(OTBR_LOG_WARNING, "DTLS failed to send HelloVerifyRequest: -0x%04x!", -ret);
     }
+}
 
-    error = OTBR_ERROR_NONE;
+void MbedtlsServer::AddSession(MbedtlsSession &aSession)
+{
+    mSessions.Insert(aSession);
+    aSession.mExpiration = GetNow() + MbedtlsSession::kHandshakeTimeout;
+    LinkExpiry(aSession, false);
+}
+
+void MbedtlsServer::MoveSession(MbedtlsSession &    aSession,
+                                const sockaddr_in6 &aRemoteSock,
+                                const sockaddr_in6 &aLocalSock)
+{
+    MbedtlsSession *existing = mSessions.Find(aRemoteSock);
+
+    if (existing != NULL)
+    {
+        // A live session keeps its address, one record does not prove its peer is gone.
+        VerifyOrExit(!existing->IsActive(), otbrLog(OTBR_LOG_WARNING, "DTLS session not moved, port %u in use.",
+                                                   ntohs(aRemoteSock.sin6_port)));
+
+        // its owner was notified when it ended, it is only waiting to be freed
+        RemoveSession(*existing);
+        delete existing;
+    }
+
+    otbrLog(OTBR_LOG_INFO, "DTLS session moved to port %u.", ntohs(aRemoteSock.sin6_port));
+
+    mSessions.Remove(aSession);
+    aSession.mRemoteSock = aRemoteSock;
+    aSession.mLocalSock  = aLocalSock;
+    mSessions.Insert(aSession);
+
+    if (mbedtls_ssl_set_client_transport_id(&aSession.mSsl, reinterpret_cast<const unsigned char *>(&aRemoteSock),
+                                            sizeof(aRemoteSock)) != 0)
+    {
+        otbrLog(OTBR_LOG_WARNING, "DTLS failed to update transport id!");
+    }
 
 exit:
-    if (error)
+    return;
+}
+
+MbedtlsSession *MbedtlsServer::FindSessionByCid(const uint8_t *aCid) const
+{
+    MbedtlsSession *session = mExpiryHead;
+
+    // Only records of a peer that moved are routed this way, so a scan of the few sessions will do.
+    while (session != NULL && memcmp(session->mCid, aCid, sizeof(session->mCid)) != 0)
     {
-        otbrLog(OTBR_LOG_ERR, "DTLS failed to initiate new session: %s.", otbrErrorString(error));
-        otbrLog(OTBR_LOG_INFO, "Trying to create new server socket...");
-        close(mSocket);
-        mSocket = -1;
+        session = session->mExpiryNext;
+    }
+
+    return session;
+}
+
+void MbedtlsServer::RemoveSession(MbedtlsSession &aSession)
+{
+    mSessions.Remove(aSession);
+    UnlinkExpiry(aSession);
+
+    if (!aSession.mOutbound.empty())
+    {
+        aSession.mOutbound.clear();
+        mCongestedSessions--;
+    }
+}
+
+void MbedtlsServer::RefreshSession(MbedtlsSession &aSession)
+{
+    // A half-open handshake must not hold one of the few handshake slots for as long as an established session.
+    aSession.mExpiration = GetNow() + (aSession.GetState() == Session::kStateHandshaking
+                                           ? static_cast<unsigned long>(MbedtlsSession::kHandshakeTimeout)
+                                           : static_cast<unsigned long>(MbedtlsSession::kSessionTimeout));
+    UnlinkExpiry(aSession);
+    LinkExpiry(aSession, false);
+}
+
+void MbedtlsServer::RetireSession(MbedtlsSession &aSession)
+{
+    // Also called while a removed session is being destroyed.
+    VerifyOrExit(mSessions.Find(aSession.GetRemoteSock()) == &aSession);
+
+    UnlinkExpiry(aSession);
+    LinkExpiry(aSession, true);
 
-        if (Bind())
+exit:
+    return;
+}
+
+void MbedtlsServer::LinkExpiry(MbedtlsSession &aSession, bool aFront)
+{
+    if (aFront)
+    {
+        aSession.mExpiryPrev = NULL;
+        aSession.mExpiryNext = mExpiryHead;
+        (mExpiryHead != NULL ? mExpiryHead->mExpiryPrev : mExpiryTail) = &aSession;
+        mExpiryHead = &aSession;
+    }
+    else
+    {
+        MbedtlsSession *prev = mExpiryTail;
+
+        // Only a handshake expires before sessions refreshed earlier, so this passes a few established ones at most.
+        while (prev != NULL && prev->IsActive() && static_cast<long>(prev->mExpiration - aSession.mExpiration) > 0)
         {
-            otbrLog(OTBR_LOG_ERR, "Unable create new server socket! Die now!");
-            abort();
+            prev = prev->mExpiryPrev;
         }
+
+        aSession.mExpiryPrev = prev;
+        aSession.mExpiryNext = (prev != NULL ? prev->mExpiryNext : mExpiryHead);
+        (prev != NULL ? prev->mExpiryNext : mExpiryHead) = &aSession;
+        (aSession.mExpiryNext != NULL ? aSession.mExpiryNext->mExpiryPrev : mExpiryTail) = &aSession;
     }
+}
 
-    (void)aWriteFdSet;
-    (void)aErrorFdSet;
+void MbedtlsServer::UnlinkExpiry(MbedtlsSession &aSession)
+{
+    (aSession.mExpiryPrev != NULL ? aSession.mExpiryPrev->mExpiryNext : mExpiryHead) = aSession.mExpiryNext;
+    (aSession.mExpiryNext != NULL ? aSession.mExpiryNext->mExpiryPrev : mExpiryTail) = aSession.mExpiryPrev;
+    aSession.mExpiryPrev = NULL;
+    aSession.mExpiryNext = NULL;
 }
 
-void MbedtlsServer::Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet, const fd_set &aErrorFdSet)
+int MbedtlsServer::SendTo(const unsigned char *aBuffer,
+                          size_t               aLength,
+                          const sockaddr_in6 & aRemote,
+                          const sockaddr_in6 & aLocal)
 {
-    for (SessionSet::iterator it = mSessions.begin(); it != mSessions.end(); ++it)
+    uint8_t             control[CMSG_SPACE(sizeof(struct in6_pktinfo))];
+    struct msghdr       msghdr;
+    struct iovec        iov[1];
+    struct cmsghdr *    cmsg;
+    struct in6_pktinfo *pktinfo;
+    ssize_t             ret;
+
+    memset(&msghdr, 0, sizeof(msghdr));
+    memset(control, 0, sizeof(control));
+    iov[0].iov_base       = const_cast<unsigned char *>(aBuffer);
+    iov[0].iov_len        = aLength;
+    msghdr.msg_name       = const_cast<sockaddr_in6 *>(&aRemote);
+    msghdr.msg_namelen    = sizeof(aRemote);
+    msghdr.msg_iov        = iov;
+    msghdr.msg_iovlen     = 1;
+    msghdr.msg_control    = control;
+    msghdr.msg_controllen = sizeof(control);
+
+    // Reply from the address the peer contacted, as a connected socket bound to it used to.
+    cmsg             = CMSG_FIRSTHDR(&msghdr);
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type  = IPV6_PKTINFO;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(struct in6_pktinfo));
+    pktinfo          = reinterpret_cast<struct in6_pktinfo *>(CMSG_DATA(cmsg));
+    memcpy(&pktinfo->ipi6_addr, &aLocal.sin6_addr, sizeof(pktinfo->ipi6_addr));
+    pktinfo->ipi6_ifindex = aLocal.sin6_scope_id;
+
+    ret = sendmsg(mSocket, &msghdr, 0);
+
+    if (ret < 0)
     {
-        MbedtlsSession *session = *it;
-        int             fd      = session->GetFd();
+        ret = (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? MBEDTLS_ERR_SSL_WANT_WRITE
+                                                                         : MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+    return static_cast<int>(ret);
+}
+
+void MbedtlsServer::FinishHandshakes(void)
+{
+    std::deque<MbedtlsSession *> finished;
 
-        if (FD_ISSET(fd, &aReadFdSet))
+    mHandshakePool.Collect(finished);
+
+    for (std::deque<MbedtlsSession *>::iterator it = finished.begin(); it != finished.end(); ++it)
+    {
+        MbedtlsSession &session = **it;
+
+        session.FinishHandshake();
+
+        if (!session.IsActive())
         {
-            otbrLog(OTBR_LOG_INFO, "DTLS session [%d] become readable.", fd);
-            session->Process();
+            RetireSession(session);
         }
     }
+}
+
+int MbedtlsServer::Random(void *aContext, unsigned char *aBuffer, size_t aLength)
+{
+    MbedtlsServer &             server = *static_cast<MbedtlsServer *>(aContext);
+    std::lock_guard<std::mutex> lock(server.mSharedMutex);
+
+    return mbedtls_ctr_drbg_random(&server.mCtrDrbg, aBuffer, aLength);
+}
+
+int MbedtlsServer::WriteCookie(void *               aContext,
+                               unsigned char **     aCursor,
+                               unsigned char *      aEnd,
+                               const unsigned char *aClientId,
+                               size_t               aClientIdLength)
+{
+    MbedtlsServer &             server = *static_cast<MbedtlsServer *>(aContext);
+    std::lock_guard<std::mutex> lock(server.mSharedMutex);
+
+    return mbedtls_ssl_cookie_write(&server.mCookie, aCursor, aEnd, aClientId, aClientIdLength);
+}
+
+int MbedtlsServer::CheckCookie(void *               aContext,
+                               const unsigned char *aCookie,
+                               size_t               aCookieLength,
+                               const unsigned char *aClientId,
+                               size_t               aClientIdLength)
+{
+    MbedtlsServer &             server = *static_cast<MbedtlsServer *>(aContext);
+    std::lock_guard<std::mutex> lock(server.mSharedMutex);
+
+    return mbedtls_ssl_cookie_check(&server.mCookie, aCookie, aCookieLength, aClientId, aClientIdLength);
+}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+int MbedtlsServer::GetCachedSession(void *aContext, mbedtls_ssl_session *aSession)
+{
+    MbedtlsServer &             server = *static_cast<MbedtlsServer *>(aContext);
+    std::lock_guard<std::mutex> lock(server.mSharedMutex);
+
+    return mbedtls_ssl_cache_get(&server.mCache, aSession);
+}
+
+int MbedtlsServer::SetCachedSession(void *aContext, const mbedtls_ssl_session *aSession)
+{
+    MbedtlsServer &             server = *static_cast<MbedtlsServer *>(aContext);
+    std::lock_guard<std::mutex> lock(server.mSharedMutex);
+
+    return mbedtls_ssl_cache_set(&server.mCache, aSession);
+}
+#endif
+
+void MbedtlsServer::Process(const fd_set &aReadFdSet, const fd_set &aWriteFdSet, const fd_set &aErrorFdSet)
+{
+    if (mHandshakePool.GetEventFd() >= 0 && FD_ISSET(mHandshakePool.GetEventFd(), &aReadFdSet))
+    {
+        FinishHandshakes();
+    }
+
+    if (mSocket >= 0 && mCongestedSessions > 0 && FD_ISSET(mSocket, &aWriteFdSet))
+    {
+        FlushSessions();
+    }
 
     ProcessServer(aReadFdSet, aWriteFdSet, aErrorFdSet);
+}
 
-    (void)aErrorFdSet;
+void MbedtlsServer::FlushSessions(void)
+{
+    for (MbedtlsSession *session = mExpiryHead; session != NULL && mCongestedSessions > 0;)
+    {
+        MbedtlsSession *next = session->mExpiryNext;
+
+        // a failed write retires the session, i.e. moves it to the front
+        if (!session->mOutbound.empty() && !session->mIsOffloaded)
+        {
+            session->Flush();
+        }
+
+        session = next;
+    }
 }
 
 otbrError MbedtlsServer::SetPSK(const uint8_t *aPSK, uint8_t aLength)
@@ -702,13 +1653,15 @@ exit:
 
 MbedtlsServer::~MbedtlsServer(void)
 {
-    SessionSet::iterator it = mSessions.begin();
+    // sessions still pending in the pool are not touched by workers after this
+    mHandshakePool.Stop();
 
-    while (it != mSessions.end())
+    while (mExpiryHead != NULL)
     {
-        MbedtlsSession *session = *it;
+        MbedtlsSession *session = mExpiryHead;
+
+        RemoveSession(*session);
         delete session;
-        it = mSessions.erase(it);
     }
 
     close(mSocket);
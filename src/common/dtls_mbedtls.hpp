@@ -34,6 +34,10 @@
 #ifndef DTLS_MBEDTLS_HPP_
 #define DTLS_MBEDTLS_HPP_
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <netinet/in.h>
@@ -71,6 +75,38 @@ extern "C" {
 
 #include "dtls.hpp"
 
+/**
+ * Number of threads running DTLS handshakes off the main loop, 0 to run them on the main loop.
+ *
+ */
+#ifndef OTBR_DTLS_HANDSHAKE_THREADS
+#define OTBR_DTLS_HANDSHAKE_THREADS 2
+#endif
+
+/**
+ * Max number of DTLS sessions a server keeps at the same time.
+ *
+ */
+#ifndef OTBR_DTLS_MAX_SESSIONS
+#define OTBR_DTLS_MAX_SESSIONS 16
+#endif
+
+/**
+ * Max number of DTLS sessions a server keeps handshaking at the same time.
+ *
+ */
+#ifndef OTBR_DTLS_MAX_HANDSHAKES
+#define OTBR_DTLS_MAX_HANDSHAKES 4
+#endif
+
+/**
+ * Estimated memory in KiB all DTLS sessions of a server may use.
+ *
+ */
+#ifndef OTBR_DTLS_MEMORY_BUDGET
+#define OTBR_DTLS_MEMORY_BUDGET 128
+#endif
+
 namespace ot {
 
 namespace BorderRouter {
@@ -87,6 +123,8 @@ namespace Dtls {
  */
 
 class MbedtlsServer;
+class HandshakePool;
+class MbedtlsTester;
 
 enum
 {
@@ -101,19 +139,20 @@ enum
 class MbedtlsSession : public Session
 {
     friend class MbedtlsServer;
+    friend class HandshakePool;
+    friend class MbedtlsTester;
 
 public:
     /**
      * The constructor to initialize a DTLS session.
      *
      * @param[in]   aServer     A reference to the DTLS server.
-     * @param[in]   aNet        A reference to the mbedtls_net_context.
      * @param[in]   aRemoteSock A reference to the remote sockaddr of this session.
-     * @param[in]   aLocalSock  A reference to the local sockaddr of this session.
+     * @param[in]   aLocalSock  A reference to the local sockaddr of this session, whose scope id is the index of
+     *                          the receiving interface.
      *
      */
     MbedtlsSession(MbedtlsServer &            aServer,
-                   const mbedtls_net_context &aNet,
                    const struct sockaddr_in6 &aRemoteSock,
                    const struct sockaddr_in6 &aLocalSock);
 
@@ -140,12 +179,38 @@ public:
     State GetState(void) const { return mState; }
 
     /**
-     * This method returns the underlying unix fd of this session.
+     * This method indicates whether this session is handshaking or ready.
+     *
+     * @returns Whether this session is active.
+     *
+     */
+    bool IsActive(void) const { return mState == kStateHandshaking || mState == kStateReady; }
+
+    /**
+     * This method returns the estimated memory used by this session.
      *
-     * @returns Unix file descriptor.
+     * @returns Estimated memory in bytes.
      *
      */
-    int GetFd(void) const { return mNet.fd; }
+    size_t GetMemoryEstimate(void) const;
+
+    /**
+     * This method returns the estimated memory used by a session without pending datagrams.
+     *
+     * @param[in]   aIsHandshaking  Whether the session is handshaking.
+     *
+     * @returns Estimated memory in bytes.
+     *
+     */
+    static size_t EstimateMemory(bool aIsHandshaking);
+
+    /**
+     * This method returns the remote sockaddr of this session.
+     *
+     * @returns A reference to the remote sockaddr.
+     *
+     */
+    const sockaddr_in6 &GetRemoteSock(void) const { return mRemoteSock; }
 
     /**
      * This method returns the expiration of this session.
@@ -163,10 +228,13 @@ public:
     const uint8_t *GetKek(void) { return mKek; }
 
     /**
-     * This method performs the session processing.
+     * This method performs the session processing of a datagram received from its peer.
+     *
+     * @param[in]   aBuffer     A pointer to the datagram.
+     * @param[in]   aLength     Number of bytes of @p aBuffer.
      *
      */
-    void Process(void);
+    void Process(const uint8_t *aBuffer, uint16_t aLength);
 
     /**
      * This method closes the DTLS session.
@@ -177,8 +245,21 @@ public:
 private:
     enum
     {
-        kSessionTimeout = 60000, ///< Default DTLS session timeout in miniseconds.
-        kKekSize        = 32,    ///< Size of KEK.
+        kSessionTimeout    = 60000, ///< Default DTLS session timeout in miniseconds.
+        kHandshakeTimeout  = 16000, ///< Max silence of the peer in a handshake, also its max retransmission timeout.
+        kHandshakeInterval = 1000,  ///< Initial retransmission timeout of a handshake in milliseconds.
+        kKekSize           = 32,    ///< Size of KEK.
+        kMaxBacklog        = 4,     ///< Max number of datagrams kept while a handshake worker owns the session.
+        kMaxOutbound       = 8,     ///< Max number of messages queued while the socket is not writable.
+        kCidLength         = 4,     ///< Size of the connection ID the peer puts in its records.
+    };
+
+    // Rough upper bounds of what mbedTLS allocates besides the context, which is part of the session.
+    enum
+    {
+        kRecordOverhead    = 128,  ///< Record header, IV and tag space of a record buffer in bytes.
+        kTransformOverhead = 1024, ///< Session and cipher transform in bytes.
+        kHandshakeOverhead = 6144, ///< Handshake parameters including the EC-JPAKE context in bytes.
     };
 
     static int ExportKeys(void *               aContext,
@@ -187,7 +268,11 @@ private:
                           size_t               aMacLength,
                           size_t               aKeyLength,
                           size_t               aIvLength);
-    int        Handshake(void);
+    void       Handshake(const uint8_t *aBuffer, uint16_t aLength);
+    int        RunHandshake(void);
+    void       HandleHandshake(int aResult);
+    void       FinishHandshake(void);
+    void       Flush(void);
     int        Read(void);
     void       SetState(State aState);
     static int SendMbedtls(void *aContext, const unsigned char *aBuffer, size_t aLength)
@@ -207,20 +292,180 @@ private:
     static int  GetDelay(void *aContext);
     int         GetDelay(void) const;
 
-    mbedtls_net_context mNet;
+    static uint16_t ParseRecord(const uint8_t *aBuffer, uint16_t aLength, uint64_t &aSequence);
+
     mbedtls_ssl_context mSsl;
+    mbedtls_ssl_config  mConf; ///< Shallow copy of the server config, binding the key export to this session.
+
+    DataHandler     mDataHandler;
+    void *          mContext;
+    State           mState;
+    sockaddr_in6    mRemoteSock;
+    sockaddr_in6    mLocalSock;
+    MbedtlsServer & mServer;
+    unsigned long   mExpiration;
+    uint8_t         mKek[kKekSize];
+    unsigned long   mIntermediate;
+    unsigned long   mFinal;
+    bool            mIsTimerSet;
+    const uint8_t * mReceived; ///< The datagram being processed, NULL once read by mbedTLS.
+    uint16_t        mReceivedLength;
+    MbedtlsSession *mExpiryPrev; ///< The session expiring right before this one.
+    MbedtlsSession *mExpiryNext; ///< The session expiring right after this one.
+
+    bool                             mIsOffloaded;       ///< Whether a handshake worker owns this session.
+    int                              mHandshakeResult;   ///< Result of the last handshake step of a worker.
+    std::vector<uint8_t>             mHandshakeInput;    ///< The datagram handed to a handshake worker.
+    std::deque<std::vector<uint8_t>> mBacklog;           ///< Datagrams received while a worker owns this session.
+    std::deque<std::vector<uint8_t>> mOutbound;          ///< Messages waiting for the socket to become writable.
+    uint8_t                          mCid[kCidLength];   ///< Connection ID assigned to this session.
+    const sockaddr_in6 *             mRoamingRemoteSock; ///< New peer address of a record routed by connection ID.
+    const sockaddr_in6 *             mRoamingLocalSock;  ///< Local address that record was received on.
+    uint64_t                         mReceivedSequence;  ///< Epoch and sequence number of the record being read.
+    uint64_t                         mLastSequence;      ///< Highest epoch and sequence number of a record read.
+};
+
+/**
+ * This class implements a pool of threads running DTLS handshake steps off the main loop.
+ *
+ * A submitted session is owned by the pool until it is collected on the main loop, and only
+ * mbedtls_ssl_handshake() runs on the workers.
+ *
+ */
+class HandshakePool
+{
+public:
+    /**
+     * The constructor to initialize a pool without threads.
+     *
+     */
+    HandshakePool(void);
+
+    ~HandshakePool(void);
+
+    /**
+     * This method starts the worker threads.
+     *
+     * @param[in]   aThreads    Number of worker threads, 0 to keep handshakes on the main loop.
+     *
+     * @retval  OTBR_ERROR_NONE     Successfully started.
+     * @retval  OTBR_ERROR_ERRNO    Failed to create the event fd.
+     *
+     */
+    otbrError Start(size_t aThreads);
+
+    /**
+     * This method stops and joins the worker threads, pending sessions are left to the caller.
+     *
+     */
+    void Stop(void);
+
+    /**
+     * This method indicates whether handshakes run on worker threads.
+     *
+     * @returns Whether there are worker threads.
+     *
+     */
+    bool IsEnabled(void) const { return !mThreads.empty(); }
+
+    /**
+     * This method returns the fd becoming readable when handshake steps are finished.
+     *
+     * @returns Unix file descriptor, -1 if not started.
+     *
+     */
+    int GetEventFd(void) const { return mPipe[0]; }
 
-    DataHandler    mDataHandler;
-    void *         mContext;
-    State          mState;
-    sockaddr_in6   mRemoteSock;
-    sockaddr_in6   mLocalSock;
-    MbedtlsServer &mServer;
-    unsigned long  mExpiration;
-    uint8_t        mKek[kKekSize];
-    unsigned long  mIntermediate;
-    unsigned long  mFinal;
-    bool           mIsTimerSet;
+    /**
+     * This method hands a session over to the workers to run a handshake step.
+     *
+     * @param[in]   aSession    A reference to the session.
+     *
+     */
+    void Submit(MbedtlsSession &aSession);
+
+    /**
+     * This method takes back the sessions whose handshake step is finished.
+     *
+     * @param[out]  aFinished   A reference to the queue the finished sessions are appended to.
+     *
+     */
+    void Collect(std::deque<MbedtlsSession *> &aFinished);
+
+private:
+    void Run(void);
+
+    std::vector<std::thread>     mThreads;
+    std::mutex                   mMutex;
+    std::condition_variable      mCondition;
+    std::deque<MbedtlsSession *> mPending;
+    std::deque<MbedtlsSession *> mFinished;
+    int                          mPipe[2]; ///< Self-pipe the workers wake up the main loop with.
+    bool                         mIsStopping;
+};
+
+/**
+ * This class implements an open-addressing hash table of DTLS sessions keyed by their remote sockaddr.
+ *
+ */
+class SessionTable
+{
+    friend class MbedtlsTester;
+
+public:
+    /**
+     * The constructor to initialize an empty session table.
+     *
+     */
+    SessionTable(void);
+
+    /**
+     * This method finds the session of a remote sockaddr.
+     *
+     * @param[in]   aRemoteSock A reference to the remote sockaddr.
+     *
+     * @returns A pointer to the session, NULL if there is none.
+     *
+     */
+    MbedtlsSession *Find(const sockaddr_in6 &aRemoteSock) const;
+
+    /**
+     * This method inserts a session whose remote sockaddr is not in the table yet.
+     *
+     * @param[in]   aSession    A reference to the session.
+     *
+     */
+    void Insert(MbedtlsSession &aSession);
+
+    /**
+     * This method removes a session from the table, if it is there.
+     *
+     * @param[in]   aSession    A reference to the session.
+     *
+     */
+    void Remove(const MbedtlsSession &aSession);
+
+    /**
+     * This method returns the number of sessions in the table.
+     *
+     * @returns Number of sessions.
+     *
+     */
+    size_t GetSize(void) const { return mSize; }
+
+private:
+    enum
+    {
+        kInitialCapacity = 16, ///< Initial number of slots, must be a power of two.
+    };
+
+    static size_t Hash(const sockaddr_in6 &aRemoteSock);
+    static bool   IsSamePeer(const sockaddr_in6 &aLeft, const sockaddr_in6 &aRight);
+    size_t        FindSlot(const sockaddr_in6 &aRemoteSock) const;
+    void          Grow(void);
+
+    std::vector<MbedtlsSession *> mSlots;
+    size_t                        mSize;
 };
 
 /**
@@ -230,6 +475,7 @@ private:
 class MbedtlsServer : public Server
 {
     friend class MbedtlsSession;
+    friend class MbedtlsTester;
 
 public:
     /**
@@ -241,10 +487,15 @@ public:
      *
      */
     MbedtlsServer(uint16_t aPort, StateHandler aStateHandler, void *aContext)
-        : mSocket(-1)
+        : mExpiryHead(NULL)
+        , mExpiryTail(NULL)
+        , mCongestedSessions(0)
+        , mSocket(-1)
         , mPort(aPort)
         , mStateHandler(aStateHandler)
         , mContext(aContext)
+        , mSeedLength(0)
+        , mPSKLength(0)
     {
     }
 
@@ -308,29 +559,89 @@ public:
     otbrError SetSeed(const uint8_t *aSeed, uint16_t aLength);
 
 private:
-    typedef std::vector<MbedtlsSession *> SessionSet;
     enum
     {
-        kMaxSizeOfPSK = 32, ///< Max size of PSK in bytes.
+        kMaxSizeOfPSK                    = 32,  ///< Max size of PSK in bytes.
+        kMaxDatagramsPerProcess          = 64,  ///< Max number of datagrams received in one processing.
+        kSizeOfRecordHeader              = 13,  ///< Size of DTLS record header in bytes.
+        kSizeOfHandshakeHeader           = 12,  ///< Size of DTLS handshake message header in bytes.
+        kSizeOfClientHelloFixedPart      = 34,  ///< Size of client_version and random of ClientHello.
+        kSizeOfHelloVerifyFixedPart      = 3,   ///< Size of server_version and cookie length of HelloVerifyRequest.
+        kMaxSizeOfCookie                 = 255, ///< Max size of DTLS cookie in bytes.
+        kContentTypeHandshake            = 22,  ///< DTLS record content type of handshake.
+        kContentTypeCid                  = 25,  ///< DTLS record content type of a record carrying a connection ID.
+        kOffsetOfSequence                = 3,   ///< Offset of the epoch and sequence number in a DTLS record.
+        kOffsetOfCid                     = 11,  ///< Offset of the connection ID in a DTLS record.
+        kHandshakeTypeClientHello        = 1,   ///< DTLS handshake type of ClientHello.
+        kHandshakeTypeHelloVerifyRequest = 3,   ///< DTLS handshake type of HelloVerifyRequest.
+        kDtlsVersionMajor                = 254, ///< Major version byte of DTLS 1.2.
+        kDtlsVersionMinor                = 253, ///< Minor version byte of DTLS 1.2.
+    };
+
+    enum
+    {
+        kMaxSessions   = OTBR_DTLS_MAX_SESSIONS,         ///< Max number of sessions.
+        kMaxHandshakes = OTBR_DTLS_MAX_HANDSHAKES,       ///< Max number of handshaking sessions.
+        kMemoryBudget  = OTBR_DTLS_MEMORY_BUDGET * 1024, ///< Max estimated memory of all sessions in bytes.
     };
 
     void HandleSessionState(Session &aSession, Session::State aState);
     void ProcessServer(const fd_set &aReadFdSet, const fd_set &aWriteFdSet, const fd_set &aErrorFdSet);
+    void HandleDatagram(const uint8_t *aBuffer, uint16_t aLength, const sockaddr_in6 &aSrc, const sockaddr_in6 &aDst);
+    bool ExchangeCookie(const uint8_t *aBuffer, uint16_t aLength, const sockaddr_in6 &aSrc, const sockaddr_in6 &aDst);
+    void SendHelloVerifyRequest(const uint8_t *     aClientHello,
+                                const sockaddr_in6 &aSrc,
+                                const sockaddr_in6 &aDst);
+    int  SendTo(const unsigned char *aBuffer, size_t aLength, const sockaddr_in6 &aRemote, const sockaddr_in6 &aLocal);
+    void AddSession(MbedtlsSession &aSession);
+    void RemoveSession(MbedtlsSession &aSession);
+    void RefreshSession(MbedtlsSession &aSession);
+    void RetireSession(MbedtlsSession &aSession);
+    void LinkExpiry(MbedtlsSession &aSession, bool aFront);
+    void UnlinkExpiry(MbedtlsSession &aSession);
+    void FinishHandshakes(void);
+    bool AdmitSession(void);
+    void FlushSessions(void);
+    void MoveSession(MbedtlsSession &aSession, const sockaddr_in6 &aRemoteSock, const sockaddr_in6 &aLocalSock);
+
+    MbedtlsSession *FindSessionByCid(const uint8_t *aCid) const;
+
+    // These wrap the contexts shared by handshakes running on workers.
+    static int Random(void *aContext, unsigned char *aBuffer, size_t aLength);
+    static int WriteCookie(void *               aContext,
+                           unsigned char **     aCursor,
+                           unsigned char *      aEnd,
+                           const unsigned char *aClientId,
+                           size_t               aClientIdLength);
+    static int CheckCookie(void *               aContext,
+                           const unsigned char *aCookie,
+                           size_t               aCookieLength,
+                           const unsigned char *aClientId,
+                           size_t               aClientIdLength);
+#if defined(MBEDTLS_SSL_CACHE_C)
+    static int GetCachedSession(void *aContext, mbedtls_ssl_session *aSession);
+    static int SetCachedSession(void *aContext, const mbedtls_ssl_session *aSession);
+#endif
 
     otbrError Bind(void);
 
     static void MbedtlsDebug(void *aContext, int aLevel, const char *aFile, int aLine, const char *aMessage);
     void        MbedtlsDebug(int aLevel, const char *aFile, int aLine, const char *aMessage);
 
-    SessionSet   mSessions;
-    int          mSocket;
-    uint16_t     mPort;
-    StateHandler mStateHandler;
-    void *       mContext;
-    uint8_t      mSeed[MBEDTLS_CTR_DRBG_MAX_SEED_INPUT];
-    uint16_t     mSeedLength;
-    uint8_t      mPSK[kMaxSizeOfPSK];
-    uint8_t      mPSKLength;
+    SessionTable    mSessions;
+    MbedtlsSession *mExpiryHead;        ///< The session expiring first.
+    MbedtlsSession *mExpiryTail;        ///< The session expiring last.
+    size_t          mCongestedSessions; ///< Number of sessions with queued messages.
+    int             mSocket;
+    uint16_t        mPort;
+    StateHandler    mStateHandler;
+    void *          mContext;
+    uint8_t         mSeed[MBEDTLS_CTR_DRBG_MAX_SEED_INPUT];
+    uint16_t        mSeedLength;
+    uint8_t         mPSK[kMaxSizeOfPSK];
+    uint8_t         mPSKLength;
+    HandshakePool   mHandshakePool;
+    std::mutex      mSharedMutex; ///< Guards the random generator, cookie and cache contexts.
 
     mbedtls_ssl_cookie_ctx   mCookie;
     mbedtls_entropy_context  mEntropy;
@@ -0,0 +1,236 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements the flight recorder.
+ */
+
+#include "flight_recorder.hpp"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "code_utils.hpp"
+
+namespace ot {
+
+namespace BorderRouter {
+
+FlightRecorder::FlightRecorder(void)
+    : mHeader(NULL)
+    , mRing(NULL)
+    , mSize(0)
+{
+}
+
+otbrError FlightRecorder::Open(const char *aFilename, size_t aSize)
+{
+    otbrError error = OTBR_ERROR_ERRNO;
+    int       fd    = -1;
+    void *    addr;
+
+    assert(aFilename != NULL);
+
+    Close();
+
+    VerifyOrExit(aSize >= kMinRingSize, errno = EINVAL);
+
+    fd = open(aFilename, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    VerifyOrExit(fd != -1);
+    VerifyOrExit(ftruncate(fd, static_cast<off_t>(kHeaderSize + aSize)) == 0);
+
+    addr = mmap(NULL, kHeaderSize + aSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    VerifyOrExit(addr != MAP_FAILED);
+
+    mHeader = static_cast<Header *>(addr);
+    mRing   = static_cast<uint8_t *>(addr) + kHeaderSize;
+    mSize   = aSize;
+
+    mHeader->mVersion = kVersion;
+    mHeader->mSize    = aSize;
+    mHeader->mWritten = 0;
+    // the file is only recognized once the header is complete
+    __atomic_store_n(&mHeader->mMagic, static_cast<uint32_t>(kMagic), __ATOMIC_RELEASE);
+
+    error = OTBR_ERROR_NONE;
+
+exit:
+    if (fd != -1)
+    {
+        int err = errno;
+
+        close(fd);
+        errno = err;
+    }
+
+    return error;
+}
+
+void FlightRecorder::Close(void)
+{
+    VerifyOrExit(mHeader != NULL);
+
+    munmap(mHeader, kHeaderSize + mSize);
+    mHeader = NULL;
+    mRing   = NULL;
+    mSize   = 0;
+
+exit:
+    return;
+}
+
+void FlightRecorder::Write(const void *aData, size_t aLength)
+{
+    const uint8_t *data    = static_cast<const uint8_t *>(aData);
+    uint64_t       written = mHeader->mWritten;
+    size_t         offset;
+    size_t         length;
+
+    assert(IsOpen());
+
+    // only the tail of an oversized record survives anyway
+    if (aLength > mSize)
+    {
+        written += aLength - mSize;
+        data += aLength - mSize;
+        aLength = mSize;
+    }
+
+    offset = static_cast<size_t>(written % mSize);
+    length = aLength < mSize - offset ? aLength : mSize - offset;
+
+    memcpy(mRing + offset, data, length);
+    memcpy(mRing, data + length, aLength - length);
+
+    // publish the record only after its content, so a crash never exposes a torn record at the tail
+    __atomic_store_n(&mHeader->mWritten, written + aLength, __ATOMIC_RELEASE);
+}
+
+otbrError FlightRecorder::Dump(const char *aFilename, FILE *aStream)
+{
+    otbrError      error  = OTBR_ERROR_ERRNO;
+    int            fd     = -1;
+    void *         addr   = MAP_FAILED;
+    size_t         mapped = 0;
+    struct stat    st;
+    const Header * header;
+    const uint8_t *ring;
+    const uint8_t *newest;
+    const uint8_t *oldest;
+    size_t         newestLength;
+    size_t         oldestLength;
+
+    fd = open(aFilename, O_RDONLY | O_CLOEXEC);
+    VerifyOrExit(fd != -1);
+    VerifyOrExit(fstat(fd, &st) == 0);
+    VerifyOrExit(static_cast<size_t>(st.st_size) >= kHeaderSize + kMinRingSize, errno = EINVAL);
+
+    mapped = static_cast<size_t>(st.st_size);
+    addr   = mmap(NULL, mapped, PROT_READ, MAP_PRIVATE, fd, 0);
+    VerifyOrExit(addr != MAP_FAILED);
+
+    header = static_cast<const Header *>(addr);
+    ring   = static_cast<const uint8_t *>(addr) + kHeaderSize;
+    VerifyOrExit(header->mMagic == kMagic && header->mVersion == kVersion, errno = EINVAL);
+    VerifyOrExit(header->mSize >= kMinRingSize && header->mSize <= mapped - kHeaderSize, errno = EINVAL);
+
+    if (header->mWritten <= header->mSize)
+    {
+        oldest       = ring;
+        oldestLength = static_cast<size_t>(header->mWritten);
+        newest       = ring;
+        newestLength = 0;
+    }
+    else
+    {
+        size_t offset = static_cast<size_t>(header->mWritten % header->mSize);
+
+        oldest       = ring + offset;
+        oldestLength = static_cast<size_t>(header->mSize) - offset;
+        newest       = ring;
+        newestLength = offset;
+
+        // skip the record partially overwritten by the newest one
+        while (oldestLength > 0 && *oldest != '\n')
+        {
+            oldest++;
+            oldestLength--;
+        }
+
+        if (oldestLength > 0)
+        {
+            oldest++;
+            oldestLength--;
+        }
+        else
+        {
+            while (newestLength > 0 && *newest != '\n')
+            {
+                newest++;
+                newestLength--;
+            }
+
+            if (newestLength > 0)
+            {
+                newest++;
+                newestLength--;
+            }
+        }
+    }
+
+    VerifyOrExit(fwrite(oldest, 1, oldestLength, aStream) == oldestLength);
+    VerifyOrExit(fwrite(newest, 1, newestLength, aStream) == newestLength);
+
+    error = OTBR_ERROR_NONE;
+
+exit:
+    if (addr != MAP_FAILED)
+    {
+        munmap(addr, mapped);
+    }
+
+    if (fd != -1)
+    {
+        int err = errno;
+
+        close(fd);
+        errno = err;
+    }
+
+    return error;
+}
+
+} // namespace BorderRouter
+
+} // namespace ot
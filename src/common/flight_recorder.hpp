@@ -0,0 +1,152 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file includes definitions of the flight recorder, an in-memory ring of log records backed by a file.
+ */
+
+#ifndef FLIGHT_RECORDER_HPP_
+#define FLIGHT_RECORDER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "types.hpp"
+
+namespace ot {
+
+namespace BorderRouter {
+
+/**
+ * This class implements a flight recorder.
+ *
+ * Records are appended to a ring buffer mapped from a file with MAP_SHARED, so recording costs a memcpy and no
+ * system call, and the last records stay in the file after the process crashes or is killed.
+ *
+ */
+class FlightRecorder
+{
+public:
+    enum
+    {
+        kMagic       = 0x5246544f, ///< "OTFR" in little endian.
+        kVersion     = 1,          ///< Version of the file layout.
+        kHeaderSize  = 64,         ///< Size of the file header, the ring follows it.
+        kMinRingSize = 4096,       ///< Min size of the ring in bytes.
+    };
+
+    /**
+     * This structure represents the header at the beginning of a flight recorder file.
+     *
+     */
+    struct Header
+    {
+        uint32_t mMagic;   ///< Must be kMagic.
+        uint32_t mVersion; ///< Must be kVersion.
+        uint64_t mSize;    ///< Size of the ring in bytes.
+        uint64_t mWritten; ///< Total bytes ever written, the ring position is mWritten % mSize.
+    };
+
+    /**
+     * The constructor to initialize a flight recorder.
+     *
+     */
+    FlightRecorder(void);
+
+    /**
+     * The destructor to close the flight recorder.
+     *
+     */
+    ~FlightRecorder(void) { Close(); }
+
+    /**
+     * This method creates the flight recorder file and maps it into memory.
+     *
+     * Any previous content of the file is discarded.
+     *
+     * @param[in]   aFilename   The path of the flight recorder file.
+     * @param[in]   aSize       The size of the ring in bytes, at least kMinRingSize.
+     *
+     * @retval OTBR_ERROR_NONE      Successfully opened the flight recorder.
+     * @retval OTBR_ERROR_ERRNO     Failed to create or map the file, errno is set.
+     *
+     */
+    otbrError Open(const char *aFilename, size_t aSize);
+
+    /**
+     * This method unmaps the flight recorder file.
+     *
+     * Records already written remain in the file.
+     *
+     */
+    void Close(void);
+
+    /**
+     * This method indicates whether the flight recorder is open.
+     *
+     * @returns Whether the flight recorder is open.
+     *
+     */
+    bool IsOpen(void) const { return mHeader != NULL; }
+
+    /**
+     * This method appends data to the ring, overwriting the oldest data when it is full.
+     *
+     * @param[in]   aData       A pointer to the data.
+     * @param[in]   aLength     Number of bytes of @p aData.
+     *
+     */
+    void Write(const void *aData, size_t aLength);
+
+    /**
+     * This function writes the records of a flight recorder file to a stream, oldest first.
+     *
+     * When the ring has wrapped, the partially overwritten record at the ring position is skipped.
+     *
+     * @param[in]   aFilename   The path of the flight recorder file.
+     * @param[in]   aStream     The stream to write records to.
+     *
+     * @retval OTBR_ERROR_NONE      Successfully dumped the records.
+     * @retval OTBR_ERROR_ERRNO     Failed to read the file or it is not a flight recorder file, errno is set.
+     *
+     */
+    static otbrError Dump(const char *aFilename, FILE *aStream);
+
+private:
+    Header * mHeader;
+    uint8_t *mRing;
+    size_t   mSize;
+};
+
+} // namespace BorderRouter
+
+} // namespace ot
+
+#endif // FLIGHT_RECORDER_HPP_
@@ -38,10 +38,35 @@
 #include <sys/time.h>
 #include <syslog.h>
 
+#include <mutex>
+
+#include "flight_recorder.hpp"
 #include "time.hpp"
 
-static int        sLevel      = LOG_INFO;
-static const char kHexChars[] = "0123456789abcdef";
+static int sLevel = LOG_INFO;
+
+/* "xx " for each byte value, so encoding a byte is a single 3 byte copy */
+static const char kHexTable[] =
+    "00 01 02 03 04 05 06 07 08 09 0a 0b 0c 0d 0e 0f "
+    "10 11 12 13 14 15 16 17 18 19 1a 1b 1c 1d 1e 1f "
+    "20 21 22 23 24 25 26 27 28 29 2a 2b 2c 2d 2e 2f "
+    "30 31 32 33 34 35 36 37 38 39 3a 3b 3c 3d 3e 3f "
+    "40 41 42 43 44 45 46 47 48 49 4a 4b 4c 4d 4e 4f "
+    "50 51 52 53 54 55 56 57 58 59 5a 5b 5c 5d 5e 5f "
+    "60 61 62 63 64 65 66 67 68 69 6a 6b 6c 6d 6e 6f "
+    "70 71 72 73 74 75 76 77 78 79 7a 7b 7c 7d 7e 7f "
+    "80 81 82 83 84 85 86 87 88 89 8a 8b 8c 8d 8e 8f "
+    "90 91 92 93 94 95 96 97 98 99 9a 9b 9c 9d 9e 9f "
+    "a0 a1 a2 a3 a4 a5 a6 a7 a8 a9 aa ab ac ad ae af "
+    "b0 b1 b2 b3 b4 b5 b6 b7 b8 b9 ba bb bc bd be bf "
+    "c0 c1 c2 c3 c4 c5 c6 c7 c8 c9 ca cb cc cd ce cf "
+    "d0 d1 d2 d3 d4 d5 d6 d7 d8 d9 da db dc dd de df "
+    "e0 e1 e2 e3 e4 e5 e6 e7 e8 e9 ea eb ec ed ee ef "
+    "f0 f1 f2 f3 f4 f5 f6 f7 f8 f9 fa fb fc fd fe ff ";
+
+static int sModuleLevel[OTBR_LOG_MODULE_COUNT] = {LOG_INFO, LOG_INFO, LOG_INFO, LOG_INFO, LOG_INFO, LOG_INFO};
+
+int gOtbrLogThreshold[OTBR_LOG_MODULE_COUNT] = {-1, -1, -1, -1, -1, -1};
 
 static unsigned long sMsecsStart;
 static bool          sLogCol0 = true; /* we start at col0 */
@@ -49,13 +74,70 @@ static FILE *        sLogFp;
 static bool          sSyslogEnabled = true;
 static bool          sSyslogOpened  = false;
 
+static ot::BorderRouter::FlightRecorder sFlightRecorder;
+
+/** Serializes messages, e.g. DTLS handshakes log from worker threads */
+static std::recursive_mutex sLogMutex;
+
 #define LOGFLAG_syslog 1
 #define LOGFLAG_file 2
+#define LOGFLAG_recorder 4
+
+enum
+{
+    kLogSiteTableSize  = 32,   ///< Number of call sites tracked by rate limiting, must be power of 2.
+    kLogSiteProbes     = 4,    ///< Max slots probed when looking up a call site.
+    kLogRateInterval   = 5000, ///< Rate limit interval in milliseconds.
+    kLogRateBurst      = 5,    ///< Max messages logged per call site in a rate limit interval.
+    kLogMaxMessageSize = 1024, ///< Max size of a formatted message.
+    kLogMaxRecordSize  = 4096, ///< Max size of a multi-line record, i.e. a hex dump.
+    kLogTimestampSize  = 32,   ///< Max size of a flight recorder timestamp.
+    kDumpBytesPerLine  = 16,   ///< Number of bytes per hex dump line.
+    kDumpMaxPrefixSize = 64,   ///< Max size of a hex dump prefix, longer ones are truncated.
+};
+
+/** State of a rate limited call site */
+struct LogSite
+{
+    const char *  mFile;        ///< Source file of the call site, NULL for an empty slot.
+    int           mLine;        ///< Source line of the call site.
+    int           mModule;      ///< Log module of the call site.
+    int           mLevel;       ///< Log level of the last message.
+    uint32_t      mLastHash;    ///< Hash of the last logged message.
+    unsigned long mWindowStart; ///< Start of the current rate limit interval.
+    unsigned int  mCount;       ///< Messages logged in the current rate limit interval.
+    unsigned int  mSuppressed;  ///< Messages suppressed since the last logged message.
+};
+
+static LogSite sLogSites[kLogSiteTableSize];
+
+/** Recompute the effective level of each module from the module levels and enabled outputs */
+static void UpdateThresholds(void)
+{
+    for (int module = 0; module < OTBR_LOG_MODULE_COUNT; module++)
+    {
+        int threshold = -1;
+
+        if ((sSyslogOpened && sSyslogEnabled) || sFlightRecorder.IsOpen())
+        {
+            threshold = sModuleLevel[module];
+        }
+
+        /* the private log file is not filtered by level, see LogCheck() */
+        if (sLogFp != NULL)
+        {
+            threshold = LOG_DEBUG;
+        }
+
+        gOtbrLogThreshold[module] = threshold;
+    }
+}
 
 /** Set/Clear syslog enable flag */
 void otbrLogEnableSyslog(bool b)
 {
     sSyslogEnabled = b;
+    UpdateThresholds();
 }
 
 /** Enable logging to a specific file */
@@ -73,6 +155,81 @@ void otbrLogSetFilename(const char *filename)
         perror(filename);
         exit(EXIT_FAILURE);
     }
+    UpdateThresholds();
+}
+
+/** Enable recording logs to a flight recorder file */
+void otbrLogSetFlightRecorder(const char *aFilename, size_t aSize)
+{
+    sFlightRecorder.Close();
+
+    if (aFilename != NULL && sFlightRecorder.Open(aFilename, aSize) != OTBR_ERROR_NONE)
+    {
+        fprintf(stderr, "Cannot open flight recorder: %s\n", aFilename);
+        perror(aFilename);
+        exit(EXIT_FAILURE);
+    }
+    UpdateThresholds();
+}
+
+/** Returns the 32-bit FNV-1a hash of a string */
+static uint32_t HashString(const char *aString)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*aString != 0)
+    {
+        hash ^= static_cast<uint8_t>(*aString++);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/** Find the rate limit state of a call site, taking over a slot if it is not tracked yet */
+static LogSite &FindLogSite(const char *aFile, int aLine)
+{
+    uint32_t hash  = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(aFile) >> 2) ^ static_cast<uint32_t>(aLine);
+    size_t   home  = (hash * 2654435761u) & (kLogSiteTableSize - 1);
+    LogSite *empty = NULL;
+
+    for (size_t i = 0; i < kLogSiteProbes; i++)
+    {
+        LogSite &site = sLogSites[(home + i) & (kLogSiteTableSize - 1)];
+
+        if (site.mFile == aFile && site.mLine == aLine)
+        {
+            return site;
+        }
+
+        if (site.mFile == NULL && empty == NULL)
+        {
+            empty = &site;
+        }
+    }
+
+    /* evict the home slot if the neighborhood is full, it only costs some suppression */
+    if (empty == NULL)
+    {
+        empty = &sLogSites[home];
+    }
+
+    memset(empty, 0, sizeof(*empty));
+    empty->mFile = aFile;
+    empty->mLine = aLine;
+
+    return *empty;
+}
+
+/** Log the number of messages suppressed at a call site */
+static void LogSuppressed(LogSite &aSite)
+{
+    const char *file = strrchr(aSite.mFile, '/');
+
+    file = (file == NULL ? aSite.mFile : file + 1);
+    otbrLogPrint(aSite.mModule, aSite.mLevel, "Suppressed %u messages from %s:%d", aSite.mSuppressed, file,
+                 aSite.mLine);
+    aSite.mSuppressed = 0;
 }
 
 /** Get the current debug log level */
@@ -81,23 +238,46 @@ int otbrLogGetLevel(void)
     return sLevel;
 }
 
-/** Set the debug log level */
+/** Set the debug log level of all modules */
 void otbrLogSetLevel(int aLevel)
 {
     assert(aLevel >= LOG_EMERG && aLevel <= LOG_DEBUG);
     sLevel = aLevel;
+
+    for (int module = 0; module < OTBR_LOG_MODULE_COUNT; module++)
+    {
+        sModuleLevel[module] = aLevel;
+    }
+    UpdateThresholds();
+}
+
+/** Get the debug log level of a module */
+int otbrLogGetModuleLevel(int aModule)
+{
+    assert(aModule >= 0 && aModule < OTBR_LOG_MODULE_COUNT);
+    return sModuleLevel[aModule];
+}
+
+/** Set the debug log level of a module */
+void otbrLogSetModuleLevel(int aModule, int aLevel)
+{
+    assert(aModule >= 0 && aModule < OTBR_LOG_MODULE_COUNT);
+    assert(aLevel >= LOG_EMERG && aLevel <= LOG_DEBUG);
+    sModuleLevel[aModule] = aLevel;
+    UpdateThresholds();
 }
 
 /** Determine if we should not or not log, and if so where to */
-static int LogCheck(int aLevel)
+static int LogCheck(int aModule, int aLevel)
 {
     int r;
 
+    assert(aModule >= 0 && aModule < OTBR_LOG_MODULE_COUNT);
     assert(aLevel >= LOG_EMERG && aLevel <= LOG_DEBUG);
 
     r = 0;
 
-    if (sSyslogOpened && sSyslogEnabled && (aLevel <= sLevel))
+    if (sSyslogOpened && sSyslogEnabled && (aLevel <= sModuleLevel[aModule]))
     {
         r = r | LOGFLAG_syslog;
     }
@@ -110,6 +290,11 @@ static int LogCheck(int aLevel)
     {
         r = r | LOGFLAG_file;
     }
+
+    if (sFlightRecorder.IsOpen() && (aLevel <= sModuleLevel[aModule]))
+    {
+        r = r | LOGFLAG_recorder;
+    }
     return r;
 }
 
@@ -164,13 +349,39 @@ static void LogVprintf(const char *fmt, va_list ap)
     LogString(buf);
 }
 
-/** Print to the private log file */
-static void LogPrintf(const char *fmt, ...)
+/** Append a record to the flight recorder, stamped with the wall clock time */
+static void RecordVprintf(const char *aFormat, va_list ap)
+{
+    char          buf[kLogTimestampSize + kLogMaxRecordSize];
+    unsigned long now = ot::BorderRouter::GetNow();
+    int           length;
+    int           rval;
+
+    length = snprintf(buf, sizeof(buf), "%lu.%03lu | ", (now / 1000), (now % 1000));
+    rval   = vsnprintf(buf + length, sizeof(buf) - static_cast<size_t>(length), aFormat, ap);
+
+    if (rval > 0)
+    {
+        length += rval;
+    }
+
+    /* records do not end with a NEWLINE, we add one here, truncated records included */
+    if (length > static_cast<int>(sizeof(buf)) - 1)
+    {
+        length = static_cast<int>(sizeof(buf)) - 1;
+    }
+    buf[length++] = '\n';
+
+    sFlightRecorder.Write(buf, static_cast<size_t>(length));
+}
+
+/** Append a record to the flight recorder */
+static void RecordPrintf(const char *aFormat, ...)
 {
     va_list ap;
 
-    va_start(ap, fmt);
-    LogVprintf(fmt, ap);
+    va_start(ap, aFormat);
+    RecordVprintf(aFormat, ap);
     va_end(ap);
 }
 
@@ -188,27 +399,67 @@ void otbrLogInit(const char *aIdent, int aLevel, bool aPrintStderr)
         sSyslogOpened = true;
         openlog(aIdent, (LOG_CONS | LOG_PID) | (aPrintStderr ? LOG_PERROR : 0), LOG_USER);
     }
-    sLevel = aLevel;
+    otbrLogSetLevel(aLevel);
 }
 
 /** log to the syslog or log file */
-void otbrLog(int aLevel, const char *aFormat, ...)
+void otbrLogPrint(int aModule, int aLevel, const char *aFormat, ...)
 {
     va_list ap;
 
     va_start(ap, aFormat);
-    otbrLogv(aLevel, aFormat, ap);
+    otbrLogvPrint(aModule, aLevel, aFormat, ap);
     va_end(ap);
 }
 
+/** log to the syslog or log file, dropping repeats and bursts of the call site */
+void otbrLogRateLimitedPrint(int aModule, int aLevel, const char *aFile, int aLine, const char *aFormat, ...)
+{
+    std::lock_guard<std::recursive_mutex> lock(sLogMutex);
+    char                                  buf[kLogMaxMessageSize];
+    va_list                               ap;
+    uint32_t                              hash;
+    unsigned long                         now  = GetMsecsNow();
+    LogSite &                             site = FindLogSite(aFile, aLine);
+
+    va_start(ap, aFormat);
+    vsnprintf(buf, sizeof(buf), aFormat, ap);
+    va_end(ap);
+
+    hash = HashString(buf);
+
+    if (site.mCount == 0 || now - site.mWindowStart >= kLogRateInterval)
+    {
+        site.mWindowStart = now;
+        site.mCount       = 0;
+    }
+    else if (hash == site.mLastHash || site.mCount >= kLogRateBurst)
+    {
+        site.mSuppressed++;
+        return;
+    }
+
+    if (site.mSuppressed > 0)
+    {
+        LogSuppressed(site);
+    }
+
+    site.mModule   = aModule;
+    site.mLevel    = aLevel;
+    site.mLastHash = hash;
+    site.mCount++;
+    otbrLogPrint(aModule, aLevel, "%s", buf);
+}
+
 /** log to the syslog or log file */
-void otbrLogv(int aLevel, const char *aFormat, va_list ap)
+void otbrLogvPrint(int aModule, int aLevel, const char *aFormat, va_list ap)
 {
-    int r;
+    std::lock_guard<std::recursive_mutex> lock(sLogMutex);
+    int                                   r;
 
     assert(aFormat);
 
-    r = LogCheck(aLevel);
+    r = LogCheck(aModule, aLevel);
 
     if (r & LOGFLAG_file)
     {
@@ -221,68 +472,126 @@ void otbrLogv(int aLevel, const char *aFormat, va_list ap)
         LogString("\n");
     }
 
+    if (r & LOGFLAG_recorder)
+    {
+        va_list cpy;
+        va_copy(cpy, ap);
+        RecordVprintf(aFormat, cpy);
+        va_end(cpy);
+    }
+
     if (r & LOGFLAG_syslog)
     {
         vsyslog(aLevel, aFormat, ap);
     }
 }
 
+/** Encode a hex dump line as "PREFIX: ADDR: XX XX XX ...", returns the end of the line */
+static char *DumpLine(char *         aOut,
+                      const char *   aPrefix,
+                      size_t         aPrefixLength,
+                      size_t         aAddr,
+                      const uint8_t *aData,
+                      size_t         aSize)
+{
+    int digits = 4;
+
+    memcpy(aOut, aPrefix, aPrefixLength);
+    aOut += aPrefixLength;
+    *aOut++ = ':';
+    *aOut++ = ' ';
+
+    /* at least 4 digits like %04x, the 2nd character of "0x " is the digit of nibble x */
+    while (digits < 8 && (aAddr >> (digits * 4)) != 0)
+    {
+        digits++;
+    }
+
+    for (int i = digits - 1; i >= 0; i--)
+    {
+        *aOut++ = kHexTable[((aAddr >> (i * 4)) & 0x0f) * 3 + 1];
+    }
+    *aOut++ = ':';
+
+    for (size_t i = 0; i < aSize; i++)
+    {
+        *aOut++ = ' ';
+        memcpy(aOut, &kHexTable[aData[i] * 3], 2);
+        aOut += 2;
+    }
+
+    return aOut;
+}
+
+/** Write a complete multi-line record to the enabled outputs */
+static void DumpRecord(int aFlags, int aLevel, const char *aRecord)
+{
+    if (aFlags & LOGFLAG_syslog)
+    {
+        syslog(aLevel, "%s", aRecord);
+    }
+    if (aFlags & LOGFLAG_file)
+    {
+        LogString(aRecord);
+        LogString("\n");
+    }
+    if (aFlags & LOGFLAG_recorder)
+    {
+        RecordPrintf("%s", aRecord);
+    }
+}
+
 /** Hex dump data to the log */
-void otbrDump(int aLevel, const char *aPrefix, const void *aMemory, size_t aSize)
+void otbrDumpPrint(int aModule, int aLevel, const char *aPrefix, const void *aMemory, size_t aSize)
 {
     assert(aPrefix && (aMemory || aSize == 0));
-    const uint8_t *pEnd;
-    const uint8_t *p8;
+    const uint8_t *data = static_cast<const uint8_t *>(aMemory);
+    size_t         prefixLength;
+    size_t         lineSize;
+    char           record[kLogMaxRecordSize];
+    char *         end = record;
     int            r;
-    int            addr;
 
-    r = LogCheck(aLevel);
+    r = LogCheck(aModule, aLevel);
     if (r == 0)
     {
         return;
     }
 
-    /* break hex dumps into 16byte lines
-     * In the form ADDR: XX XX XX XX ...
-     */
+    std::lock_guard<std::recursive_mutex> lock(sLogMutex);
 
-    // we pre-increment... so subtract
-    addr = -16;
+    prefixLength = strnlen(aPrefix, kDumpMaxPrefixSize);
 
-    while (aSize > 0)
-    {
-        size_t this_size;
-        char   hex[16 * 3 + 1];
+    /* PREFIX: ADDR: and 3 characters per byte, plus a NEWLINE or the terminating NUL */
+    lineSize = prefixLength + sizeof(": 00000000:") + kDumpBytesPerLine * 3;
 
-        addr = addr + 16;
-        p8   = (const uint8_t *)(aMemory) + addr;
+    /* break hex dumps into 16byte lines, emitted as few records as possible
+     * In the form PREFIX: ADDR: XX XX XX XX ...
+     */
+    for (size_t addr = 0; addr < aSize; addr += kDumpBytesPerLine)
+    {
+        size_t length = aSize - addr;
 
-        /* truncate line to max 16 bytes */
-        this_size = aSize;
-        if (this_size > 16)
+        if (length > kDumpBytesPerLine)
         {
-            this_size = 16;
+            length = kDumpBytesPerLine;
         }
-        aSize = aSize - this_size;
-
-        char *ch = hex - 1;
 
-        for (pEnd = p8 + this_size; p8 < pEnd; p8++)
+        if (end != record && static_cast<size_t>(end - record) + lineSize > sizeof(record))
         {
-            *++ch = kHexChars[(*p8) >> 4];
-            *++ch = kHexChars[(*p8) & 0x0f];
-            *++ch = ' ';
+            end[-1] = 0;
+            DumpRecord(r, aLevel, record);
+            end = record;
         }
-        *ch = 0;
 
-        if (r & LOGFLAG_syslog)
-        {
-            syslog(aLevel, "%s: %04x: %s", aPrefix, addr, hex);
-        }
-        if (r & LOGFLAG_file)
-        {
-            LogPrintf("%s: %04x: %s\n", aPrefix, addr, hex);
-        }
+        end    = DumpLine(end, aPrefix, prefixLength, addr, data + addr, length);
+        *end++ = '\n';
+    }
+
+    if (end != record)
+    {
+        end[-1] = 0;
+        DumpRecord(r, aLevel, record);
     }
 }
 
@@ -319,13 +628,28 @@ const char *otbrErrorString(otbrError aError)
     return error;
 }
 
-void otbrLogResult(const char *aAction, otbrError aError)
+void otbrLogResultPrint(int aModule, const char *aAction, otbrError aError)
 {
-    otbrLog((aError == OTBR_ERROR_NONE ? OTBR_LOG_INFO : OTBR_LOG_WARNING), "%s: %s", aAction, otbrErrorString(aError));
+    int level = (aError == OTBR_ERROR_NONE ? OTBR_LOG_INFO : OTBR_LOG_WARNING);
+
+    if (otbrLogIsEnabled(aModule, level))
+    {
+        otbrLogPrint(aModule, level, "%s: %s", aAction, otbrErrorString(aError));
+    }
 }
 
 void otbrLogDeinit(void)
 {
+    for (size_t i = 0; i < kLogSiteTableSize; i++)
+    {
+        if (sLogSites[i].mFile != NULL && sLogSites[i].mSuppressed > 0)
+        {
+            LogSuppressed(sLogSites[i]);
+        }
+    }
+
     sSyslogOpened = false;
+    sFlightRecorder.Close();
+    UpdateThresholds();
     closelog();
 }
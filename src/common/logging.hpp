@@ -29,6 +29,10 @@
 #ifndef LOGGING_HPP_
 #define LOGGING_HPP_
 
+#if HAVE_CONFIG_H
+#include "otbr-config.h"
+#endif
+
 #include "types.hpp"
 #include <stdarg.h>
 #include <stddef.h>
@@ -50,7 +54,64 @@ enum
 };
 
 /**
- * Change the log level
+ * Logging module, each of which has its own log level.
+ *
+ */
+enum
+{
+    OTBR_LOG_MODULE_AGENT,        /* border agent, NCP and everything else */
+    OTBR_LOG_MODULE_DTLS,         /* DTLS service */
+    OTBR_LOG_MODULE_COAP,         /* CoAP service */
+    OTBR_LOG_MODULE_MDNS,         /* MDNS publisher */
+    OTBR_LOG_MODULE_COMMISSIONER, /* commissioner and joiner session */
+    OTBR_LOG_MODULE_WEB,          /* web service */
+    OTBR_LOG_MODULE_COUNT,        /* number of modules */
+};
+
+/**
+ * The most verbose log level compiled in.
+ *
+ * Log calls less severe than this level are removed at compile time, including the evaluation of their arguments.
+ *
+ */
+#ifndef OTBR_LOG_LEVEL_COMPILED
+#define OTBR_LOG_LEVEL_COMPILED OTBR_LOG_DEBUG
+#endif
+
+/**
+ * The module of the current translation unit.
+ *
+ * Define it before including any header if the source file belongs to a module other than the agent.
+ *
+ */
+#ifndef OTBR_LOG_MODULE
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_AGENT
+#endif
+
+/**
+ * The effective log level of each module, taking all log outputs into account.
+ *
+ * @note This is an implementation detail of otbrLogIsEnabled(), use otbrLogSetModuleLevel() to change it.
+ *
+ */
+extern int gOtbrLogThreshold[OTBR_LOG_MODULE_COUNT];
+
+/**
+ * This function returns whether a log at level @p aLevel of module @p aModule would be written anywhere.
+ *
+ * @param[in]   aModule     The log module.
+ * @param[in]   aLevel      The log level.
+ *
+ * @returns Whether the log is enabled.
+ *
+ */
+inline bool otbrLogIsEnabled(int aModule, int aLevel)
+{
+    return aLevel <= OTBR_LOG_LEVEL_COMPILED && aLevel <= gOtbrLogThreshold[aModule];
+}
+
+/**
+ * Change the log level of all modules
  *
  * @param[in]   alevel  new log level
  */
@@ -62,6 +123,25 @@ void otbrLogSetLevel(int aLevel);
  */
 int otbrLogGetLevel(void);
 
+/**
+ * This function changes the log level of a single module.
+ *
+ * @param[in]   aModule     The log module.
+ * @param[in]   aLevel      New log level of @p aModule.
+ *
+ */
+void otbrLogSetModuleLevel(int aModule, int aLevel);
+
+/**
+ * This function returns the log level of a single module.
+ *
+ * @param[in]   aModule     The log module.
+ *
+ * @returns The log level of @p aModule.
+ *
+ */
+int otbrLogGetModuleLevel(int aModule);
+
 /**
  * Control log to syslog
  *
@@ -78,6 +158,20 @@ void otbrLogEnableSyslog(bool aEnabled);
  */
 void otbrLogSetFilename(const char *aFilename);
 
+/**
+ * This function causes logs to be recorded to a flight recorder file.
+ *
+ * The file holds the last @p aSize bytes of records in a ring mapped into memory, so recording does not make
+ * system calls and the records are still in the file after a crash. Records are filtered by the module levels.
+ * Use the `flight-recorder` tool to extract them.
+ * Note: Logs are still written to the syslog.
+ *
+ * @param[in]   aFilename   Filename of the flight recorder, NULL to stop recording.
+ * @param[in]   aSize       Size of the ring in bytes.
+ *
+ */
+void otbrLogSetFlightRecorder(const char *aFilename, size_t aSize);
+
 /**
  * This function initialize the logging service.
  *
@@ -89,16 +183,71 @@ void otbrLogSetFilename(const char *aFilename);
 void otbrLogInit(const char *aIdent, int aLevel, bool aPrintStderr);
 
 /**
- * This function log at level @p aLevel.
+ * This function log at level @p aLevel of module @p aModule.
  *
+ * @note Use otbrLog() instead, which skips evaluating arguments of filtered logs.
+ *
+ * @param[in]   aModule The log module.
+ * @param[in]   aLevel  Log level of the logger.
+ * @param[in]   aFormat Format string as in printf.
+ *
+ */
+void otbrLogPrint(int aModule, int aLevel, const char *aFormat, ...);
+
+/**
+ * This macro log at level @p aLevel.
+ *
+ * @param[in]   aLevel  Log level of the logger.
+ * @param[in]   ...     Format string as in printf, followed by its arguments.
+ *
+ */
+#define otbrLog(aLevel, ...) \
+    (otbrLogIsEnabled(OTBR_LOG_MODULE, (aLevel)) ? otbrLogPrint(OTBR_LOG_MODULE, (aLevel), __VA_ARGS__) : (void)0)
+
+/**
+ * This function log at level @p aLevel of module @p aModule, rate limited per call site.
+ *
+ * @note Use otbrLogRateLimited() instead.
+ *
+ * @param[in]   aModule The log module.
  * @param[in]   aLevel  Log level of the logger.
+ * @param[in]   aFile   The source file of the call site.
+ * @param[in]   aLine   The source line of the call site.
  * @param[in]   aFormat Format string as in printf.
  *
  */
-void otbrLog(int aLevel, const char *aFormat, ...);
+void otbrLogRateLimitedPrint(int aModule, int aLevel, const char *aFile, int aLine, const char *aFormat, ...);
+
+/**
+ * This macro log at level @p aLevel, rate limited per call site.
+ *
+ * Repeats of the previous message from the same call site and messages beyond the per call site burst are
+ * suppressed within a rate limit interval. The number of suppressed messages is logged along with the next
+ * message that passes.
+ *
+ * @param[in]   aLevel  Log level of the logger.
+ * @param[in]   ...     Format string as in printf, followed by its arguments.
+ *
+ */
+#define otbrLogRateLimited(aLevel, ...)                                                         \
+    (otbrLogIsEnabled(OTBR_LOG_MODULE, (aLevel))                                                \
+         ? otbrLogRateLimitedPrint(OTBR_LOG_MODULE, (aLevel), __FILE__, __LINE__, __VA_ARGS__) \
+         : (void)0)
+
+/**
+ * This function log a action result according to @p aError of module @p aModule.
+ *
+ * @note Use otbrLogResult() instead.
+ *
+ * @param[in]   aModule The log module.
+ * @param[in]   aAction The action description.
+ * @param[in]   aError  The action result.
+ *
+ */
+void otbrLogResultPrint(int aModule, const char *aAction, otbrError aError);
 
 /**
- * This function log a action result according to @p aError.
+ * This macro log a action result according to @p aError.
  *
  * If @p aError is OTBR_ERROR_NONE, the log level will be OTBR_LOG_INFO,
  * otherwise OTBR_LOG_WARNING.
@@ -107,19 +256,49 @@ void otbrLog(int aLevel, const char *aFormat, ...);
  * @param[in]   aError  The action result.
  *
  */
-void otbrLogResult(const char *aAction, otbrError aError);
+#define otbrLogResult(aAction, aError) otbrLogResultPrint(OTBR_LOG_MODULE, (aAction), (aError))
+
+/**
+ * This function log at level @p aLevel of module @p aModule.
+ *
+ * @param[in]   aModule The log module.
+ * @param[in]   aLevel  Log level of the logger.
+ * @param[in]   aFormat Format string as in printf.
+ *
+ */
+void otbrLogvPrint(int aModule, int aLevel, const char *aFormat, va_list);
 
 /**
- * This function log at level @p aLevel.
+ * This macro log at level @p aLevel.
  *
  * @param[in]   aLevel  Log level of the logger.
  * @param[in]   aFormat Format string as in printf.
+ * @param[in]   aArgs   The va_list of arguments.
+ *
+ */
+#define otbrLogv(aLevel, aFormat, aArgs)                                                                       \
+    (otbrLogIsEnabled(OTBR_LOG_MODULE, (aLevel)) ? otbrLogvPrint(OTBR_LOG_MODULE, (aLevel), (aFormat), (aArgs)) \
+                                                 : (void)0)
+
+/**
+ * This function dump memory as hex string at level @p aLevel of module @p aModule.
+ *
+ * The dump is logged as a single multi-line record of 16 bytes per line, only dumps larger than about 4KB are split
+ * into several records.
+ *
+ * @note Use otbrDump() instead, which skips evaluating arguments of filtered dumps.
+ *
+ * @param[in]   aModule The log module.
+ * @param[in]   aLevel  Log level of the logger.
+ * @param[in]   aPrefix String before dumping memory.
+ * @param[in]   aMemory The pointer to the memory to be dumped.
+ * @param[in]   aSize   The size of memory in bytes to be dumped.
  *
  */
-void otbrLogv(int aLevel, const char *aFormat, va_list);
+void otbrDumpPrint(int aModule, int aLevel, const char *aPrefix, const void *aMemory, size_t aSize);
 
 /**
- * This function dump memory as hex string at level @p aLevel.
+ * This macro dump memory as hex string at level @p aLevel.
  *
  * @param[in]   aLevel  Log level of the logger.
  * @param[in]   aPrefix String before dumping memory.
@@ -127,7 +306,10 @@ void otbrLogv(int aLevel, const char *aFormat, va_list);
  * @param[in]   aSize   The size of memory in bytes to be dumped.
  *
  */
-void otbrDump(int aLevel, const char *aPrefix, const void *aMemory, size_t aSize);
+#define otbrDump(aLevel, aPrefix, aMemory, aSize)                                                      \
+    (otbrLogIsEnabled(OTBR_LOG_MODULE, (aLevel))                                                       \
+         ? otbrDumpPrint(OTBR_LOG_MODULE, (aLevel), (aPrefix), (aMemory), static_cast<size_t>(aSize)) \
+         : (void)0)
 
 /**
  * This function converts error code to string.
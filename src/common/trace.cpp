@@ -0,0 +1,207 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements span tracing.
+ */
+
+#include "trace.hpp"
+
+#include <atomic>
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "code_utils.hpp"
+
+/** A recorded trace event */
+struct TraceEvent
+{
+    std::atomic<uint64_t> mSequence; ///< Index of the event plus 1, 0 while the event is being written.
+    const char *          mCategory;
+    const char *          mName;
+    uint64_t              mId;
+    uint64_t              mTimestamp;
+    uint64_t              mDuration;
+    long                  mThread;
+    char                  mPhase;
+};
+
+bool gOtbrTraceEnabled = false;
+
+static TraceEvent *          sEvents;
+static size_t                sCapacity;
+static std::atomic<uint64_t> sNextIndex(0);
+
+/** Returns the kernel thread id of the calling thread, so events of each thread go to their own track */
+static long GetThreadId(void)
+{
+    static thread_local long sThreadId = 0;
+
+    if (sThreadId == 0)
+    {
+        sThreadId = syscall(SYS_gettid);
+    }
+
+    return sThreadId;
+}
+
+void otbrTraceInit(size_t aCapacity)
+{
+    assert(aCapacity > 0 && (aCapacity & (aCapacity - 1)) == 0);
+
+    otbrTraceDeinit();
+
+    sEvents   = new TraceEvent[aCapacity]();
+    sCapacity = aCapacity;
+    sNextIndex.store(0);
+    gOtbrTraceEnabled = true;
+}
+
+void otbrTraceDeinit(void)
+{
+    gOtbrTraceEnabled = false;
+    delete[] sEvents;
+    sEvents   = NULL;
+    sCapacity = 0;
+}
+
+uint64_t otbrTraceNow(void)
+{
+    timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000 + static_cast<uint64_t>(now.tv_nsec) / 1000;
+}
+
+void otbrTraceRecord(char        aPhase,
+                     const char *aCategory,
+                     const char *aName,
+                     uint64_t    aId,
+                     uint64_t    aTimestamp,
+                     uint64_t    aDuration)
+{
+    uint64_t    index;
+    TraceEvent *event;
+
+    VerifyOrExit(sEvents != NULL);
+
+    // claim a slot, the oldest event is overwritten once the buffer is full
+    index = sNextIndex.fetch_add(1, std::memory_order_relaxed);
+    event = &sEvents[index & (sCapacity - 1)];
+
+    event->mSequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event->mCategory  = aCategory;
+    event->mName      = aName;
+    event->mId        = aId;
+    event->mTimestamp = aTimestamp;
+    event->mDuration  = aDuration;
+    event->mThread    = GetThreadId();
+    event->mPhase     = aPhase;
+    event->mSequence.store(index + 1, std::memory_order_release);
+
+exit:
+    return;
+}
+
+otbrError otbrTraceExport(const char *aFilename)
+{
+    otbrError error = OTBR_ERROR_ERRNO;
+    FILE *    fp    = NULL;
+    uint64_t  end   = sNextIndex.load(std::memory_order_acquire);
+    uint64_t  begin = (end > sCapacity ? end - sCapacity : 0);
+    bool      first = true;
+    int       pid   = static_cast<int>(getpid());
+
+    VerifyOrExit(sEvents != NULL, errno = EINVAL);
+    VerifyOrExit((fp = fopen(aFilename, "w")) != NULL);
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (uint64_t index = begin; index < end; index++)
+    {
+        const TraceEvent &slot = sEvents[index & (sCapacity - 1)];
+        TraceEvent        event;
+
+        // skip events being written or already overwritten
+        if (slot.mSequence.load(std::memory_order_acquire) != index + 1)
+        {
+            continue;
+        }
+
+        event.mCategory  = slot.mCategory;
+        event.mName      = slot.mName;
+        event.mId        = slot.mId;
+        event.mTimestamp = slot.mTimestamp;
+        event.mDuration  = slot.mDuration;
+        event.mThread    = slot.mThread;
+        event.mPhase     = slot.mPhase;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.mSequence.load(std::memory_order_relaxed) != index + 1)
+        {
+            continue;
+        }
+
+        fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%" PRIu64 ",\"pid\":%d,\"tid\":%ld",
+                (first ? "" : ","), event.mName, event.mCategory, event.mPhase, event.mTimestamp, pid, event.mThread);
+
+        // complete spans are matched by thread, async ones by category and id
+        if (event.mPhase == 'X')
+        {
+            fprintf(fp, ",\"dur\":%" PRIu64 ",\"args\":{\"id\":\"0x%" PRIx64 "\"}", event.mDuration, event.mId);
+        }
+        else
+        {
+            fprintf(fp, ",\"id\":\"0x%" PRIx64 "\"", event.mId);
+        }
+
+        fprintf(fp, "}");
+        first = false;
+    }
+
+    fprintf(fp, "\n]}\n");
+    VerifyOrExit(!ferror(fp));
+
+    error = OTBR_ERROR_NONE;
+
+exit:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        error = OTBR_ERROR_ERRNO;
+    }
+
+    return error;
+}
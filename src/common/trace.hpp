@@ -0,0 +1,199 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file includes definitions for span tracing, exported in Chrome trace event format.
+ */
+
+#ifndef TRACE_HPP_
+#define TRACE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.hpp"
+
+/**
+ * Whether tracing is enabled.
+ *
+ * @note This is an implementation detail of the trace macros, use otbrTraceInit() to enable tracing.
+ *
+ */
+extern bool gOtbrTraceEnabled;
+
+/**
+ * This function enables tracing, keeping the last @p aCapacity events in memory.
+ *
+ * @param[in]   aCapacity   Number of events kept, must be a power of 2.
+ *
+ */
+void otbrTraceInit(size_t aCapacity);
+
+/**
+ * This function disables tracing and frees the recorded events.
+ *
+ */
+void otbrTraceDeinit(void);
+
+/**
+ * This function returns the trace clock, a monotonic time in microseconds.
+ *
+ * @returns The trace clock in microseconds.
+ *
+ */
+uint64_t otbrTraceNow(void);
+
+/**
+ * This function records a trace event.
+ *
+ * It is lock free and may be called from any thread.
+ *
+ * @note Use the trace macros instead, which skip it when tracing is disabled.
+ *
+ * @param[in]   aPhase      The Chrome trace event phase, 'b' and 'e' for span begin and end, 'n' for an instant and
+ *                          'X' for a complete span.
+ * @param[in]   aCategory   Category of the event, must be a string literal.
+ * @param[in]   aName       Name of the event, must be a string literal.
+ * @param[in]   aId         Correlation id, spans of the same category and id are shown on the same track.
+ * @param[in]   aTimestamp  Timestamp of the event from otbrTraceNow().
+ * @param[in]   aDuration   Duration of a complete span in microseconds.
+ *
+ */
+void otbrTraceRecord(char        aPhase,
+                     const char *aCategory,
+                     const char *aName,
+                     uint64_t    aId,
+                     uint64_t    aTimestamp,
+                     uint64_t    aDuration);
+
+/**
+ * This function exports the recorded events as Chrome trace JSON, which can be opened by chrome://tracing and Perfetto.
+ *
+ * @param[in]   aFilename   The file to write.
+ *
+ * @retval OTBR_ERROR_NONE      Successfully exported the events.
+ * @retval OTBR_ERROR_ERRNO     Failed to write the file.
+ *
+ */
+otbrError otbrTraceExport(const char *aFilename);
+
+/**
+ * This macro begins a span which may end in another function.
+ *
+ * @param[in]   aCategory   Category of the span.
+ * @param[in]   aName       Name of the span.
+ * @param[in]   aId         Correlation id of the span, e.g. a session or joiner IID.
+ *
+ */
+#define otbrTraceBegin(aCategory, aName, aId) \
+    (gOtbrTraceEnabled ? otbrTraceRecord('b', (aCategory), (aName), (aId), otbrTraceNow(), 0) : (void)0)
+
+/**
+ * This macro ends a span begun by otbrTraceBegin() with the same category, name and id.
+ *
+ * @param[in]   aCategory   Category of the span.
+ * @param[in]   aName       Name of the span.
+ * @param[in]   aId         Correlation id of the span.
+ *
+ */
+#define otbrTraceEnd(aCategory, aName, aId) \
+    (gOtbrTraceEnabled ? otbrTraceRecord('e', (aCategory), (aName), (aId), otbrTraceNow(), 0) : (void)0)
+
+/**
+ * This macro records an instant event.
+ *
+ * @param[in]   aCategory   Category of the event.
+ * @param[in]   aName       Name of the event.
+ * @param[in]   aId         Correlation id of the event.
+ *
+ */
+#define otbrTraceInstant(aCategory, aName, aId) \
+    (gOtbrTraceEnabled ? otbrTraceRecord('n', (aCategory), (aName), (aId), otbrTraceNow(), 0) : (void)0)
+
+namespace ot {
+
+namespace BorderRouter {
+
+/**
+ * This class records a span covering its own lifetime.
+ *
+ */
+class TraceScope
+{
+public:
+    /**
+     * The constructor to begin the span.
+     *
+     * @param[in]   aCategory   Category of the span, must be a string literal.
+     * @param[in]   aName       Name of the span, must be a string literal.
+     * @param[in]   aId         Correlation id of the span.
+     *
+     */
+    TraceScope(const char *aCategory, const char *aName, uint64_t aId = 0)
+        : mCategory(aCategory)
+        , mName(aName)
+        , mId(aId)
+        , mBegin(gOtbrTraceEnabled ? otbrTraceNow() : 0)
+    {
+    }
+
+    /**
+     * The destructor to end the span.
+     *
+     */
+    ~TraceScope(void)
+    {
+        if (gOtbrTraceEnabled && mBegin != 0)
+        {
+            uint64_t now = otbrTraceNow();
+
+            otbrTraceRecord('X', mCategory, mName, mId, mBegin, now - mBegin);
+        }
+    }
+
+    /**
+     * This method sets the correlation id when it is only known inside the span.
+     *
+     * @param[in]   aId     Correlation id of the span.
+     *
+     */
+    void SetId(uint64_t aId) { mId = aId; }
+
+private:
+    const char *mCategory;
+    const char *mName;
+    uint64_t    mId;
+    uint64_t    mBegin;
+};
+
+} // namespace BorderRouter
+
+} // namespace ot
+
+#endif // TRACE_HPP_
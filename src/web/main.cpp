@@ -30,6 +30,8 @@
  * @file
  *   This file is the entry of the program, it starts a Web service.
  */
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_WEB
+
 #ifndef OT_WEB_FILE_PATH
 #define OT_WEB_FILE_PATH "/usr/local/share/border-router/frontend"
 #endif
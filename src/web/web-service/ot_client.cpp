@@ -1,3 +1,5 @@
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_WEB
+
 #include "ot_client.hpp"
 
 #include <openthread/platform/toolchain.h>
@@ -31,6 +31,8 @@
  *   This file implements the wpan controller service
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_WEB
+
 #include "wpan_service.hpp"
 
 #include <inttypes.h>
@@ -32,6 +32,8 @@
  *
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_WEB
+
 #include "common/code_utils.hpp"
 #include "utils/strcpy_utils.hpp"
 
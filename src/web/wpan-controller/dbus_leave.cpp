@@ -31,6 +31,8 @@
  *   This file implements "leave" Thread Network function.
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_WEB
+
 #include "common/code_utils.hpp"
 
 #include "dbus_leave.hpp"
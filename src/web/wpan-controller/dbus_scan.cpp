@@ -31,6 +31,8 @@
  *   This file implements "scan" Thread Network function.
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_WEB
+
 #include "common/code_utils.hpp"
 
 #include "dbus_scan.hpp"
@@ -31,6 +31,8 @@
  *   This file provides DBus operations APIs for other modules to control the WPAN interface.
  */
 
+#define OTBR_LOG_MODULE OTBR_LOG_MODULE_WEB
+
 #include <ctype.h>
 #include <inttypes.h>
 #include <stdio.h>
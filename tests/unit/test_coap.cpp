@@ -34,7 +34,13 @@
 #include <string.h>
 #include <sys/socket.h>
 
+#include <algorithm>
+#include <deque>
+#include <vector>
+
 #include "common/coap.hpp"
+#include "common/coap_native.hpp"
+#include "common/time.hpp"
 
 using namespace ot::BorderRouter;
 
@@ -66,12 +72,13 @@ void TestRequestHandler(const Coap::Resource &aResource,
     (void)aContext;
 }
 
-void TestResponseHandler(const Coap::Message &aMessage, void *aContext)
+void TestResponseHandler(const Coap::Message *aMessage, otbrError aError, void *aContext)
 {
     TestContext &context = *static_cast<TestContext *>(aContext);
 
     context.mResponseHandled = true;
-    (void)aMessage;
+    CHECK(aMessage != NULL);
+    CHECK_EQUAL(OTBR_ERROR_NONE, aError);
 }
 
 ssize_t TestNetworkSender(const uint8_t *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort, void *aContext)
@@ -167,3 +174,1028 @@ TEST(Coap, TestRequest)
 
     Coap::Agent::Destroy(agent);
 }
+
+TEST(Coap, TestMessageOptions)
+{
+    Coap::MessageBuffer message;
+    const uint8_t       token[]   = {0xde, 0xad};
+    const uint8_t       content[] = {42};
+    const uint8_t       payload[] = "hello";
+    uint8_t             tokenLength;
+    uint16_t            length;
+
+    message.Init(Coap::kTypeConfirmable, Coap::kCodePost, 0x1234, token, sizeof(token));
+    message.SetPath("c/cs");
+
+    // Options must end up in the order of their numbers whatever the insertion order.
+    CHECK_EQUAL(OTBR_ERROR_NONE, message.InsertOption(12, content, sizeof(content)));
+    CHECK_EQUAL(OTBR_ERROR_NONE, message.InsertOption(3, NULL, 0));
+    message.SetPayload(payload, sizeof(payload));
+    CHECK_EQUAL(false, message.IsTruncated());
+
+    Coap::MessageBuffer parsed;
+    memcpy(parsed.GetBuffer(), message.GetBuffer(), message.GetLength());
+    CHECK_EQUAL(OTBR_ERROR_NONE, parsed.Parse(message.GetLength()));
+    CHECK_EQUAL(Coap::kTypeConfirmable, parsed.GetType());
+    CHECK_EQUAL(Coap::kCodePost, parsed.GetCode());
+    CHECK_EQUAL(0x1234, parsed.GetMessageId());
+    CHECK_EQUAL(0, memcmp(token, parsed.GetToken(tokenLength), sizeof(token)));
+    CHECK_EQUAL(sizeof(token), tokenLength);
+
+    Coap::OptionIterator option(parsed);
+    CHECK_EQUAL(3, option.GetNumber());
+    CHECK_EQUAL(0, option.GetLength());
+    option.Next();
+    CHECK_EQUAL(Coap::kOptionUriPath, option.GetNumber());
+    CHECK_EQUAL(0, memcmp("c", option.GetValue(), option.GetLength()));
+    option.Next();
+    CHECK_EQUAL(Coap::kOptionUriPath, option.GetNumber());
+    CHECK_EQUAL(0, memcmp("cs", option.GetValue(), option.GetLength()));
+    option.Next();
+    CHECK_EQUAL(12, option.GetNumber());
+    CHECK_EQUAL(42, option.GetValue()[0]);
+    option.Next();
+    CHECK_EQUAL(true, option.IsDone());
+
+    CHECK_EQUAL(0, memcmp(payload, parsed.GetPayload(length), sizeof(payload)));
+    CHECK_EQUAL(sizeof(payload), length);
+}
+
+TEST(Coap, TestMessageParseMalformed)
+{
+    Coap::MessageBuffer message;
+    const uint8_t       badVersion[]     = {0x80, 0x02, 0x00, 0x01};
+    const uint8_t       badTokenLength[] = {0x49, 0x02, 0x00, 0x01};
+    const uint8_t       badOption[]      = {0x40, 0x02, 0x00, 0x01, 0xf0};
+    const uint8_t       shortOption[]    = {0x40, 0x02, 0x00, 0x01, 0xb4, 'c'};
+    const uint8_t       emptyPayload[]   = {0x40, 0x02, 0x00, 0x01, 0xb1, 'c', 0xff};
+    const uint8_t       emptyWithToken[] = {0x41, 0x00, 0x00, 0x01, 0x00};
+
+    const uint8_t *malformed[] = {badVersion, badTokenLength, badOption, shortOption, emptyPayload, emptyWithToken};
+    const size_t   lengths[]   = {sizeof(badVersion),  sizeof(badTokenLength), sizeof(badOption),
+                              sizeof(shortOption), sizeof(emptyPayload),   sizeof(emptyWithToken)};
+
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++)
+    {
+        memcpy(message.GetBuffer(), malformed[i], lengths[i]);
+        CHECK_EQUAL(OTBR_ERROR_ERRNO, message.Parse(static_cast<uint16_t>(lengths[i])));
+        CHECK_EQUAL(EBADMSG, errno);
+    }
+}
+
+ssize_t TestCaptureSender(const uint8_t *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort, void *aContext)
+{
+    Coap::MessageBuffer &captured = *static_cast<Coap::MessageBuffer *>(aContext);
+
+    memcpy(captured.GetBuffer(), aBuffer, aLength);
+    CHECK_EQUAL(OTBR_ERROR_NONE, captured.Parse(aLength));
+
+    (void)aIp6;
+    (void)aPort;
+    return static_cast<ssize_t>(aLength);
+}
+
+TEST(Coap, TestRequestNotFound)
+{
+    Coap::MessageBuffer request;
+    Coap::MessageBuffer response;
+
+    agent = Coap::Agent::Create(TestCaptureSender, &response);
+
+    request.Init(Coap::kTypeConfirmable, Coap::kCodePost, 0x4321, NULL, 0);
+    request.SetPath("missing");
+    agent->Input(request.GetBuffer(), request.GetLength(), NULL, 0);
+
+    CHECK_EQUAL(Coap::kTypeAcknowledgment, response.GetType());
+    CHECK_EQUAL(Coap::kCodeNotFound, response.GetCode());
+    CHECK_EQUAL(0x4321, response.GetMessageId());
+
+    Coap::Agent::Destroy(agent);
+}
+
+TEST(Coap, TestMessagePool)
+{
+    Coap::MessagePool    pool;
+    Coap::MessageBuffer *messages[Coap::MessagePool::kSize];
+
+    for (size_t i = 0; i < Coap::MessagePool::kSize; i++)
+    {
+        messages[i] = pool.New();
+        CHECK(messages[i] != NULL);
+    }
+
+    // The pool is exhausted.
+    CHECK(pool.New() == NULL);
+    CHECK_EQUAL(ENOBUFS, errno);
+    CHECK_EQUAL(1, pool.GetStats().mAllocationFails);
+
+    pool.Free(messages[0]);
+    CHECK(pool.New() == messages[0]);
+
+    for (size_t i = 0; i < Coap::MessagePool::kSize; i++)
+    {
+        pool.Free(messages[i]);
+    }
+
+    CHECK_EQUAL(0, pool.GetStats().mInUse);
+    CHECK_EQUAL(Coap::MessagePool::kSize, pool.GetStats().mMaxInUse);
+    CHECK_EQUAL(Coap::MessagePool::kSize + 1, pool.GetStats().mAllocations);
+}
+
+TEST(Coap, TestMessageHandle)
+{
+    agent = Coap::Agent::Create(NULL, NULL);
+
+    const Coap::MessagePool::Stats &stats = static_cast<Coap::AgentNative *>(agent)->GetMessagePoolStats();
+
+    {
+        Coap::MessageHandle message(*agent, agent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, NULL, 0));
+
+        CHECK(message.Get() != NULL);
+        CHECK_EQUAL(1, stats.mInUse);
+    }
+
+    // The message is freed when the handle goes out of scope.
+    CHECK_EQUAL(0, stats.mInUse);
+
+    Coap::Agent::Destroy(agent);
+}
+
+void TestRouteHandler(const Coap::Resource &aResource,
+                      const Coap::Message & aRequest,
+                      Coap::Message &       aResponse,
+                      const uint8_t *       aIp6,
+                      uint16_t              aPort,
+                      void *                aContext)
+{
+    *static_cast<const Coap::Resource **>(aContext) = &aResource;
+    aResponse.SetCode(aRequest.GetCode() == Coap::kCodeGet ? Coap::kCodeContent : Coap::kCodeChanged);
+
+    (void)aIp6;
+    (void)aPort;
+}
+
+TEST(Coap, TestRouter)
+{
+    const Coap::Resource *handled = NULL;
+    Coap::MessageBuffer   request;
+    Coap::MessageBuffer   response;
+    Coap::Resource        commissionerSet("c/cs", TestRouteHandler, &handled);
+    Coap::Resource        commissionerGet("/c/cg/", TestRouteHandler, &handled);
+    Coap::Resource        diagnostic("d/*", TestRouteHandler, &handled);
+    Coap::Resource        diagnosticGet("d/dg", TestRouteHandler, &handled);
+    Coap::Resource        duplicate("c/cg", TestRouteHandler, &handled);
+
+    struct
+    {
+        Coap::Code            mMethod;
+        const char *          mPath;
+        const Coap::Resource *mResource;
+        Coap::Code            mResponse;
+    } cases[] = {
+        {Coap::kCodePost, "c/cs", &commissionerSet, Coap::kCodeChanged},
+        {Coap::kCodeGet, "c/cg", &commissionerGet, Coap::kCodeContent},
+        {Coap::kCodePost, "c/cg", NULL, Coap::kCodeMethodNotAllowed},
+        {Coap::kCodePost, "d", &diagnostic, Coap::kCodeChanged},
+        {Coap::kCodePost, "d/dr/x", &diagnostic, Coap::kCodeChanged},
+        {Coap::kCodePost, "d/dg", &diagnosticGet, Coap::kCodeChanged},
+        {Coap::kCodePost, "c", NULL, Coap::kCodeNotFound},
+        {Coap::kCodePost, "c/cs/x", NULL, Coap::kCodeNotFound},
+    };
+
+    commissionerGet.SetHandler(Coap::kCodePost, NULL);
+    commissionerGet.SetHandler(Coap::kCodeGet, TestRouteHandler);
+
+    agent = Coap::Agent::Create(TestCaptureSender, &response);
+
+    CHECK_EQUAL(OTBR_ERROR_NONE, agent->AddResource(commissionerSet));
+    CHECK_EQUAL(OTBR_ERROR_NONE, agent->AddResource(commissionerGet));
+    CHECK_EQUAL(OTBR_ERROR_NONE, agent->AddResource(diagnostic));
+    CHECK_EQUAL(OTBR_ERROR_NONE, agent->AddResource(diagnosticGet));
+
+    // Resources with the same path are not allowed.
+    CHECK_EQUAL(OTBR_ERROR_ERRNO, agent->AddResource(duplicate));
+    CHECK_EQUAL(EEXIST, errno);
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        handled = NULL;
+        request.Init(Coap::kTypeConfirmable, cases[i].mMethod, static_cast<uint16_t>(i), NULL, 0);
+        request.SetPath(cases[i].mPath);
+        agent->Input(request.GetBuffer(), request.GetLength(), NULL, 0);
+
+        CHECK(cases[i].mResource == handled);
+        CHECK_EQUAL(cases[i].mResponse, response.GetCode());
+    }
+
+    // A new message id, reusing one would be taken as a duplicate.
+    CHECK_EQUAL(OTBR_ERROR_NONE, agent->RemoveResource(diagnosticGet));
+    request.Init(Coap::kTypeConfirmable, Coap::kCodePost, 0x100, NULL, 0);
+    request.SetPath("d/dg");
+    agent->Input(request.GetBuffer(), request.GetLength(), NULL, 0);
+    CHECK(&diagnostic == handled);
+
+    Coap::Agent::Destroy(agent);
+}
+
+struct RetransmitContext
+{
+    int       mTransmitCount;
+    int       mResponseCount;
+    otbrError mError;
+    int       mErrno;
+    int       mBusyCount; ///< Number of transmissions to fail with EAGAIN.
+};
+
+ssize_t TestCountSender(const uint8_t *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort, void *aContext)
+{
+    RetransmitContext &context = *static_cast<RetransmitContext *>(aContext);
+    ssize_t            ret     = static_cast<ssize_t>(aLength);
+
+    context.mTransmitCount++;
+
+    if (context.mBusyCount > 0)
+    {
+        context.mBusyCount--;
+        errno = EAGAIN;
+        ret   = -1;
+    }
+
+    (void)aBuffer;
+    (void)aIp6;
+    (void)aPort;
+    return ret;
+}
+
+void TestTimeoutHandler(const Coap::Message *aMessage, otbrError aError, void *aContext)
+{
+    RetransmitContext &context = *static_cast<RetransmitContext *>(aContext);
+
+    context.mResponseCount++;
+    context.mError = aError;
+    context.mErrno = errno;
+    CHECK(aMessage == NULL);
+}
+
+TEST(Coap, TestRetransmit)
+{
+    RetransmitContext context = {0, 0, OTBR_ERROR_NONE, 0, 0};
+    unsigned long     now     = ot::BorderRouter::GetNow();
+    unsigned long     timeout;
+
+    agent = Coap::Agent::Create(TestCountSender, &context);
+
+    {
+        Coap::AgentNative & native = *static_cast<Coap::AgentNative *>(agent);
+        Coap::MessageHandle message(*agent, agent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, NULL, 0));
+        Coap::MessageBuffer ack;
+
+        message->SetPath("c/cp");
+        CHECK_EQUAL(OTBR_ERROR_NONE, agent->Send(*message, NULL, 0, TestTimeoutHandler, &context));
+        CHECK_EQUAL(1, context.mTransmitCount);
+
+        // The first retransmission is due between ACK_TIMEOUT and ACK_TIMEOUT * ACK_RANDOM_FACTOR.
+        CHECK(native.GetNextTimeout(timeout));
+        CHECK(timeout - now >= 2000 && timeout - now <= 3000 + 100);
+
+        native.HandleTimers(timeout - 1);
+        CHECK_EQUAL(1, context.mTransmitCount);
+
+        // Retransmitted MAX_RETRANSMIT times, then timed out.
+        for (int i = 0; i < 4; i++)
+        {
+            CHECK(native.GetNextTimeout(timeout));
+            native.HandleTimers(timeout);
+            CHECK_EQUAL(2 + i, context.mTransmitCount);
+            CHECK_EQUAL(0, context.mResponseCount);
+        }
+
+        CHECK(native.GetNextTimeout(timeout));
+        native.HandleTimers(timeout);
+        CHECK_EQUAL(5, context.mTransmitCount);
+        CHECK_EQUAL(1, context.mResponseCount);
+        CHECK_EQUAL(OTBR_ERROR_ERRNO, context.mError);
+        CHECK_EQUAL(ETIMEDOUT, context.mErrno);
+        CHECK_EQUAL(false, native.GetNextTimeout(timeout));
+
+        // An acknowledgment stops retransmission.
+        CHECK_EQUAL(OTBR_ERROR_NONE, agent->Send(*message, NULL, 0, NULL, NULL));
+        ack.Init(Coap::kTypeAcknowledgment, Coap::kCodeEmpty,
+                 static_cast<const Coap::MessageNative &>(*message).GetMessageId(), NULL, 0);
+        agent->Input(ack.GetBuffer(), ack.GetLength(), NULL, 0);
+        CHECK_EQUAL(false, native.GetNextTimeout(timeout));
+        CHECK_EQUAL(1, native.GetMessagePoolStats().mInUse);
+
+        // A confirmable message the busy link refused is sent by its first retransmission.
+        context.mTransmitCount = 0;
+        context.mBusyCount     = 1;
+        CHECK_EQUAL(OTBR_ERROR_NONE, agent->Send(*message, NULL, 0, NULL, NULL));
+        CHECK_EQUAL(1, context.mTransmitCount);
+        CHECK(native.GetNextTimeout(timeout));
+        native.HandleTimers(timeout);
+        CHECK_EQUAL(2, context.mTransmitCount);
+        agent->Input(ack.GetBuffer(), ack.GetLength(), NULL, 0);
+        CHECK_EQUAL(false, native.GetNextTimeout(timeout));
+
+        // Other messages are not retransmitted, so the caller learns they were lost.
+        context.mBusyCount = 1;
+        message->SetType(Coap::kTypeNonConfirmable);
+        CHECK_EQUAL(OTBR_ERROR_ERRNO, agent->Send(*message, NULL, 0, NULL, NULL));
+        CHECK_EQUAL(EAGAIN, errno);
+        CHECK_EQUAL(false, native.GetNextTimeout(timeout));
+        CHECK_EQUAL(1, native.GetMessagePoolStats().mInUse);
+    }
+
+    Coap::Agent::Destroy(agent);
+}
+
+void TestMatchHandler(const Coap::Message *aMessage, otbrError aError, void *aContext)
+{
+    RetransmitContext &context = *static_cast<RetransmitContext *>(aContext);
+
+    context.mResponseCount++;
+    context.mError = aError;
+    CHECK(aMessage != NULL);
+    CHECK_EQUAL(Coap::kCodeChanged, aMessage->GetCode());
+}
+
+TEST(Coap, TestResponseMatching)
+{
+    static const uint8_t kPeer[16]   = {0xfd, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+    static const uint8_t kOther[16]  = {0xfd, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2};
+    static const uint8_t kToken[]    = {0x12, 0x34};
+    static const uint8_t kBadToken[] = {0x12, 0x35};
+    RetransmitContext    context     = {0, 0, OTBR_ERROR_NONE, 0, 0};
+    unsigned long        timeout;
+
+    agent = Coap::Agent::Create(TestCountSender, &context);
+
+    {
+        Coap::AgentNative & native = *static_cast<Coap::AgentNative *>(agent);
+        Coap::MessageHandle message(*agent, agent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, kToken,
+                                                              sizeof(kToken)));
+        Coap::MessageBuffer ack;
+        uint16_t            messageId;
+
+        message->SetPath("c/cp");
+        CHECK_EQUAL(OTBR_ERROR_NONE, agent->Send(*message, kPeer, 61631, TestMatchHandler, &context));
+        messageId = static_cast<const Coap::MessageNative &>(*message).GetMessageId();
+
+        // Acknowledgments from another endpoint are not matched, even with the right message id.
+        ack.Init(Coap::kTypeAcknowledgment, Coap::kCodeEmpty, messageId, NULL, 0);
+        agent->Input(ack.GetBuffer(), ack.GetLength(), kOther, 61631);
+        agent->Input(ack.GetBuffer(), ack.GetLength(), kPeer, 61632);
+        agent->Input(ack.GetBuffer(), ack.GetLength(), NULL, 61631);
+        CHECK(native.GetNextTimeout(timeout));
+
+        // A piggybacked response must echo the token as well as the message id.
+        ack.Init(Coap::kTypeAcknowledgment, Coap::kCodeChanged, messageId, kBadToken, sizeof(kBadToken));
+        agent->Input(ack.GetBuffer(), ack.GetLength(), kPeer, 61631);
+        CHECK(native.GetNextTimeout(timeout));
+        CHECK_EQUAL(0, context.mResponseCount);
+
+        ack.Init(Coap::kTypeAcknowledgment, Coap::kCodeChanged, messageId, kToken, sizeof(kToken));
+        agent->Input(ack.GetBuffer(), ack.GetLength(), kPeer, 61631);
+        CHECK_EQUAL(1, context.mResponseCount);
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mError);
+        CHECK_EQUAL(false, native.GetNextTimeout(timeout));
+    }
+
+    Coap::Agent::Destroy(agent);
+}
+
+struct Frame
+{
+    Coap::Agent *        mReceiver;
+    std::vector<uint8_t> mBuffer;
+};
+
+struct LoopbackContext
+{
+    Coap::Agent *        mClient;
+    Coap::Agent *        mServer;
+    std::deque<Frame>    mFrames;
+    std::vector<uint8_t> mData;
+    std::vector<uint8_t> mReceived;
+    int                  mRequestCount;
+    int                  mResponseCount;
+    bool                 mDone;
+};
+
+void QueueFrame(LoopbackContext &aContext, Coap::Agent *aReceiver, const uint8_t *aBuffer, uint16_t aLength)
+{
+    Frame frame;
+
+    frame.mReceiver = aReceiver;
+    frame.mBuffer.assign(aBuffer, aBuffer + aLength);
+    aContext.mFrames.push_back(frame);
+}
+
+void DeliverFrames(LoopbackContext &aContext)
+{
+    while (!aContext.mFrames.empty())
+    {
+        Frame frame = aContext.mFrames.front();
+
+        aContext.mFrames.pop_front();
+        frame.mReceiver->Input(&frame.mBuffer[0], static_cast<uint16_t>(frame.mBuffer.size()), NULL, 0);
+    }
+}
+
+ssize_t TestClientSender(const uint8_t *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort, void *aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+
+    QueueFrame(context, context.mServer, aBuffer, aLength);
+
+    (void)aIp6;
+    (void)aPort;
+    return static_cast<ssize_t>(aLength);
+}
+
+ssize_t TestServerSender(const uint8_t *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort, void *aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+
+    QueueFrame(context, context.mClient, aBuffer, aLength);
+
+    (void)aIp6;
+    (void)aPort;
+    return static_cast<ssize_t>(aLength);
+}
+
+ssize_t TestBlockReader(uint32_t aOffset, uint8_t *aBuffer, uint16_t aLength, void *aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+    size_t            length  = context.mData.size() - aOffset;
+
+    if (length > aLength)
+    {
+        length = aLength;
+    }
+
+    memcpy(aBuffer, &context.mData[aOffset], length);
+
+    return static_cast<ssize_t>(length);
+}
+
+void TestUploadHandler(const Coap::Resource &aResource,
+                       const Coap::Message & aRequest,
+                       Coap::Message &       aResponse,
+                       const uint8_t *       aIp6,
+                       uint16_t              aPort,
+                       void *                aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+    Coap::Block       block;
+    uint16_t          length;
+    const uint8_t *   payload = aRequest.GetPayload(length);
+
+    context.mRequestCount++;
+    CHECK_EQUAL(OTBR_ERROR_NONE, aRequest.GetBlock(Coap::kOptionBlock1, block));
+    CHECK_EQUAL(context.mReceived.size(), block.mNumber * block.mSize);
+    context.mReceived.insert(context.mReceived.end(), payload, payload + length);
+    aResponse.SetCode(block.mMore ? Coap::kCodeContinue : Coap::kCodeChanged);
+
+    (void)aResource;
+    (void)aIp6;
+    (void)aPort;
+}
+
+void TestDownloadHandler(const Coap::Resource &aResource,
+                         const Coap::Message & aRequest,
+                         Coap::Message &       aResponse,
+                         const uint8_t *       aIp6,
+                         uint16_t              aPort,
+                         void *                aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+    Coap::Block       block;
+    size_t            offset;
+    size_t            length;
+
+    context.mRequestCount++;
+
+    if (aRequest.GetBlock(Coap::kOptionBlock2, block) != OTBR_ERROR_NONE)
+    {
+        block.mNumber = 0;
+        block.mSize   = 64;
+    }
+
+    offset      = block.mNumber * block.mSize;
+    length      = std::min<size_t>(block.mSize, context.mData.size() - offset);
+    block.mMore = (offset + length < context.mData.size());
+
+    aResponse.SetCode(Coap::kCodeContent);
+    CHECK_EQUAL(OTBR_ERROR_NONE, aResponse.SetBlock(Coap::kOptionBlock2, block));
+    aResponse.SetPayload(&context.mData[offset], static_cast<uint16_t>(length));
+
+    (void)aResource;
+    (void)aIp6;
+    (void)aPort;
+}
+
+void TestBlockwiseResponseHandler(const Coap::Message *aMessage, otbrError aError, void *aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+    Coap::Block       block;
+    uint16_t          length;
+    const uint8_t *   payload;
+
+    CHECK_EQUAL(OTBR_ERROR_NONE, aError);
+    CHECK(aMessage != NULL);
+    CHECK_EQUAL(false, context.mDone);
+    context.mResponseCount++;
+
+    if (aMessage->GetBlock(Coap::kOptionBlock2, block) == OTBR_ERROR_NONE)
+    {
+        payload = aMessage->GetPayload(length);
+        CHECK_EQUAL(context.mReceived.size(), block.mNumber * block.mSize);
+        context.mReceived.insert(context.mReceived.end(), payload, payload + length);
+        context.mDone = !block.mMore;
+    }
+    else
+    {
+        // the final response to an upload echoes the last block
+        CHECK_EQUAL(Coap::kCodeChanged, aMessage->GetCode());
+        CHECK_EQUAL(OTBR_ERROR_NONE, aMessage->GetBlock(Coap::kOptionBlock1, block));
+        CHECK_EQUAL(false, block.mMore);
+        context.mDone = true;
+    }
+}
+
+TEST(Coap, TestBlockwise)
+{
+    LoopbackContext context;
+    Coap::Resource   upload("upload", TestUploadHandler, &context);
+    Coap::Resource   download("download", TestDownloadHandler, &context);
+    uint8_t          token = 0x5a;
+
+    download.SetHandler(Coap::kCodeGet, TestDownloadHandler);
+    download.SetHandler(Coap::kCodePost, NULL);
+
+    for (size_t i = 0; i < 300; i++)
+    {
+        context.mData.push_back(static_cast<uint8_t>(i * 7));
+    }
+
+    context.mClient = Coap::Agent::Create(TestClientSender, &context);
+    context.mServer = Coap::Agent::Create(TestServerSender, &context);
+    CHECK_EQUAL(OTBR_ERROR_NONE, context.mServer->AddResource(upload));
+    CHECK_EQUAL(OTBR_ERROR_NONE, context.mServer->AddResource(download));
+
+    // Upload in Block1 blocks, each read on 2.31 Continue.
+    {
+        Coap::MessageHandle request(*context.mClient,
+                                    context.mClient->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, &token, 1));
+
+        request->SetPath("upload");
+        context.mRequestCount  = 0;
+        context.mResponseCount = 0;
+        context.mDone          = false;
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->SendBlockwise(*request, 64, TestBlockReader, &context, NULL, 0,
+                                                                    TestBlockwiseResponseHandler, &context));
+        DeliverFrames(context);
+
+        CHECK_EQUAL(5, context.mRequestCount);
+        CHECK_EQUAL(1, context.mResponseCount);
+        CHECK(context.mDone);
+        CHECK(context.mData == context.mReceived);
+    }
+
+    // Download in Block2 blocks, each passed to the handler as it arrives.
+    {
+        Coap::MessageHandle request(*context.mClient,
+                                    context.mClient->NewMessage(Coap::kTypeConfirmable, Coap::kCodeGet, &token, 1));
+
+        request->SetPath("download");
+        context.mRequestCount  = 0;
+        context.mResponseCount = 0;
+        context.mDone          = false;
+        context.mReceived.clear();
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->Send(*request, NULL, 0, TestBlockwiseResponseHandler, &context));
+        DeliverFrames(context);
+
+        CHECK_EQUAL(5, context.mRequestCount);
+        CHECK_EQUAL(5, context.mResponseCount);
+        CHECK(context.mDone);
+        CHECK(context.mData == context.mReceived);
+    }
+
+    CHECK_EQUAL(0, static_cast<Coap::AgentNative *>(context.mClient)->GetMessagePoolStats().mInUse);
+
+    Coap::Agent::Destroy(context.mServer);
+    Coap::Agent::Destroy(context.mClient);
+}
+
+void TestStateHandler(const Coap::Resource &aResource,
+                      const Coap::Message & aRequest,
+                      Coap::Message &       aResponse,
+                      const uint8_t *       aIp6,
+                      uint16_t              aPort,
+                      void *                aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+
+    context.mRequestCount++;
+    aResponse.SetCode(Coap::kCodeContent);
+    aResponse.SetPayload(&context.mData[0], static_cast<uint16_t>(context.mData.size()));
+
+    (void)aResource;
+    (void)aRequest;
+    (void)aIp6;
+    (void)aPort;
+}
+
+void TestObserveHandler(const Coap::Message *aMessage, otbrError aError, void *aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+    uint32_t         sequence;
+    uint16_t         length;
+    const uint8_t *  payload;
+
+    CHECK_EQUAL(OTBR_ERROR_NONE, aError);
+    CHECK(aMessage != NULL);
+    CHECK_EQUAL(OTBR_ERROR_NONE, aMessage->GetObserve(sequence));
+    payload = aMessage->GetPayload(length);
+    CHECK_EQUAL(1, length);
+    context.mReceived.push_back(payload[0]);
+    context.mResponseCount++;
+}
+
+TEST(Coap, TestObserve)
+{
+    LoopbackContext context;
+    Coap::Resource  state("state", NULL, &context);
+    uint8_t         token = 0x6b;
+
+    state.SetHandler(Coap::kCodeGet, TestStateHandler);
+    context.mData.push_back(1);
+    context.mRequestCount  = 0;
+    context.mResponseCount = 0;
+    context.mClient        = Coap::Agent::Create(TestClientSender, &context);
+    context.mServer        = Coap::Agent::Create(TestServerSender, &context);
+    CHECK_EQUAL(OTBR_ERROR_NONE, context.mServer->AddResource(state));
+    CHECK_EQUAL(0, context.mServer->Notify(state));
+
+    // Register.
+    {
+        Coap::MessageHandle request(*context.mClient,
+                                    context.mClient->NewMessage(Coap::kTypeConfirmable, Coap::kCodeGet, &token, 1));
+
+        request->SetPath("state");
+        CHECK_EQUAL(OTBR_ERROR_NONE, request->SetObserve(Coap::kObserveRegister));
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->Send(*request, NULL, 0, TestObserveHandler, &context));
+    }
+
+    DeliverFrames(context);
+    CHECK_EQUAL(1, context.mRequestCount);
+    CHECK_EQUAL(1, context.mResponseCount);
+
+    // Each change is pushed to the observer, and the acknowledgment completes the notification.
+    context.mData[0] = 2;
+    CHECK_EQUAL(1, context.mServer->Notify(state));
+    DeliverFrames(context);
+    CHECK_EQUAL(2, context.mRequestCount);
+    CHECK_EQUAL(2, context.mResponseCount);
+    CHECK_EQUAL(2, context.mReceived.back());
+    CHECK_EQUAL(0, static_cast<Coap::AgentNative *>(context.mServer)->GetMessagePoolStats().mInUse);
+    CHECK_EQUAL(0, static_cast<Coap::AgentNative *>(context.mClient)->GetMessagePoolStats().mInUse);
+
+    // The client forgets the observation and resets the next notification, which deregisters it.
+    CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->CancelObserve(&token, 1));
+    CHECK_EQUAL(OTBR_ERROR_ERRNO, context.mClient->CancelObserve(&token, 1));
+    CHECK_EQUAL(ENOENT, errno);
+    CHECK_EQUAL(1, context.mServer->Notify(state));
+    DeliverFrames(context);
+    CHECK_EQUAL(2, context.mResponseCount);
+    CHECK_EQUAL(0, context.mServer->Notify(state));
+
+    // A notification lost before the client registers again does not remove the new registration.
+    for (int i = 0; i < 2; i++)
+    {
+        Coap::MessageHandle request(*context.mClient,
+                                    context.mClient->NewMessage(Coap::kTypeConfirmable, Coap::kCodeGet, &token, 1));
+
+        request->SetPath("state");
+        CHECK_EQUAL(OTBR_ERROR_NONE, request->SetObserve(Coap::kObserveRegister));
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->Send(*request, NULL, 0, TestObserveHandler, &context));
+        DeliverFrames(context);
+
+        if (i == 0)
+        {
+            CHECK_EQUAL(1, context.mServer->Notify(state));
+            context.mFrames.clear();
+        }
+    }
+
+    {
+        Coap::AgentNative &server = *static_cast<Coap::AgentNative *>(context.mServer);
+        unsigned long      timeout;
+
+        while (server.GetNextTimeout(timeout))
+        {
+            server.HandleTimers(timeout);
+            context.mFrames.clear();
+        }
+    }
+
+    CHECK_EQUAL(1, context.mServer->Notify(state));
+    context.mFrames.clear();
+
+    Coap::Agent::Destroy(context.mServer);
+    Coap::Agent::Destroy(context.mClient);
+}
+
+void TestSensorHandler(const Coap::Resource &aResource,
+                       const Coap::Message & aRequest,
+                       Coap::Message &       aResponse,
+                       const uint8_t *       aIp6,
+                       uint16_t              aPort,
+                       void *                aContext)
+{
+    LoopbackContext &context = *static_cast<LoopbackContext *>(aContext);
+    char             path[Coap::Metrics::kMaxPathLength];
+
+    // answers with the last character of the path, i.e. the name of the sensor
+    static_cast<const Coap::MessageNative &>(aRequest).GetPath(path, sizeof(path));
+    context.mRequestCount++;
+    aResponse.SetCode(Coap::kCodeContent);
+    aResponse.SetPayload(reinterpret_cast<const uint8_t *>(&path[strlen(path) - 1]), 1);
+
+    (void)aResource;
+    (void)aIp6;
+    (void)aPort;
+}
+
+TEST(Coap, TestObservePrefix)
+{
+    LoopbackContext context;
+    Coap::Resource  sensors("sensor/*", NULL, &context);
+    uint8_t         token = 0x6c;
+
+    sensors.SetHandler(Coap::kCodeGet, TestSensorHandler);
+    context.mRequestCount  = 0;
+    context.mResponseCount = 0;
+    context.mClient        = Coap::Agent::Create(TestClientSender, &context);
+    context.mServer        = Coap::Agent::Create(TestServerSender, &context);
+    CHECK_EQUAL(OTBR_ERROR_NONE, context.mServer->AddResource(sensors));
+
+    {
+        Coap::MessageHandle request(*context.mClient,
+                                    context.mClient->NewMessage(Coap::kTypeConfirmable, Coap::kCodeGet, &token, 1));
+
+        request->SetPath("sensor/a");
+        CHECK_EQUAL(OTBR_ERROR_NONE, request->SetObserve(Coap::kObserveRegister));
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->Send(*request, NULL, 0, TestObserveHandler, &context));
+    }
+
+    DeliverFrames(context);
+    CHECK_EQUAL(1, context.mResponseCount);
+    CHECK_EQUAL('a', context.mReceived.back());
+
+    // The notification is filled for the path the client registered, not for the pattern of the resource.
+    CHECK_EQUAL(1, context.mServer->Notify(sensors));
+    DeliverFrames(context);
+    CHECK_EQUAL(2, context.mRequestCount);
+    CHECK_EQUAL(2, context.mResponseCount);
+    CHECK_EQUAL('a', context.mReceived.back());
+
+    Coap::Agent::Destroy(context.mServer);
+    Coap::Agent::Destroy(context.mClient);
+}
+
+TEST(Coap, TestDuplicateRequest)
+{
+    LoopbackContext     context;
+    Coap::Resource      state("state", NULL, &context);
+    Coap::MessageBuffer request;
+    Coap::MessageBuffer response;
+    uint8_t             token = 0x3c;
+    uint16_t            length;
+
+    state.SetHandler(Coap::kCodeGet, TestStateHandler);
+    context.mData.push_back(1);
+    context.mRequestCount = 0;
+    agent                 = Coap::Agent::Create(TestCaptureSender, &response);
+    CHECK_EQUAL(OTBR_ERROR_NONE, agent->AddResource(state));
+
+    request.Init(Coap::kTypeConfirmable, Coap::kCodeGet, 0x1234, &token, 1);
+    request.SetPath("state");
+    agent->Input(request.GetBuffer(), request.GetLength(), NULL, 0);
+    CHECK_EQUAL(1, context.mRequestCount);
+    CHECK_EQUAL(1, response.GetPayload(length)[0]);
+
+    // A retransmission gets the cached response without handling the request again.
+    context.mData[0] = 2;
+    response.Init(Coap::kTypeReset, Coap::kCodeEmpty, 0, NULL, 0);
+    agent->Input(request.GetBuffer(), request.GetLength(), NULL, 0);
+    CHECK_EQUAL(1, context.mRequestCount);
+    CHECK_EQUAL(Coap::kTypeAcknowledgment, response.GetType());
+    CHECK_EQUAL(0x1234, response.GetMessageId());
+    CHECK_EQUAL(1, response.GetPayload(length)[0]);
+
+    // The same message id from another endpoint is not a duplicate.
+    agent->Input(request.GetBuffer(), request.GetLength(), NULL, 1);
+    CHECK_EQUAL(2, context.mRequestCount);
+    CHECK_EQUAL(2, response.GetPayload(length)[0]);
+
+    // The oldest request is forgotten when the cache is full.
+    for (uint16_t i = 1; i < OTBR_COAP_DEDUP_CACHE_SIZE; i++)
+    {
+        request.SetMessageId(static_cast<uint16_t>(0x1234 + i));
+        agent->Input(request.GetBuffer(), request.GetLength(), NULL, 0);
+    }
+
+    CHECK_EQUAL(1 + OTBR_COAP_DEDUP_CACHE_SIZE, context.mRequestCount);
+    request.SetMessageId(0x1234);
+    agent->Input(request.GetBuffer(), request.GetLength(), NULL, 0);
+    CHECK_EQUAL(2 + OTBR_COAP_DEDUP_CACHE_SIZE, context.mRequestCount);
+
+    Coap::Agent::Destroy(agent);
+}
+
+void TestPayloadHandler(const Coap::Resource &aResource,
+                        const Coap::Message & aRequest,
+                        Coap::Message &       aResponse,
+                        const uint8_t *       aIp6,
+                        uint16_t              aPort,
+                        void *                aContext)
+{
+    uint16_t length;
+
+    *static_cast<const uint8_t **>(aContext) = aRequest.GetPayload(length);
+    CHECK_EQUAL(4, length);
+    aResponse.SetCode(Coap::kCodeChanged);
+
+    (void)aResource;
+    (void)aIp6;
+    (void)aPort;
+}
+
+TEST(Coap, TestInputInPlace)
+{
+    const uint8_t *     payload = NULL;
+    Coap::Resource      resource("c/tx", TestPayloadHandler, &payload);
+    Coap::MessageBuffer request;
+    Coap::MessageBuffer response;
+    const uint8_t       data[] = {0x11, 0x22, 0x33, 0x44};
+    uint8_t             record[Coap::MessageNative::kMaxMessageSize];
+
+    agent = Coap::Agent::Create(TestCaptureSender, &response);
+    CHECK_EQUAL(OTBR_ERROR_NONE, agent->AddResource(resource));
+
+    request.Init(Coap::kTypeConfirmable, Coap::kCodePost, 0x2a, NULL, 0);
+    request.SetPath("c/tx");
+    request.SetPayload(data, sizeof(data));
+    memcpy(record, request.GetBuffer(), request.GetLength());
+
+    // Handlers see the payload where it is in the received record, which is left untouched.
+    agent->Input(record, request.GetLength(), NULL, 0);
+    CHECK(payload == record + request.GetLength() - sizeof(data));
+    CHECK_EQUAL(0, memcmp(record, request.GetBuffer(), request.GetLength()));
+    CHECK_EQUAL(Coap::kCodeChanged, response.GetCode());
+
+    Coap::Agent::Destroy(agent);
+}
+
+const Coap::Metrics *FindTestMetrics(const Coap::Agent &aAgent, const char *aPath)
+{
+    size_t               count;
+    const Coap::Metrics *metrics = aAgent.GetMetrics(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strcmp(metrics[i].mPath, aPath) == 0)
+        {
+            return &metrics[i];
+        }
+    }
+
+    return NULL;
+}
+
+uint32_t SumTestRtt(const Coap::Metrics &aMetrics)
+{
+    uint32_t sum = 0;
+
+    for (size_t i = 0; i < Coap::Metrics::kRttBuckets; i++)
+    {
+        sum += aMetrics.mRtt[i];
+    }
+
+    return sum;
+}
+
+TEST(Coap, TestMetrics)
+{
+    LoopbackContext      context;
+    Coap::Resource       state("c/state", NULL, &context);
+    const Coap::Metrics *metrics;
+
+    state.SetHandler(Coap::kCodeGet, TestStateHandler);
+    context.mData.push_back(1);
+    context.mRequestCount  = 0;
+    context.mResponseCount = 0;
+    context.mClient        = Coap::Agent::Create(TestClientSender, &context);
+    context.mServer        = Coap::Agent::Create(TestServerSender, &context);
+    CHECK_EQUAL(OTBR_ERROR_NONE, context.mServer->AddResource(state));
+
+    for (int i = 0; i < 2; i++)
+    {
+        Coap::MessageHandle request(*context.mClient,
+                                    context.mClient->NewMessage(Coap::kTypeConfirmable, Coap::kCodeGet, NULL, 0));
+
+        request->SetPath("c/state");
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->Send(*request, NULL, 0, NULL, NULL));
+        DeliverFrames(context);
+    }
+
+    {
+        Coap::MessageHandle request(*context.mClient,
+                                    context.mClient->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, NULL, 0));
+
+        request->SetPath("c/state");
+        CHECK_EQUAL(OTBR_ERROR_NONE, context.mClient->Send(*request, NULL, 0, NULL, NULL));
+        DeliverFrames(context);
+    }
+
+    // Served by the resource.
+    metrics = FindTestMetrics(*context.mServer, "c/state");
+    CHECK(metrics != NULL);
+    CHECK_EQUAL(3, metrics->mRequestsReceived);
+    CHECK_EQUAL(2, metrics->mResponsesSent[2]);
+    CHECK_EQUAL(1, metrics->mResponsesSent[4]);
+    CHECK_EQUAL(0, metrics->mRequestsSent);
+
+    // Requested by the client.
+    metrics = FindTestMetrics(*context.mClient, "c/state");
+    CHECK(metrics != NULL);
+    CHECK_EQUAL(3, metrics->mRequestsSent);
+    CHECK_EQUAL(2, metrics->mResponsesReceived[2]);
+    CHECK_EQUAL(1, metrics->mResponsesReceived[4]);
+    CHECK_EQUAL(3, SumTestRtt(*metrics));
+    CHECK_EQUAL(0, metrics->mRetransmissions);
+    CHECK_EQUAL(0, metrics->mRequestsReceived);
+
+    Coap::Agent::Destroy(context.mServer);
+    Coap::Agent::Destroy(context.mClient);
+
+    // Retransmissions and timeouts of unanswered requests.
+    {
+        RetransmitContext retransmit = {0, 0, OTBR_ERROR_NONE, 0, 0};
+        unsigned long     timeout;
+
+        agent = Coap::Agent::Create(TestCountSender, &retransmit);
+
+        {
+            Coap::AgentNative & native = *static_cast<Coap::AgentNative *>(agent);
+            Coap::MessageHandle message(*agent, agent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, NULL, 0));
+
+            message->SetPath("c/ka");
+            CHECK_EQUAL(OTBR_ERROR_NONE, agent->Send(*message, NULL, 0, NULL, NULL));
+
+            while (native.GetNextTimeout(timeout))
+            {
+                native.HandleTimers(timeout);
+            }
+        }
+
+        metrics = FindTestMetrics(*agent, "c/ka");
+        CHECK(metrics != NULL);
+        CHECK_EQUAL(1, metrics->mRequestsSent);
+        CHECK_EQUAL(4, metrics->mRetransmissions);
+        CHECK_EQUAL(1, metrics->mTimeouts);
+        CHECK_EQUAL(0, SumTestRtt(*metrics));
+
+        Coap::Agent::Destroy(agent);
+    }
+
+    // Paths beyond the capacity of the table are counted together.
+    {
+        RetransmitContext retransmit = {0, 0, OTBR_ERROR_NONE, 0, 0};
+        size_t            count;
+        char              path[Coap::Metrics::kMaxPathLength];
+
+        agent = Coap::Agent::Create(TestCountSender, &retransmit);
+
+        for (int i = 0; i < 20; i++)
+        {
+            Coap::MessageHandle message(*agent,
+                                        agent->NewMessage(Coap::kTypeNonConfirmable, Coap::kCodePost, NULL, 0));
+
+            snprintf(path, sizeof(path), "p/%d", i % 18);
+            message->SetPath(path);
+            CHECK_EQUAL(OTBR_ERROR_NONE, agent->Send(*message, NULL, 0, NULL, NULL));
+        }
+
+        agent->GetMetrics(count);
+        CHECK_EQUAL(16, count);
+        CHECK_EQUAL(2, FindTestMetrics(*agent, "p/0")->mRequestsSent);
+        CHECK_EQUAL(1, FindTestMetrics(*agent, "p/14")->mRequestsSent);
+        CHECK(FindTestMetrics(*agent, "p/15") == NULL);
+        CHECK_EQUAL(3, FindTestMetrics(*agent, "*")->mRequestsSent);
+
+        Coap::Agent::Destroy(agent);
+    }
+}
@@ -0,0 +1,1049 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "common/dtls_mbedtls.hpp"
+#include "common/trace.hpp"
+
+namespace ot {
+namespace BorderRouter {
+namespace Dtls {
+
+/** Reaches the internals of the mbedTLS-based DTLS server */
+class MbedtlsTester
+{
+public:
+    static size_t GetCapacity(const SessionTable &aTable) { return aTable.mSlots.size(); }
+
+    static size_t GetHome(const SessionTable &aTable, const sockaddr_in6 &aRemoteSock)
+    {
+        return SessionTable::Hash(aRemoteSock) & (aTable.mSlots.size() - 1);
+    }
+
+    static const MbedtlsSession *GetSlot(const SessionTable &aTable, size_t aSlot) { return aTable.mSlots[aSlot]; }
+
+    static void AddSession(MbedtlsServer &aServer, MbedtlsSession &aSession) { aServer.AddSession(aSession); }
+    static void RemoveSession(MbedtlsServer &aServer, MbedtlsSession &aSession) { aServer.RemoveSession(aSession); }
+    static void RefreshSession(MbedtlsServer &aServer, MbedtlsSession &aSession) { aServer.RefreshSession(aSession); }
+    static void RetireSession(MbedtlsServer &aServer, MbedtlsSession &aSession) { aServer.RetireSession(aSession); }
+
+    static void MoveSession(MbedtlsServer &aServer, MbedtlsSession &aSession, const sockaddr_in6 &aRemoteSock)
+    {
+        aServer.MoveSession(aSession, aRemoteSock, aSession.mLocalSock);
+    }
+
+    static bool          AdmitSession(MbedtlsServer &aServer) { return aServer.AdmitSession(); }
+    static size_t        GetMaxHandshakes(void) { return MbedtlsServer::kMaxHandshakes; }
+    static unsigned long GetHandshakeTimeout(void) { return MbedtlsSession::kHandshakeTimeout; }
+    static void          SetState(MbedtlsSession &aSession, Session::State aState) { aSession.SetState(aState); }
+    static void          Silence(MbedtlsSession &aSession, unsigned long aTime) { aSession.mExpiration -= aTime; }
+
+    static const SessionTable &GetSessions(const MbedtlsServer &aServer) { return aServer.mSessions; }
+    static int                 GetSocket(const MbedtlsServer &aServer) { return aServer.mSocket; }
+    static size_t GetCongestedSessions(const MbedtlsServer &aServer) { return aServer.mCongestedSessions; }
+    static size_t GetMaxOutbound(void) { return MbedtlsSession::kMaxOutbound; }
+    static bool   IsOffloaded(const MbedtlsSession &aSession) { return aSession.mIsOffloaded; }
+    static size_t GetBacklogSize(const MbedtlsSession &aSession) { return aSession.mBacklog.size(); }
+    static int    GetEventFd(const MbedtlsServer &aServer) { return aServer.mHandshakePool.GetEventFd(); }
+
+    static otbrError StartPool(MbedtlsServer &aServer, size_t aThreads)
+    {
+        aServer.mHandshakePool.Stop();
+
+        return aServer.mHandshakePool.Start(aThreads);
+    }
+
+    static int SendBusy(void *aContext, const unsigned char *aBuffer, size_t aLength)
+    {
+        (void)aContext;
+        (void)aBuffer;
+        (void)aLength;
+
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+
+    static void SetBusy(MbedtlsSession &aSession, bool aIsBusy)
+    {
+        mbedtls_ssl_send_t *sender = MbedtlsSession::SendMbedtls;
+
+        if (aIsBusy)
+        {
+            sender = SendBusy;
+        }
+
+        mbedtls_ssl_set_bio(&aSession.mSsl, &aSession, sender, MbedtlsSession::ReadMbedtls, NULL);
+    }
+
+    static bool ExchangeCookie(MbedtlsServer &     aServer,
+                               const uint8_t *     aBuffer,
+                               uint16_t            aLength,
+                               const sockaddr_in6 &aSrc,
+                               const sockaddr_in6 &aDst)
+    {
+        return aServer.ExchangeCookie(aBuffer, aLength, aSrc, aDst);
+    }
+
+    static std::vector<const MbedtlsSession *> GetExpiryOrder(const MbedtlsServer &aServer)
+    {
+        std::vector<const MbedtlsSession *> order;
+
+        for (const MbedtlsSession *session = aServer.mExpiryHead; session != NULL; session = session->mExpiryNext)
+        {
+            // the backward links must mirror the forward ones
+            CHECK_EQUAL(order.empty() ? NULL : order.back(), session->mExpiryPrev);
+            order.push_back(session);
+        }
+
+        CHECK_EQUAL(order.empty() ? NULL : order.back(), aServer.mExpiryTail);
+
+        return order;
+    }
+};
+
+} // namespace Dtls
+} // namespace BorderRouter
+} // namespace ot
+
+using namespace ot::BorderRouter::Dtls;
+
+enum
+{
+    kTestRecordHeaderSize    = 13,
+    kTestHandshakeHeaderSize = 12,
+    kTestHelloHeadersSize    = kTestRecordHeaderSize + kTestHandshakeHeaderSize,
+    kTestOffsetOfSessionId   = kTestHelloHeadersSize + 2 + 32, ///< After client_version and random.
+    kTestMaxDatagramSize     = 512,
+    kTestContentTypeCid      = 25,    ///< Content type of a record carrying a connection ID.
+    kTestOffsetOfCid         = 11,    ///< After the content type, version, epoch and sequence number.
+    kTestMaxRounds           = 1000,  ///< Max number of main loop iterations a handshake takes.
+    kTestPollInterval        = 10000, ///< Max wait of a main loop iteration in microseconds.
+};
+
+sockaddr_in6 MakeTestSock(uint16_t aPort)
+{
+    sockaddr_in6 sock;
+
+    memset(&sock, 0, sizeof(sock));
+    sock.sin6_family = AF_INET6;
+    sock.sin6_addr   = in6addr_loopback;
+    sock.sin6_port   = htons(aPort);
+
+    return sock;
+}
+
+TEST_GROUP(MbedtlsServer)
+{
+    MbedtlsServer *mServer;
+
+    void setup(void)
+    {
+        static const uint8_t kSeed[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+        static const uint8_t kPsk[]  = {'J', '0', '1', 'N', 'M', 'E'};
+
+        mServer = new MbedtlsServer(0, NULL, NULL);
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->SetSeed(kSeed, sizeof(kSeed)));
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->SetPSK(kPsk, sizeof(kPsk)));
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->Start());
+    }
+
+    void teardown(void) { delete mServer; }
+
+    MbedtlsSession *NewSession(const sockaddr_in6 &aRemoteSock)
+    {
+        MbedtlsSession *session = new MbedtlsSession(*mServer, aRemoteSock, MakeTestSock(0));
+
+        CHECK_EQUAL(OTBR_ERROR_NONE, session->Init());
+
+        return session;
+    }
+};
+
+TEST(MbedtlsServer, TestSessionTableCollisions)
+{
+    SessionTable                  table;
+    std::vector<MbedtlsSession *> wrapped;       // sessions whose home is the last slot
+    MbedtlsSession *              first = NULL;  // a session whose home is the first slot
+    size_t                        last  = MbedtlsTester::GetCapacity(table) - 1;
+
+    for (uint16_t port = 1; wrapped.size() < 3 || first == NULL; port++)
+    {
+        sockaddr_in6 sock = MakeTestSock(port);
+        size_t       home = MbedtlsTester::GetHome(table, sock);
+
+        if (home == last && wrapped.size() < 3)
+        {
+            wrapped.push_back(NewSession(sock));
+        }
+        else if (home == 0 && first == NULL)
+        {
+            first = NewSession(sock);
+        }
+    }
+
+    // The probe sequence of the last slot wraps around to the first ones.
+    table.Insert(*wrapped[0]);
+    table.Insert(*wrapped[1]);
+    table.Insert(*first);
+    table.Insert(*wrapped[2]);
+    CHECK_EQUAL(4, table.GetSize());
+    CHECK_EQUAL(wrapped[0], MbedtlsTester::GetSlot(table, last));
+    CHECK_EQUAL(wrapped[1], MbedtlsTester::GetSlot(table, 0));
+    CHECK_EQUAL(first, MbedtlsTester::GetSlot(table, 1));
+    CHECK_EQUAL(wrapped[2], MbedtlsTester::GetSlot(table, 2));
+
+    for (size_t i = 0; i < wrapped.size(); i++)
+    {
+        CHECK_EQUAL(wrapped[i], table.Find(wrapped[i]->GetRemoteSock()));
+    }
+
+    CHECK_EQUAL(first, table.Find(first->GetRemoteSock()));
+    CHECK(table.Find(MakeTestSock(0)) == NULL);
+
+    // Removing from the middle of the chain shifts back the entries after it, across the wraparound.
+    table.Remove(*wrapped[1]);
+    CHECK_EQUAL(3, table.GetSize());
+    CHECK(table.Find(wrapped[1]->GetRemoteSock()) == NULL);
+    CHECK_EQUAL(wrapped[0], MbedtlsTester::GetSlot(table, last));
+    CHECK_EQUAL(first, MbedtlsTester::GetSlot(table, 0));
+    CHECK_EQUAL(wrapped[2], MbedtlsTester::GetSlot(table, 1));
+    CHECK(MbedtlsTester::GetSlot(table, 2) == NULL);
+
+    // A removed session is not removed again.
+    table.Remove(*wrapped[1]);
+    CHECK_EQUAL(3, table.GetSize());
+
+    // An entry already at its home stays, the one after it moves back to the hole.
+    table.Remove(*wrapped[0]);
+    CHECK_EQUAL(2, table.GetSize());
+    CHECK_EQUAL(wrapped[2], MbedtlsTester::GetSlot(table, last));
+    CHECK_EQUAL(first, MbedtlsTester::GetSlot(table, 0));
+    CHECK(MbedtlsTester::GetSlot(table, 1) == NULL);
+    CHECK_EQUAL(wrapped[2], table.Find(wrapped[2]->GetRemoteSock()));
+    CHECK_EQUAL(first, table.Find(first->GetRemoteSock()));
+
+    table.Remove(*wrapped[2]);
+    table.Remove(*first);
+    CHECK_EQUAL(0, table.GetSize());
+
+    for (size_t i = 0; i < wrapped.size(); i++)
+    {
+        delete wrapped[i];
+    }
+
+    delete first;
+}
+
+TEST(MbedtlsServer, TestSessionTableGrow)
+{
+    SessionTable                  table;
+    std::vector<MbedtlsSession *> sessions;
+    size_t                        capacity = MbedtlsTester::GetCapacity(table);
+
+    // The table grows before it is three quarters full.
+    for (uint16_t port = 1; port <= capacity * 3 / 4; port++)
+    {
+        sessions.push_back(NewSession(MakeTestSock(port)));
+        table.Insert(*sessions.back());
+        CHECK_EQUAL(capacity, MbedtlsTester::GetCapacity(table));
+    }
+
+    sessions.push_back(NewSession(MakeTestSock(static_cast<uint16_t>(sessions.size() + 1))));
+    table.Insert(*sessions.back());
+    CHECK_EQUAL(capacity * 2, MbedtlsTester::GetCapacity(table));
+    CHECK_EQUAL(sessions.size(), table.GetSize());
+
+    // Every session is still found after rehashing, and after each removal of another one.
+    for (size_t removed = 0; removed < sessions.size(); removed++)
+    {
+        for (size_t i = removed; i < sessions.size(); i++)
+        {
+            CHECK_EQUAL(sessions[i], table.Find(sessions[i]->GetRemoteSock()));
+        }
+
+        table.Remove(*sessions[removed]);
+        CHECK(table.Find(sessions[removed]->GetRemoteSock()) == NULL);
+        CHECK_EQUAL(sessions.size() - removed - 1, table.GetSize());
+    }
+
+    for (size_t i = 0; i < sessions.size(); i++)
+    {
+        delete sessions[i];
+    }
+}
+
+TEST(MbedtlsServer, TestExpiryOrder)
+{
+    MbedtlsSession *                    first  = NewSession(MakeTestSock(1));
+    MbedtlsSession *                    second = NewSession(MakeTestSock(2));
+    MbedtlsSession *                    third  = NewSession(MakeTestSock(3));
+    std::vector<const MbedtlsSession *> order;
+
+    // Sessions are added last to expire.
+    MbedtlsTester::AddSession(*mServer, *first);
+    MbedtlsTester::AddSession(*mServer, *second);
+    MbedtlsTester::AddSession(*mServer, *third);
+    order = MbedtlsTester::GetExpiryOrder(*mServer);
+    CHECK_EQUAL(3, order.size());
+    CHECK(order[0] == first && order[1] == second && order[2] == third);
+
+    // A refreshed session moves to the end.
+    MbedtlsTester::RefreshSession(*mServer, *first);
+    order = MbedtlsTester::GetExpiryOrder(*mServer);
+    CHECK_EQUAL(3, order.size());
+    CHECK(order[0] == second && order[1] == third && order[2] == first);
+
+    // A retired session moves to the front, to be destroyed first.
+    MbedtlsTester::RetireSession(*mServer, *third);
+    order = MbedtlsTester::GetExpiryOrder(*mServer);
+    CHECK_EQUAL(3, order.size());
+    CHECK(order[0] == third && order[1] == second && order[2] == first);
+
+    // A removed session leaves both the list and the table.
+    MbedtlsTester::RemoveSession(*mServer, *second);
+    order = MbedtlsTester::GetExpiryOrder(*mServer);
+    CHECK_EQUAL(2, order.size());
+    CHECK(order[0] == third && order[1] == first);
+    CHECK(MbedtlsTester::GetSessions(*mServer).Find(second->GetRemoteSock()) == NULL);
+    CHECK_EQUAL(first, MbedtlsTester::GetSessions(*mServer).Find(first->GetRemoteSock()));
+    CHECK_EQUAL(2, MbedtlsTester::GetSessions(*mServer).GetSize());
+
+    MbedtlsTester::RemoveSession(*mServer, *third);
+    MbedtlsTester::RemoveSession(*mServer, *first);
+    CHECK(MbedtlsTester::GetExpiryOrder(*mServer).empty());
+
+    delete first;
+    delete second;
+    delete third;
+}
+
+/** Builds an unfragmented ClientHello record of sequence number 7, without a session_id */
+uint16_t BuildTestClientHello(uint8_t *aBuffer, uint8_t aMessageSeq, const uint8_t *aCookie, uint8_t aCookieLength)
+{
+    uint8_t *cursor = aBuffer + kTestHelloHeadersSize;
+    uint16_t length;
+
+    memset(aBuffer, 0, kTestMaxDatagramSize);
+
+    // client_version, random, session_id, cookie, cipher_suites and compression_methods
+    *cursor++ = 254;
+    *cursor++ = 253;
+    cursor += 32;
+    *cursor++ = 0;
+    *cursor++ = aCookieLength;
+
+    if (aCookieLength > 0)
+    {
+        memcpy(cursor, aCookie, aCookieLength);
+        cursor += aCookieLength;
+    }
+
+    *cursor++ = 0;
+    *cursor++ = 2;
+    *cursor++ = 0xc0;
+    *cursor++ = 0xff;
+    *cursor++ = 1;
+    *cursor++ = 0;
+    length    = static_cast<uint16_t>(cursor - aBuffer - kTestHelloHeadersSize);
+
+    aBuffer[0]  = 22;
+    aBuffer[1]  = 254;
+    aBuffer[2]  = 253;
+    aBuffer[10] = 7;
+    aBuffer[11] = static_cast<uint8_t>((kTestHandshakeHeaderSize + length) >> 8);
+    aBuffer[12] = static_cast<uint8_t>(kTestHandshakeHeaderSize + length);
+    aBuffer[13] = 1;
+    aBuffer[15] = static_cast<uint8_t>(length >> 8);
+    aBuffer[16] = static_cast<uint8_t>(length);
+    aBuffer[18] = aMessageSeq;
+    aBuffer[23] = aBuffer[15];
+    aBuffer[24] = aBuffer[16];
+
+    return static_cast<uint16_t>(cursor - aBuffer);
+}
+
+TEST_GROUP(MbedtlsCookie)
+{
+    MbedtlsServer *mServer;
+    int            mClient;
+    sockaddr_in6   mClientSock;
+    sockaddr_in6   mServerSock;
+
+    void setup(void)
+    {
+        static const uint8_t kSeed[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+        socklen_t            length  = sizeof(mClientSock);
+
+        mServer = new MbedtlsServer(0, NULL, NULL);
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->SetSeed(kSeed, sizeof(kSeed)));
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->Start());
+
+        // the HelloVerifyRequest is sent to this socket, from the loopback address the ClientHello was sent to
+        mServerSock = MakeTestSock(0);
+        mClientSock = MakeTestSock(0);
+        mClient     = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+        CHECK(mClient >= 0);
+        CHECK_EQUAL(0, bind(mClient, reinterpret_cast<sockaddr *>(&mClientSock), sizeof(mClientSock)));
+        CHECK_EQUAL(0, getsockname(mClient, reinterpret_cast<sockaddr *>(&mClientSock), &length));
+    }
+
+    void teardown(void)
+    {
+        close(mClient);
+        delete mServer;
+    }
+
+    bool Exchange(const uint8_t *aBuffer, uint16_t aLength)
+    {
+        return MbedtlsTester::ExchangeCookie(*mServer, aBuffer, aLength, mClientSock, mServerSock);
+    }
+
+    ssize_t Receive(uint8_t *aBuffer)
+    {
+        // loopback delivers the datagram before sendmsg() returns
+        return recv(mClient, aBuffer, kTestMaxDatagramSize, MSG_DONTWAIT);
+    }
+};
+
+TEST(MbedtlsCookie, TestRoundTrip)
+{
+    uint8_t  hello[kTestMaxDatagramSize];
+    uint8_t  reply[kTestMaxDatagramSize];
+    uint16_t length = BuildTestClientHello(hello, 0, NULL, 0);
+    ssize_t  replyLength;
+    uint8_t  cookieLength;
+
+    // A ClientHello without a cookie is answered with a HelloVerifyRequest.
+    CHECK_EQUAL(false, Exchange(hello, length));
+    replyLength = Receive(reply);
+    CHECK(replyLength > kTestHelloHeadersSize + 3);
+    cookieLength = reply[kTestHelloHeadersSize + 2];
+    CHECK(cookieLength > 0);
+    CHECK_EQUAL(kTestHelloHeadersSize + 3 + cookieLength, replyLength);
+
+    // The record reuses the epoch and sequence number of the ClientHello, the handshake its message_seq.
+    CHECK_EQUAL(22, reply[0]);
+    MEMCMP_EQUAL(&hello[1], &reply[1], 10);
+    CHECK_EQUAL(replyLength - kTestRecordHeaderSize, (reply[11] << 8) | reply[12]);
+    CHECK_EQUAL(3, reply[13]);
+    CHECK_EQUAL(3 + cookieLength, (reply[14] << 16) | (reply[15] << 8) | reply[16]);
+    MEMCMP_EQUAL(&hello[17], &reply[17], 2);
+    MEMCMP_EQUAL("\0\0\0", &reply[19], 3);
+    MEMCMP_EQUAL(&reply[14], &reply[22], 3);
+    CHECK_EQUAL(254, reply[kTestHelloHeadersSize]);
+    CHECK_EQUAL(253, reply[kTestHelloHeadersSize + 1]);
+
+    // The ClientHello echoing the cookie may start a session, and is not answered.
+    length = BuildTestClientHello(hello, 1, &reply[kTestHelloHeadersSize + 3], cookieLength);
+    CHECK_EQUAL(true, Exchange(hello, length));
+    CHECK(Receive(reply) < 0);
+}
+
+TEST(MbedtlsCookie, TestBadCookie)
+{
+    uint8_t  hello[kTestMaxDatagramSize];
+    uint8_t  reply[kTestMaxDatagramSize];
+    uint8_t  cookie[kTestMaxDatagramSize];
+    uint16_t length = BuildTestClientHello(hello, 0, NULL, 0);
+    uint8_t  cookieLength;
+
+    CHECK_EQUAL(false, Exchange(hello, length));
+    CHECK(Receive(reply) > kTestHelloHeadersSize + 3);
+    cookieLength = reply[kTestHelloHeadersSize + 2];
+    memcpy(cookie, &reply[kTestHelloHeadersSize + 3], cookieLength);
+
+    // A cookie altered or sent from another port gets a fresh HelloVerifyRequest.
+    cookie[cookieLength - 1] ^= 0x01;
+    length = BuildTestClientHello(hello, 1, cookie, cookieLength);
+    CHECK_EQUAL(false, Exchange(hello, length));
+    CHECK(Receive(reply) > 0);
+    CHECK_EQUAL(3, reply[13]);
+
+    cookie[cookieLength - 1] ^= 0x01;
+    length = BuildTestClientHello(hello, 1, cookie, cookieLength);
+    mClientSock.sin6_port = htons(static_cast<uint16_t>(ntohs(mClientSock.sin6_port) ^ 1));
+    CHECK_EQUAL(false, Exchange(hello, length));
+}
+
+TEST(MbedtlsCookie, TestMalformed)
+{
+    uint8_t  hello[kTestMaxDatagramSize];
+    uint8_t  reply[kTestMaxDatagramSize];
+    uint8_t  cookie[] = {0x01, 0x02, 0x03, 0x04};
+    uint16_t length   = BuildTestClientHello(hello, 1, cookie, sizeof(cookie));
+
+    // Truncated before the handshake header ends, or before the message ends.
+    CHECK_EQUAL(false, Exchange(hello, kTestHelloHeadersSize - 1));
+    CHECK_EQUAL(false, Exchange(hello, static_cast<uint16_t>(length - 1)));
+    CHECK_EQUAL(false, Exchange(hello, kTestOffsetOfSessionId));
+
+    // Not a handshake record of epoch 0, or not a ClientHello.
+    hello[0] = 23;
+    CHECK_EQUAL(false, Exchange(hello, length));
+    hello[0] = 22;
+    hello[4] = 1;
+    CHECK_EQUAL(false, Exchange(hello, length));
+    hello[4]  = 0;
+    hello[13] = 2;
+    CHECK_EQUAL(false, Exchange(hello, length));
+    hello[13] = 1;
+
+    // A fragment of a ClientHello, whether the first one or a later one.
+    hello[24]--;
+    CHECK_EQUAL(false, Exchange(hello, length));
+    hello[24]++;
+    hello[21] = 1;
+    CHECK_EQUAL(false, Exchange(hello, length));
+    hello[21] = 0;
+
+    // A session_id or cookie running past the end of the message.
+    hello[kTestOffsetOfSessionId] = 255;
+    CHECK_EQUAL(false, Exchange(hello, length));
+    hello[kTestOffsetOfSessionId]     = 0;
+    hello[kTestOffsetOfSessionId + 1] = 255;
+    CHECK_EQUAL(false, Exchange(hello, length));
+
+    // None of these is answered.
+    CHECK(Receive(reply) < 0);
+}
+
+TEST(MbedtlsServer, TestHandshakeDeadline)
+{
+    MbedtlsSession *                    established = NewSession(MakeTestSock(1));
+    std::vector<MbedtlsSession *>       handshakes;
+    std::vector<const MbedtlsSession *> order;
+    fd_set                              readFdSet;
+    fd_set                              writeFdSet;
+    fd_set                              errorFdSet;
+    int                                 maxFd   = -1;
+    timeval                             timeout = {10, 0};
+
+    MbedtlsTester::AddSession(*mServer, *established);
+    MbedtlsTester::SetState(*established, Session::kStateReady);
+
+    // Handshakes expire before the established session refreshed earlier.
+    for (uint16_t port = 2; handshakes.size() < MbedtlsTester::GetMaxHandshakes(); port++)
+    {
+        handshakes.push_back(NewSession(MakeTestSock(port)));
+        MbedtlsTester::AddSession(*mServer, *handshakes.back());
+    }
+
+    order = MbedtlsTester::GetExpiryOrder(*mServer);
+    CHECK_EQUAL(handshakes.size() + 1, order.size());
+    CHECK_EQUAL(established, order.back());
+
+    for (size_t i = 0; i < handshakes.size(); i++)
+    {
+        CHECK_EQUAL(handshakes[i], order[i]);
+    }
+
+    // No more handshakes while all peers in progress are responsive.
+    CHECK_EQUAL(false, MbedtlsTester::AdmitSession(*mServer));
+    CHECK_EQUAL(handshakes.size() + 1, MbedtlsTester::GetSessions(*mServer).GetSize());
+
+    // The handshake silent the longest gives way once its peer missed a retransmission.
+    MbedtlsTester::Silence(*handshakes[0], 2000);
+    CHECK_EQUAL(true, MbedtlsTester::AdmitSession(*mServer));
+    CHECK_EQUAL(handshakes.size(), MbedtlsTester::GetSessions(*mServer).GetSize());
+    CHECK_EQUAL(handshakes[1], MbedtlsTester::GetExpiryOrder(*mServer).front());
+
+    // A handshake silent past its deadline expires, long before an established session would.
+    MbedtlsTester::Silence(*handshakes[1], MbedtlsTester::GetHandshakeTimeout());
+    FD_ZERO(&readFdSet);
+    FD_ZERO(&writeFdSet);
+    FD_ZERO(&errorFdSet);
+    mServer->UpdateFdSet(readFdSet, writeFdSet, errorFdSet, maxFd, timeout);
+    order = MbedtlsTester::GetExpiryOrder(*mServer);
+    CHECK_EQUAL(handshakes.size() - 1, order.size());
+    CHECK_EQUAL(handshakes[2], order.front());
+    CHECK_EQUAL(established, order.back());
+}
+
+TEST(MbedtlsServer, TestMoveSession)
+{
+    MbedtlsSession *    roaming  = NewSession(MakeTestSock(1));
+    MbedtlsSession *    live     = NewSession(MakeTestSock(2));
+    MbedtlsSession *    ended    = NewSession(MakeTestSock(3));
+    const SessionTable &sessions = MbedtlsTester::GetSessions(*mServer);
+
+    MbedtlsTester::AddSession(*mServer, *roaming);
+    MbedtlsTester::AddSession(*mServer, *live);
+    MbedtlsTester::AddSession(*mServer, *ended);
+    MbedtlsTester::SetState(*roaming, Session::kStateReady);
+    MbedtlsTester::SetState(*live, Session::kStateReady);
+    MbedtlsTester::SetState(*ended, Session::kStateEnd);
+
+    // A live session keeps its address.
+    MbedtlsTester::MoveSession(*mServer, *roaming, MakeTestSock(2));
+    CHECK_EQUAL(roaming, sessions.Find(MakeTestSock(1)));
+    CHECK_EQUAL(live, sessions.Find(MakeTestSock(2)));
+    CHECK_EQUAL(3, sessions.GetSize());
+
+    // An ended session gives its address up and is freed.
+    MbedtlsTester::MoveSession(*mServer, *roaming, MakeTestSock(3));
+    CHECK(sessions.Find(MakeTestSock(1)) == NULL);
+    CHECK_EQUAL(roaming, sessions.Find(MakeTestSock(3)));
+    CHECK_EQUAL(2, sessions.GetSize());
+    CHECK_EQUAL(2, MbedtlsTester::GetExpiryOrder(*mServer).size());
+}
+
+TEST(MbedtlsServer, TestHandshakeTrace)
+{
+    char   buffer[2048];
+    FILE * fp;
+    size_t length;
+
+    // A session freed while handshaking, e.g. expired or evicted, ends the span of its handshake.
+    otbrTraceInit(16);
+    delete NewSession(MakeTestSock(1));
+    CHECK_EQUAL(OTBR_ERROR_NONE, otbrTraceExport("/tmp/otbr-test-dtls-trace.json"));
+    otbrTraceDeinit();
+
+    fp = fopen("/tmp/otbr-test-dtls-trace.json", "r");
+    CHECK(fp != NULL);
+    length         = fread(buffer, 1, sizeof(buffer) - 1, fp);
+    buffer[length] = 0;
+    fclose(fp);
+    unlink("/tmp/otbr-test-dtls-trace.json");
+
+    CHECK(strstr(buffer, "{\"name\":\"handshake\",\"cat\":\"dtls\",\"ph\":\"b\"") != NULL);
+    CHECK(strstr(buffer, "{\"name\":\"handshake\",\"cat\":\"dtls\",\"ph\":\"e\"") != NULL);
+}
+
+/** The joiner end of a session, i.e. a DTLS client, and what the server under test handed to it */
+struct TestJoiner
+{
+    mbedtls_entropy_context           mEntropy;
+    mbedtls_ctr_drbg_context          mCtrDrbg;
+    mbedtls_ssl_config                mConf;
+    mbedtls_ssl_context               mSsl;
+    mbedtls_timing_delay_context      mTimer;
+    int                               mSocket;      ///< Connected to the server, replaced when the joiner moves.
+    bool                              mIsCapturing; ///< Whether records are kept instead of sent.
+    std::vector<std::vector<uint8_t>> mCaptured;    ///< Records kept, to be sent later from any socket.
+    MbedtlsSession *                  mSession;     ///< Session of the joiner on the server, once ready.
+    std::vector<std::vector<uint8_t>> mReceived;    ///< Messages the server received from the joiner.
+};
+
+int TestJoinerSend(void *aContext, const unsigned char *aBuffer, size_t aLength)
+{
+    TestJoiner &joiner = *static_cast<TestJoiner *>(aContext);
+    ssize_t     rval   = static_cast<ssize_t>(aLength);
+
+    if (joiner.mIsCapturing)
+    {
+        joiner.mCaptured.push_back(std::vector<uint8_t>(aBuffer, aBuffer + aLength));
+    }
+    else
+    {
+        rval = send(joiner.mSocket, aBuffer, aLength, MSG_DONTWAIT);
+    }
+
+    return rval < 0 ? MBEDTLS_ERR_SSL_WANT_WRITE : static_cast<int>(rval);
+}
+
+int TestJoinerReceive(void *aContext, unsigned char *aBuffer, size_t aLength)
+{
+    TestJoiner &joiner = *static_cast<TestJoiner *>(aContext);
+    ssize_t     rval   = recv(joiner.mSocket, aBuffer, aLength, MSG_DONTWAIT);
+
+    return rval < 0 ? MBEDTLS_ERR_SSL_WANT_READ : static_cast<int>(rval);
+}
+
+void TestJoinerData(const uint8_t *aBuffer, uint16_t aLength, void *aContext)
+{
+    TestJoiner &joiner = *static_cast<TestJoiner *>(aContext);
+
+    joiner.mReceived.push_back(std::vector<uint8_t>(aBuffer, aBuffer + aLength));
+}
+
+void TestJoinerState(Session &aSession, Session::State aState, void *aContext)
+{
+    TestJoiner &joiner = *static_cast<TestJoiner *>(aContext);
+
+    if (aState == Session::kStateReady)
+    {
+        joiner.mSession = static_cast<MbedtlsSession *>(&aSession);
+        aSession.SetDataHandler(TestJoinerData, aContext);
+    }
+}
+
+TEST_GROUP(MbedtlsJoiner)
+{
+    MbedtlsServer *mServer;
+    TestJoiner     mJoiner;
+    sockaddr_in6   mServerSock;
+
+    void setup(void)
+    {
+        static const uint8_t kSeed[]         = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+        static const uint8_t kPsk[]          = {'J', '0', '1', 'N', 'M', 'E'};
+        static const int     kCiphersuites[] = {MBEDTLS_TLS_ECJPAKE_WITH_AES_128_CCM_8, 0};
+        socklen_t            length          = sizeof(mServerSock);
+
+        mServer = new MbedtlsServer(0, TestJoinerState, &mJoiner);
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->SetSeed(kSeed, sizeof(kSeed)));
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->SetPSK(kPsk, sizeof(kPsk)));
+        CHECK_EQUAL(OTBR_ERROR_NONE, mServer->Start());
+
+        // the server is bound to an ephemeral port of any address
+        CHECK_EQUAL(0, getsockname(MbedtlsTester::GetSocket(*mServer), reinterpret_cast<sockaddr *>(&mServerSock),
+                                   &length));
+        mServerSock.sin6_addr = in6addr_loopback;
+        mJoiner.mSocket       = Connect();
+        mJoiner.mIsCapturing  = false;
+        mJoiner.mSession      = NULL;
+
+        mbedtls_entropy_init(&mJoiner.mEntropy);
+        mbedtls_ctr_drbg_init(&mJoiner.mCtrDrbg);
+        mbedtls_ssl_config_init(&mJoiner.mConf);
+        mbedtls_ssl_init(&mJoiner.mSsl);
+        CHECK_EQUAL(0, mbedtls_ctr_drbg_seed(&mJoiner.mCtrDrbg, mbedtls_entropy_func, &mJoiner.mEntropy, NULL, 0));
+        CHECK_EQUAL(0, mbedtls_ssl_config_defaults(&mJoiner.mConf, MBEDTLS_SSL_IS_CLIENT,
+                                                   MBEDTLS_SSL_TRANSPORT_DATAGRAM, MBEDTLS_SSL_PRESET_DEFAULT));
+        mbedtls_ssl_conf_rng(&mJoiner.mConf, mbedtls_ctr_drbg_random, &mJoiner.mCtrDrbg);
+        mbedtls_ssl_conf_min_version(&mJoiner.mConf, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
+        mbedtls_ssl_conf_max_version(&mJoiner.mConf, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
+        mbedtls_ssl_conf_ciphersuites(&mJoiner.mConf, kCiphersuites);
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+        // the joiner puts the connection ID of the server in its records, and does not need one itself
+        CHECK_EQUAL(0, mbedtls_ssl_conf_cid(&mJoiner.mConf, 0, MBEDTLS_SSL_UNEXPECTED_CID_IGNORE));
+#endif
+        CHECK_EQUAL(0, mbedtls_ssl_setup(&mJoiner.mSsl, &mJoiner.mConf));
+        CHECK_EQUAL(0, mbedtls_ssl_set_hs_ecjpake_password(&mJoiner.mSsl, kPsk, sizeof(kPsk)));
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+        CHECK_EQUAL(0, mbedtls_ssl_set_cid(&mJoiner.mSsl, MBEDTLS_SSL_CID_ENABLED, NULL, 0));
+#endif
+        mbedtls_ssl_set_bio(&mJoiner.mSsl, &mJoiner, TestJoinerSend, TestJoinerReceive, NULL);
+        mbedtls_ssl_set_timer_cb(&mJoiner.mSsl, &mJoiner.mTimer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+    }
+
+    void teardown(void)
+    {
+        mbedtls_ssl_free(&mJoiner.mSsl);
+        mbedtls_ssl_config_free(&mJoiner.mConf);
+        mbedtls_ctr_drbg_free(&mJoiner.mCtrDrbg);
+        mbedtls_entropy_free(&mJoiner.mEntropy);
+        close(mJoiner.mSocket);
+        delete mServer;
+    }
+
+    int Connect(void)
+    {
+        int sock = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+
+        CHECK(sock >= 0);
+        CHECK_EQUAL(0, connect(sock, reinterpret_cast<sockaddr *>(&mServerSock), sizeof(mServerSock)));
+
+        return sock;
+    }
+
+    sockaddr_in6 GetSockName(int aSocket)
+    {
+        sockaddr_in6 sock;
+        socklen_t    length = sizeof(sock);
+
+        CHECK_EQUAL(0, getsockname(aSocket, reinterpret_cast<sockaddr *>(&sock), &length));
+
+        return sock;
+    }
+
+    /** Sends a record the joiner captured from the given socket, and lets the server process it */
+    void SendFrom(int aSocket, const std::vector<uint8_t> &aRecord)
+    {
+        CHECK_EQUAL(static_cast<ssize_t>(aRecord.size()), send(aSocket, &aRecord[0], aRecord.size(), 0));
+        Pump();
+    }
+
+    /** Sends a datagram from the joiner, and lets the server receive it without collecting finished handshakes */
+    void Deliver(const std::vector<uint8_t> &aDatagram)
+    {
+        fd_set readFdSet;
+        fd_set writeFdSet;
+        fd_set errorFdSet;
+
+        CHECK_EQUAL(static_cast<ssize_t>(aDatagram.size()), send(mJoiner.mSocket, &aDatagram[0], aDatagram.size(), 0));
+        FD_ZERO(&readFdSet);
+        FD_ZERO(&writeFdSet);
+        FD_ZERO(&errorFdSet);
+        FD_SET(MbedtlsTester::GetSocket(*mServer), &readFdSet);
+        mServer->Process(readFdSet, writeFdSet, errorFdSet);
+    }
+
+    /** Waits for a handshake worker to finish, and lets the server collect it */
+    void Collect(void)
+    {
+        fd_set  readFdSet;
+        fd_set  writeFdSet;
+        fd_set  errorFdSet;
+        int     eventFd = MbedtlsTester::GetEventFd(*mServer);
+        timeval timeout = {5, 0};
+
+        FD_ZERO(&readFdSet);
+        FD_ZERO(&writeFdSet);
+        FD_ZERO(&errorFdSet);
+        FD_SET(eventFd, &readFdSet);
+        CHECK_EQUAL(1, select(eventFd + 1, &readFdSet, NULL, NULL, &timeout));
+        mServer->Process(readFdSet, writeFdSet, errorFdSet);
+    }
+
+    std::vector<uint8_t> Capture(void)
+    {
+        static const uint8_t kMessage[] = {'C'};
+
+        mJoiner.mIsCapturing = true;
+        CHECK_EQUAL(static_cast<int>(sizeof(kMessage)), mbedtls_ssl_write(&mJoiner.mSsl, kMessage, sizeof(kMessage)));
+        mJoiner.mIsCapturing = false;
+
+        return mJoiner.mCaptured.back();
+    }
+
+    /** Runs one iteration of the main loop of the server */
+    void Pump(void)
+    {
+        fd_set  readFdSet;
+        fd_set  writeFdSet;
+        fd_set  errorFdSet;
+        int     maxFd   = -1;
+        timeval timeout = {0, kTestPollInterval};
+
+        FD_ZERO(&readFdSet);
+        FD_ZERO(&writeFdSet);
+        FD_ZERO(&errorFdSet);
+        mServer->UpdateFdSet(readFdSet, writeFdSet, errorFdSet, maxFd, timeout);
+        CHECK(select(maxFd + 1, &readFdSet, &writeFdSet, &errorFdSet, &timeout) >= 0);
+        mServer->Process(readFdSet, writeFdSet, errorFdSet);
+    }
+
+    void Join(void)
+    {
+        int rval = mbedtls_ssl_handshake(&mJoiner.mSsl);
+
+        // the server takes its turn whenever the joiner waits for it
+        for (int i = 0; i < kTestMaxRounds && (rval == MBEDTLS_ERR_SSL_WANT_READ || rval == MBEDTLS_ERR_SSL_WANT_WRITE);
+             i++)
+        {
+            Pump();
+            rval = mbedtls_ssl_handshake(&mJoiner.mSsl);
+        }
+
+        CHECK_EQUAL(0, rval);
+        CHECK(mJoiner.mSession != NULL);
+        CHECK_EQUAL(Session::kStateReady, mJoiner.mSession->GetState());
+    }
+};
+
+TEST(MbedtlsJoiner, TestWriteQueue)
+{
+    uint8_t         message[] = {'Q', 0};
+    uint8_t         buffer[kTestMaxDatagramSize];
+    fd_set          readFdSet;
+    fd_set          writeFdSet;
+    fd_set          errorFdSet;
+    int             maxFd   = -1;
+    timeval         timeout = {0, 0};
+    MbedtlsSession *session;
+
+    Join();
+    session = mJoiner.mSession;
+
+    // Messages wait in order while the socket is not writable, up to a bound.
+    MbedtlsTester::SetBusy(*session, true);
+
+    for (size_t i = 0; i < MbedtlsTester::GetMaxOutbound(); i++)
+    {
+        message[1] = static_cast<uint8_t>(i);
+        CHECK_EQUAL(static_cast<ssize_t>(sizeof(message)), session->Write(message, sizeof(message)));
+    }
+
+    errno = 0;
+    CHECK_EQUAL(-1, session->Write(message, sizeof(message)));
+    CHECK_EQUAL(EAGAIN, errno);
+    CHECK_EQUAL(1, MbedtlsTester::GetCongestedSessions(*mServer));
+
+    // The server waits for the socket to become writable, and flushes the queue then.
+    MbedtlsTester::SetBusy(*session, false);
+    FD_ZERO(&readFdSet);
+    FD_ZERO(&writeFdSet);
+    FD_ZERO(&errorFdSet);
+    mServer->UpdateFdSet(readFdSet, writeFdSet, errorFdSet, maxFd, timeout);
+    CHECK(FD_ISSET(MbedtlsTester::GetSocket(*mServer), &writeFdSet));
+    Pump();
+    CHECK_EQUAL(0, MbedtlsTester::GetCongestedSessions(*mServer));
+
+    for (size_t i = 0; i < MbedtlsTester::GetMaxOutbound(); i++)
+    {
+        CHECK_EQUAL(static_cast<int>(sizeof(message)), mbedtls_ssl_read(&mJoiner.mSsl, buffer, sizeof(buffer)));
+        CHECK_EQUAL(static_cast<uint8_t>(i), buffer[1]);
+    }
+
+    CHECK_EQUAL(MBEDTLS_ERR_SSL_WANT_READ, mbedtls_ssl_read(&mJoiner.mSsl, buffer, sizeof(buffer)));
+
+    // A removed session no longer keeps the server waiting for the socket.
+    MbedtlsTester::SetBusy(*session, true);
+    CHECK_EQUAL(static_cast<ssize_t>(sizeof(message)), session->Write(message, sizeof(message)));
+    CHECK_EQUAL(1, MbedtlsTester::GetCongestedSessions(*mServer));
+    MbedtlsTester::RemoveSession(*mServer, *session);
+    CHECK_EQUAL(0, MbedtlsTester::GetCongestedSessions(*mServer));
+    FD_ZERO(&writeFdSet);
+    mServer->UpdateFdSet(readFdSet, writeFdSet, errorFdSet, maxFd, timeout);
+    CHECK(!FD_ISSET(MbedtlsTester::GetSocket(*mServer), &writeFdSet));
+
+    delete session;
+}
+
+TEST(MbedtlsJoiner, TestHandshakeOffload)
+{
+    const SessionTable & sessions = MbedtlsTester::GetSessions(*mServer);
+    std::vector<uint8_t> hello;
+    MbedtlsSession *     session;
+    fd_set               readFdSet;
+    fd_set               writeFdSet;
+    fd_set               errorFdSet;
+    int                  maxFd   = -1;
+    timeval              timeout = {0, 0};
+
+    CHECK_EQUAL(OTBR_ERROR_NONE, MbedtlsTester::StartPool(*mServer, 1));
+
+    // The joiner gets a cookie, and its ClientHello echoing it is held back.
+    mJoiner.mIsCapturing = true;
+    CHECK_EQUAL(MBEDTLS_ERR_SSL_WANT_READ, mbedtls_ssl_handshake(&mJoiner.mSsl));
+    CHECK_EQUAL(1, mJoiner.mCaptured.size());
+    Deliver(mJoiner.mCaptured.back());
+    CHECK_EQUAL(MBEDTLS_ERR_SSL_WANT_READ, mbedtls_ssl_handshake(&mJoiner.mSsl));
+    mJoiner.mIsCapturing = false;
+    CHECK_EQUAL(2, mJoiner.mCaptured.size());
+    hello = mJoiner.mCaptured.back();
+
+    // The worker owns the session, and a retransmission of the ClientHello waits for it.
+    Deliver(hello);
+    session = sessions.Find(GetSockName(mJoiner.mSocket));
+    CHECK(session != NULL);
+    CHECK(MbedtlsTester::IsOffloaded(*session));
+    Deliver(hello);
+    CHECK(MbedtlsTester::IsOffloaded(*session));
+    CHECK_EQUAL(1, MbedtlsTester::GetBacklogSize(*session));
+
+    // A session owned by the worker is never freed, even past its deadline.
+    MbedtlsTester::Silence(*session, MbedtlsTester::GetHandshakeTimeout());
+    FD_ZERO(&readFdSet);
+    FD_ZERO(&writeFdSet);
+    FD_ZERO(&errorFdSet);
+    mServer->UpdateFdSet(readFdSet, writeFdSet, errorFdSet, maxFd, timeout);
+    CHECK_EQUAL(session, sessions.Find(GetSockName(mJoiner.mSocket)));
+
+    // Once given back, the session replays the retransmission, which hands it to the worker again.
+    Collect();
+    CHECK_EQUAL(0, MbedtlsTester::GetBacklogSize(*session));
+    CHECK(MbedtlsTester::IsOffloaded(*session));
+    Collect();
+    CHECK(!MbedtlsTester::IsOffloaded(*session));
+    CHECK_EQUAL(Session::kStateHandshaking, session->GetState());
+    CHECK_EQUAL(session, sessions.Find(GetSockName(mJoiner.mSocket)));
+}
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+TEST(MbedtlsJoiner, TestRoaming)
+{
+    const SessionTable & sessions  = MbedtlsTester::GetSessions(*mServer);
+    int                  oldSocket = -1;
+    int                  other     = -1;
+    uint8_t              reply[kTestMaxDatagramSize];
+    sockaddr_in6         oldSock;
+    sockaddr_in6         newSock;
+    sockaddr_in6         otherSock;
+    std::vector<uint8_t> delayed;
+    std::vector<uint8_t> moving;
+    std::vector<uint8_t> record;
+
+    Join();
+    oldSock = GetSockName(mJoiner.mSocket);
+
+    // A record held back on the old path, and one sent from the new address.
+    delayed = Capture();
+    moving  = Capture();
+    CHECK_EQUAL(kTestContentTypeCid, delayed[0]);
+
+    // A record routed by connection ID moves the session to the address it came from.
+    oldSocket       = mJoiner.mSocket;
+    mJoiner.mSocket = Connect();
+    newSock         = GetSockName(mJoiner.mSocket);
+    SendFrom(mJoiner.mSocket, moving);
+    CHECK_EQUAL(1, mJoiner.mReceived.size());
+    CHECK_EQUAL(mJoiner.mSession, sessions.Find(newSock));
+    CHECK(sessions.Find(oldSock) == NULL);
+    CHECK_EQUAL(1, sessions.GetSize());
+
+    // An older record is still delivered, but does not move the session back.
+    SendFrom(oldSocket, delayed);
+    CHECK_EQUAL(2, mJoiner.mReceived.size());
+    CHECK_EQUAL(mJoiner.mSession, sessions.Find(newSock));
+    CHECK(sessions.Find(oldSock) == NULL);
+
+    // A replayed record is dropped, wherever it comes from.
+    other     = Connect();
+    otherSock = GetSockName(other);
+    SendFrom(other, moving);
+    CHECK_EQUAL(2, mJoiner.mReceived.size());
+    CHECK_EQUAL(mJoiner.mSession, sessions.Find(newSock));
+    CHECK(sessions.Find(otherSock) == NULL);
+
+    // A newer record that fails authentication does not move the session.
+    record = Capture();
+    record.back() ^= 0x01;
+    SendFrom(other, record);
+    CHECK_EQUAL(2, mJoiner.mReceived.size());
+    CHECK_EQUAL(mJoiner.mSession, sessions.Find(newSock));
+    CHECK(sessions.Find(otherSock) == NULL);
+
+    // A record of an unknown connection ID is dropped, without a HelloVerifyRequest.
+    record = Capture();
+    record[kTestOffsetOfCid] ^= 0xff;
+    SendFrom(other, record);
+    CHECK_EQUAL(2, mJoiner.mReceived.size());
+    CHECK_EQUAL(1, sessions.GetSize());
+    CHECK(recv(other, reply, sizeof(reply), MSG_DONTWAIT) < 0);
+
+    // The session is still served at its new address.
+    SendFrom(mJoiner.mSocket, Capture());
+    CHECK_EQUAL(3, mJoiner.mReceived.size());
+    CHECK_EQUAL(mJoiner.mSession, sessions.Find(newSock));
+
+    close(oldSocket);
+    close(other);
+}
+#endif
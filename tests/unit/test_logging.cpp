@@ -29,9 +29,11 @@
 #include <CppUTest/TestHarness.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
+#include "common/flight_recorder.hpp"
 #include "common/logging.hpp"
 
 TEST_GROUP(Logging){};
@@ -95,10 +97,12 @@ TEST(Logging, TestLoggingDump)
     sleep(0);
 
     /*
-     * Above produces output like this
+     * Above produces a single multi-line record like this
      * otbr-test-5976[47088]: foobar: 0000: 6f 6e 65 20 73 75 70 65 72 20 6c 6f 6e 67 20 73
-     * otbr-test-5976[47088]: foobar: 0010: 74 72 69 6e 67 20 77 69 74 68 20 6c 6f 74 73 20
-     * otbr-test-5976[47088]: foobar: 0020: 6f 66 20 74 65 78 74 00
+     * foobar: 0010: 74 72 69 6e 67 20 77 69 74 68 20 6c 6f 74 73 20
+     * foobar: 0020: 6f 66 20 74 65 78 74 00
+     *
+     * which syslog stores on one line with the NEWLINEs escaped as #012.
      */
 
     sprintf(cmd, "grep '%s.*: foobar: 0000: 6f 6e 65 20 73 75 70 65 72 20 6c 6f 6e 67 20 73' /var/log/syslog", ident);
@@ -109,4 +113,108 @@ TEST(Logging, TestLoggingDump)
 
     sprintf(cmd, "grep '%s.*: foobar: 0020: 6f 66 20 74 65 78 74 00' /var/log/syslog", ident);
     CHECK(0 == system(cmd));
+
+    sprintf(cmd, "test $(grep -c '%s.*: foobar: ' /var/log/syslog) -eq 1", ident);
+    CHECK(0 == system(cmd));
+}
+
+TEST(Logging, TestLoggingFilteredArguments)
+{
+    char ident[20];
+    int  evaluated = 0;
+
+    sprintf(ident, "otbr-test-%ld", clock());
+    otbrLogInit(ident, OTBR_LOG_INFO, true);
+    otbrLog(OTBR_LOG_DEBUG, "cool-filtered %d", ++evaluated);
+    otbrDump(OTBR_LOG_DEBUG, "cool-filtered", ident, ++evaluated);
+    otbrLog(OTBR_LOG_INFO, "cool-unfiltered %d", ++evaluated);
+    otbrLogDeinit();
+
+    CHECK_EQUAL(1, evaluated);
+}
+
+TEST(Logging, TestLoggingModuleLevel)
+{
+    char ident[20];
+    char cmd[128];
+
+    sprintf(ident, "otbr-test-%ld", clock());
+    otbrLogInit(ident, OTBR_LOG_INFO, true);
+    otbrLogSetModuleLevel(OTBR_LOG_MODULE_AGENT, OTBR_LOG_WARNING);
+    CHECK_EQUAL(OTBR_LOG_WARNING, otbrLogGetModuleLevel(OTBR_LOG_MODULE_AGENT));
+    CHECK_EQUAL(OTBR_LOG_INFO, otbrLogGetModuleLevel(OTBR_LOG_MODULE_DTLS));
+    otbrLog(OTBR_LOG_INFO, "cool-module");
+    otbrLogDeinit();
+    sleep(0);
+
+    sprintf(cmd, "grep '%s.*cool-module' /var/log/syslog", ident);
+    CHECK(0 != system(cmd));
+}
+
+TEST(Logging, TestLoggingRateLimited)
+{
+    char ident[20];
+    char cmd[128];
+
+    sprintf(ident, "otbr-test-%ld", clock());
+    otbrLogInit(ident, OTBR_LOG_INFO, true);
+    for (int i = 0; i < 3; i++)
+    {
+        otbrLogRateLimited(OTBR_LOG_INFO, "cool-repeated");
+    }
+    otbrLogDeinit();
+    sleep(0);
+
+    sprintf(cmd, "test $(grep -c '%s.*cool-repeated' /var/log/syslog) -eq 1", ident);
+    CHECK(0 == system(cmd));
+
+    sprintf(cmd, "grep '%s.*Suppressed 2 messages from test_logging.cpp' /var/log/syslog", ident);
+    CHECK(0 == system(cmd));
+}
+
+TEST(Logging, TestLoggingFlightRecorder)
+{
+    char  ident[20];
+    char  filename[64];
+    char  line[128];
+    int   count = 0;
+    int   last  = -1;
+    FILE *fp;
+
+    sprintf(ident, "otbr-test-%ld", clock());
+    sprintf(filename, "/tmp/%s.rec", ident);
+    otbrLogInit(ident, OTBR_LOG_INFO, true);
+    otbrLogEnableSyslog(false);
+    otbrLogSetFlightRecorder(filename, ot::BorderRouter::FlightRecorder::kMinRingSize);
+
+    // wraps the ring several times
+    for (int i = 0; i < 1000; i++)
+    {
+        otbrLog(OTBR_LOG_INFO, "cool-recorded %d", i);
+    }
+    otbrLog(OTBR_LOG_DEBUG, "cool-unrecorded");
+    otbrLogDeinit();
+    otbrLogEnableSyslog(true);
+
+    fp = tmpfile();
+    CHECK(fp != NULL);
+    CHECK_EQUAL(OTBR_ERROR_NONE, ot::BorderRouter::FlightRecorder::Dump(filename, fp));
+    rewind(fp);
+
+    // only whole records, in order, ending with the newest
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        int index;
+
+        CHECK(strstr(line, "cool-unrecorded") == NULL);
+        CHECK(sscanf(strstr(line, " | "), " | cool-recorded %d", &index) == 1);
+        CHECK(last == -1 || index == last + 1);
+        last = index;
+        count++;
+    }
+    fclose(fp);
+    unlink(filename);
+
+    CHECK(count > 0 && count < 1000);
+    CHECK_EQUAL(999, last);
 }
@@ -0,0 +1,103 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/trace.hpp"
+
+TEST_GROUP(Trace){};
+
+static void ReadFile(const char *aFilename, char *aBuffer, size_t aSize)
+{
+    FILE * fp = fopen(aFilename, "r");
+    size_t length;
+
+    CHECK(fp != NULL);
+    length          = fread(aBuffer, 1, aSize - 1, fp);
+    aBuffer[length] = 0;
+    fclose(fp);
+}
+
+TEST(Trace, TestTraceDisabled)
+{
+    otbrTraceBegin("test", "cool-disabled", 1);
+    CHECK(otbrTraceExport("/tmp/otbr-test-trace.json") != OTBR_ERROR_NONE);
+}
+
+TEST(Trace, TestTraceExport)
+{
+    char buffer[2048];
+
+    otbrTraceInit(16);
+    otbrTraceBegin("test", "cool-span", 0x1234);
+    {
+        ot::BorderRouter::TraceScope scope("test", "cool-scope");
+
+        scope.SetId(0x5678);
+    }
+    otbrTraceInstant("test", "cool-instant", 0x1234);
+    otbrTraceEnd("test", "cool-span", 0x1234);
+    CHECK_EQUAL(OTBR_ERROR_NONE, otbrTraceExport("/tmp/otbr-test-trace.json"));
+    otbrTraceDeinit();
+
+    ReadFile("/tmp/otbr-test-trace.json", buffer, sizeof(buffer));
+    unlink("/tmp/otbr-test-trace.json");
+
+    CHECK(strncmp(buffer, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 39) == 0);
+    CHECK(strstr(buffer, "{\"name\":\"cool-span\",\"cat\":\"test\",\"ph\":\"b\"") != NULL);
+    CHECK(strstr(buffer, "{\"name\":\"cool-span\",\"cat\":\"test\",\"ph\":\"e\"") != NULL);
+    CHECK(strstr(buffer, "{\"name\":\"cool-instant\",\"cat\":\"test\",\"ph\":\"n\"") != NULL);
+    CHECK(strstr(buffer, "{\"name\":\"cool-scope\",\"cat\":\"test\",\"ph\":\"X\"") != NULL);
+    CHECK(strstr(buffer, "\"args\":{\"id\":\"0x5678\"}") != NULL);
+    CHECK(strstr(buffer, "\"id\":\"0x1234\"") != NULL);
+}
+
+TEST(Trace, TestTraceOverwriteOldest)
+{
+    char buffer[4096];
+
+    otbrTraceInit(4);
+    otbrTraceInstant("test", "cool-oldest", 0);
+    for (int i = 0; i < 4; i++)
+    {
+        otbrTraceInstant("test", "cool-newest", i);
+    }
+    CHECK_EQUAL(OTBR_ERROR_NONE, otbrTraceExport("/tmp/otbr-test-trace.json"));
+    otbrTraceDeinit();
+
+    ReadFile("/tmp/otbr-test-trace.json", buffer, sizeof(buffer));
+    unlink("/tmp/otbr-test-trace.json");
+
+    CHECK(strstr(buffer, "cool-oldest") == NULL);
+    CHECK(strstr(buffer, "\"id\":\"0x0\"") != NULL);
+    CHECK(strstr(buffer, "\"id\":\"0x3\"") != NULL);
+}
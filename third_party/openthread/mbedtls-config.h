@@ -33,7 +33,6 @@
 
 #define MBEDTLS_HAVE_ASM
 
-#define MBEDTLS_AES_ROM_TABLES
 #define MBEDTLS_ECP_DP_SECP256R1_ENABLED
 #define MBEDTLS_ECP_NIST_OPTIM
 #define MBEDTLS_KEY_EXCHANGE_ECJPAKE_ENABLED
@@ -41,6 +40,7 @@
 #define MBEDTLS_SSL_PROTO_TLS1_2
 #define MBEDTLS_SSL_PROTO_DTLS
 #define MBEDTLS_SSL_DTLS_ANTI_REPLAY
+#define MBEDTLS_SSL_DTLS_CONNECTION_ID
 #define MBEDTLS_SSL_DTLS_HELLO_VERIFY
 #define MBEDTLS_SSL_EXPORT_KEYS
 
@@ -61,7 +61,6 @@
 #define MBEDTLS_PK_C
 #define MBEDTLS_PK_PARSE_C
 #define MBEDTLS_SHA256_C
-#define MBEDTLS_SHA256_SMALLER
 #define MBEDTLS_SSL_COOKIE_C
 #define MBEDTLS_SSL_CLI_C
 #define MBEDTLS_SSL_SRV_C
@@ -70,7 +69,13 @@
 #define MBEDTLS_NET_C
 #define MBEDTLS_TIMING_C
 
+#if defined(OTBR_MBEDTLS_PROFILE_SPEED)
+// Gateway-class CPUs trade RAM and code size for faster commissioning.
+#define MBEDTLS_AESNI_C
+#else
 #define MBEDTLS_AES_ROM_TABLES
+#define MBEDTLS_SHA256_SMALLER
+#endif
 
 #define MBEDTLS_ECP_MAX_BITS 256
 #define MBEDTLS_MPI_MAX_SIZE 32
@@ -32,4 +32,8 @@ MBEDTLS_CPPFLAGS                                                               =
     -I$(top_srcdir)/third_party/openthread/repo/third_party/mbedtls/repo/include \
     $(NULL)
 
+if OTBR_MBEDTLS_PROFILE_SPEED
+MBEDTLS_CPPFLAGS += -DOTBR_MBEDTLS_PROFILE_SPEED=1
+endif
+
 MBEDTLS_LIBS = $(top_builddir)/third_party/openthread/libmbedcrypto.la
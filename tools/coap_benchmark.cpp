@@ -0,0 +1,353 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file
+ *   This file implements micro-benchmarks of the CoAP codec and dispatch.
+ */
+
+#include <errno.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/coap.hpp"
+#include "common/coap_native.hpp"
+#include "common/code_utils.hpp"
+#include "common/tlv.hpp"
+
+using namespace ot;
+using namespace ot::BorderRouter;
+
+// heap allocations, counted by replacing the global operator new
+static unsigned long sAllocations = 0;
+
+void *operator new(size_t aSize)
+{
+    void *p = malloc(aSize ? aSize : 1);
+
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    sAllocations++;
+
+    return p;
+}
+
+void operator delete(void *aPointer) noexcept
+{
+    free(aPointer);
+}
+
+namespace {
+
+enum
+{
+    kDefaultIterations = 200000,
+    kJoinerRouterRloc  = 0x0400,
+    kJoinerUdpPort     = 1000,
+};
+
+struct Benchmark
+{
+    const char *mName;
+    void (*mSetUp)(void);
+    void (*mRun)(unsigned long aIteration);
+    void (*mTearDown)(void);
+};
+
+Coap::Agent *       sAgent;
+Coap::Resource *    sResources[4];
+uint8_t             sPayload[128];
+uint16_t            sPayloadLength;
+Coap::MessageBuffer sRequest;
+Coap::MessageBuffer sAck;
+
+ssize_t NullSender(const uint8_t *aBuffer, uint16_t aLength, const uint8_t *aIp6, uint16_t aPort, void *aContext)
+{
+    (void)aBuffer;
+    (void)aIp6;
+    (void)aPort;
+    (void)aContext;
+
+    return static_cast<ssize_t>(aLength);
+}
+
+void HandleRequest(const Coap::Resource &aResource,
+                   const Coap::Message & aRequest,
+                   Coap::Message &       aResponse,
+                   const uint8_t *       aIp6,
+                   uint16_t              aPort,
+                   void *                aContext)
+{
+    uint16_t       length;
+    const uint8_t *payload = aRequest.GetPayload(length);
+    const Tlv *    tlv     = reinterpret_cast<const Tlv *>(payload);
+    const Tlv *    end     = reinterpret_cast<const Tlv *>(payload + length);
+
+    // walk the TLVs the way MeshCoP handlers do
+    while (tlv < end)
+    {
+        tlv = tlv->GetNext();
+    }
+
+    aResponse.SetCode(Coap::kCodeChanged);
+
+    (void)aResource;
+    (void)aIp6;
+    (void)aPort;
+    (void)aContext;
+}
+
+void HandleResponse(const Coap::Message *aMessage, otbrError aError, void *aContext)
+{
+    (void)aMessage;
+    (void)aError;
+    (void)aContext;
+}
+
+/**
+ * This function builds a RELAY_rx payload carrying the beginning of a DTLS ClientHello from a joiner.
+ *
+ */
+void BuildRelayPayload(void)
+{
+    uint8_t iid[8]           = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0};
+    uint8_t clientHello[100] = {0x16, 0xfe, 0xfd};
+    Tlv *   tlv              = reinterpret_cast<Tlv *>(sPayload);
+
+    tlv->SetType(Meshcop::kJoinerUdpPort);
+    tlv->SetValue(static_cast<uint16_t>(kJoinerUdpPort));
+    tlv = tlv->GetNext();
+
+    tlv->SetType(Meshcop::kJoinerIid);
+    tlv->SetValue(iid, sizeof(iid));
+    tlv = tlv->GetNext();
+
+    tlv->SetType(Meshcop::kJoinerRouterLocator);
+    tlv->SetValue(static_cast<uint16_t>(kJoinerRouterRloc));
+    tlv = tlv->GetNext();
+
+    tlv->SetType(Meshcop::kJoinerDtlsEncapsulation);
+    tlv->SetValue(clientHello, sizeof(clientHello));
+    tlv = tlv->GetNext();
+
+    sPayloadLength = static_cast<uint16_t>(reinterpret_cast<uint8_t *>(tlv) - sPayload);
+}
+
+void SetUpAgent(void)
+{
+    // the resources of a commissioner
+    static const char *sPaths[] = {"c/rx", "c/la", "c/ur", "c/pc"};
+
+    sAgent = Coap::Agent::Create(NullSender, NULL);
+
+    for (size_t i = 0; i < sizeof(sPaths) / sizeof(sPaths[0]); i++)
+    {
+        sResources[i] = new Coap::Resource(sPaths[i], HandleRequest, NULL);
+        sAgent->AddResource(*sResources[i]);
+    }
+
+    BuildRelayPayload();
+}
+
+void TearDownAgent(void)
+{
+    for (size_t i = 0; i < sizeof(sResources) / sizeof(sResources[0]); i++)
+    {
+        sAgent->RemoveResource(*sResources[i]);
+        delete sResources[i];
+    }
+
+    Coap::Agent::Destroy(sAgent);
+}
+
+void SetUpInput(void)
+{
+    uint8_t token[] = {0xde, 0xad, 0xbe, 0xef};
+
+    SetUpAgent();
+    sRequest.Init(Coap::kTypeConfirmable, Coap::kCodePost, 0, token, sizeof(token));
+    sRequest.SetPath("c/rx");
+    sRequest.SetPayload(sPayload, sPayloadLength);
+}
+
+void RunInput(unsigned long aIteration)
+{
+    // a new message id for each, so that none is taken as a duplicate
+    sRequest.SetMessageId(static_cast<uint16_t>(aIteration));
+    sAgent->Input(sRequest.GetBuffer(), sRequest.GetLength(), NULL, 0);
+}
+
+void SetUpInputNotFound(void)
+{
+    SetUpInput();
+    sRequest.SetPath("c/zz");
+}
+
+void RunBuild(unsigned long aIteration)
+{
+    uint8_t        token   = static_cast<uint8_t>(aIteration);
+    Coap::Message *message = sAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, &token, sizeof(token));
+
+    message->SetPath("c/tx");
+    message->SetPayload(sPayload, sPayloadLength);
+    sAgent->FreeMessage(message);
+}
+
+void RunSendNonConfirmable(unsigned long aIteration)
+{
+    uint8_t        token   = static_cast<uint8_t>(aIteration);
+    Coap::Message *message = sAgent->NewMessage(Coap::kTypeNonConfirmable, Coap::kCodePost, &token, sizeof(token));
+
+    message->SetPath("c/tx");
+    message->SetPayload(sPayload, sPayloadLength);
+    sAgent->Send(*message, NULL, 0, NULL, NULL);
+    sAgent->FreeMessage(message);
+}
+
+void RunSendConfirmable(unsigned long aIteration)
+{
+    uint8_t        token   = static_cast<uint8_t>(aIteration);
+    Coap::Message *message = sAgent->NewMessage(Coap::kTypeConfirmable, Coap::kCodePost, &token, sizeof(token));
+    uint16_t       messageId;
+
+    message->SetPath("c/tx");
+    message->SetPayload(sPayload, sPayloadLength);
+    sAgent->Send(*message, NULL, 0, HandleResponse, NULL);
+    messageId = static_cast<Coap::MessageNative *>(message)->GetMessageId();
+    sAgent->FreeMessage(message);
+
+    // the piggybacked response completes the transaction
+    sAck.Init(Coap::kTypeAcknowledgment, Coap::kCodeChanged, messageId, &token, sizeof(token));
+    sAgent->Input(sAck.GetBuffer(), sAck.GetLength(), NULL, 0);
+}
+
+const Benchmark sBenchmarks[] = {
+    {"input_dispatch", SetUpInput, RunInput, TearDownAgent},
+    {"input_not_found", SetUpInputNotFound, RunInput, TearDownAgent},
+    {"build_message", SetUpAgent, RunBuild, TearDownAgent},
+    {"send_non_confirmable", SetUpAgent, RunSendNonConfirmable, TearDownAgent},
+    {"send_confirmable_ack", SetUpAgent, RunSendConfirmable, TearDownAgent},
+};
+
+unsigned long long GetNanoseconds(void)
+{
+    timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<unsigned long long>(now.tv_sec) * 1000000000ull + static_cast<unsigned long long>(now.tv_nsec);
+}
+
+void help(void)
+{
+    printf("coap-benchmark - measure the CoAP codec and dispatch\n"
+           "SYNTAX:\n"
+           "    coap-benchmark [ITERATIONS [FILE]]\n"
+           "Results are written in JSON to FILE, or to stdout.\n"
+           "EXAMPLE:\n"
+           "    coap-benchmark 1000000 coap.json\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int           ret        = -1;
+    unsigned long iterations = kDefaultIterations;
+    FILE *        output     = stdout;
+    const size_t  count      = sizeof(sBenchmarks) / sizeof(sBenchmarks[0]);
+
+    if (argc > 3 || (argc > 1 && (iterations = strtoul(argv[1], NULL, 0)) == 0))
+    {
+        ExitNow(help());
+    }
+
+    if (argc == 3)
+    {
+        VerifyOrExit((output = fopen(argv[2], "w")) != NULL,
+                     fprintf(stderr, "Cannot open %s: %s\n", argv[2], strerror(errno)));
+    }
+
+    fprintf(output, "{\n  \"iterations\": %lu,\n  \"benchmarks\": [\n", iterations);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Benchmark &  benchmark = sBenchmarks[i];
+        unsigned long long start;
+        unsigned long long elapsed;
+        unsigned long      allocations;
+        uint32_t           poolAllocations;
+
+        benchmark.mSetUp();
+
+        // warm up caches and the message pool
+        for (unsigned long j = 0; j < iterations / 10; j++)
+        {
+            benchmark.mRun(j);
+        }
+
+        allocations     = sAllocations;
+        poolAllocations = static_cast<Coap::AgentNative *>(sAgent)->GetMessagePoolStats().mAllocations;
+        start           = GetNanoseconds();
+
+        for (unsigned long j = 0; j < iterations; j++)
+        {
+            benchmark.mRun(j);
+        }
+
+        elapsed         = GetNanoseconds() - start;
+        allocations     = sAllocations - allocations;
+        poolAllocations =
+            static_cast<Coap::AgentNative *>(sAgent)->GetMessagePoolStats().mAllocations - poolAllocations;
+        benchmark.mTearDown();
+
+        fprintf(output,
+                "    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"allocs_per_op\": %.3f, "
+                "\"pool_allocs_per_op\": %.3f}%s\n",
+                benchmark.mName, static_cast<double>(elapsed) / static_cast<double>(iterations),
+                static_cast<double>(allocations) / static_cast<double>(iterations),
+                static_cast<double>(poolAllocations) / static_cast<double>(iterations), i + 1 < count ? "," : "");
+    }
+
+    fprintf(output, "  ]\n}\n");
+
+    if (output != stdout)
+    {
+        fclose(output);
+    }
+
+    ret = 0;
+
+exit:
+    return ret;
+}
@@ -0,0 +1,325 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file
+ *   This file implements micro-benchmarks of the cryptography used in commissioning.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <mbedtls/ccm.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/ecjpake.h>
+#include <mbedtls/entropy.h>
+#if defined(MBEDTLS_AESNI_C)
+#include <mbedtls/aesni.h>
+#endif
+
+#include "common/code_utils.hpp"
+#include "utils/pskc.hpp"
+
+namespace {
+
+enum
+{
+    kDefaultDuration         = 1000, ///< Time each benchmark runs for in miniseconds.
+    kSizeOfRecord            = 128,  ///< Size of a record payload, e.g. a MeshCoP message.
+    kSizeOfNonce             = 12,   ///< Size of the AES-CCM nonce of a DTLS record.
+    kSizeOfAdditionalData    = 13,   ///< Size of the additional data of a DTLS record.
+    kSizeOfTag               = 8,    ///< Size of the AES-CCM-8 tag.
+    kSizeOfKey               = 16,   ///< Size of the AES-128 key.
+    kMaxSizeOfEcjpakeMessage = 512,  ///< Max size of an EC-JPAKE round message on secp256r1.
+    kSizeOfSecret            = 32,   ///< Size of the premaster secret.
+    kSizeOfExtPanId          = 8,
+};
+
+struct Benchmark
+{
+    const char *mName;
+    void (*mSetUp)(void);
+    void (*mRun)(unsigned long aIteration);
+    void (*mTearDown)(void);
+};
+
+const char kPskd[] = "J01NME";
+
+mbedtls_entropy_context  sEntropy;
+mbedtls_ctr_drbg_context sCtrDrbg;
+mbedtls_ccm_context      sCcm;
+uint8_t                  sRecord[kSizeOfRecord];
+uint8_t                  sCipher[kSizeOfRecord];
+uint8_t                  sTag[kSizeOfTag];
+uint8_t                  sNonce[kSizeOfNonce];
+uint8_t                  sAdditionalData[kSizeOfAdditionalData];
+unsigned long            sErrors = 0;
+
+void NoSetUp(void)
+{
+}
+
+void NoTearDown(void)
+{
+}
+
+/**
+ * This function runs the EC-JPAKE exchange of a joiner and the commissioner in memory.
+ *
+ */
+void RunEcjpake(unsigned long aIteration)
+{
+    mbedtls_ecjpake_context client;
+    mbedtls_ecjpake_context server;
+    uint8_t                 message[kMaxSizeOfEcjpakeMessage];
+    uint8_t                 clientSecret[kSizeOfSecret];
+    uint8_t                 serverSecret[kSizeOfSecret];
+    size_t                  length;
+    int                     ret;
+
+    mbedtls_ecjpake_init(&client);
+    mbedtls_ecjpake_init(&server);
+
+    SuccessOrExit(ret = mbedtls_ecjpake_setup(&client, MBEDTLS_ECJPAKE_CLIENT, MBEDTLS_MD_SHA256,
+                                              MBEDTLS_ECP_DP_SECP256R1, reinterpret_cast<const uint8_t *>(kPskd),
+                                              sizeof(kPskd) - 1));
+    SuccessOrExit(ret = mbedtls_ecjpake_setup(&server, MBEDTLS_ECJPAKE_SERVER, MBEDTLS_MD_SHA256,
+                                              MBEDTLS_ECP_DP_SECP256R1, reinterpret_cast<const uint8_t *>(kPskd),
+                                              sizeof(kPskd) - 1));
+
+    // ClientHello and ServerHello
+    SuccessOrExit(ret = mbedtls_ecjpake_write_round_one(&client, message, sizeof(message), &length,
+                                                        mbedtls_ctr_drbg_random, &sCtrDrbg));
+    SuccessOrExit(ret = mbedtls_ecjpake_read_round_one(&server, message, length));
+    SuccessOrExit(ret = mbedtls_ecjpake_write_round_one(&server, message, sizeof(message), &length,
+                                                        mbedtls_ctr_drbg_random, &sCtrDrbg));
+    SuccessOrExit(ret = mbedtls_ecjpake_read_round_one(&client, message, length));
+
+    // ServerKeyExchange and ClientKeyExchange
+    SuccessOrExit(ret = mbedtls_ecjpake_write_round_two(&server, message, sizeof(message), &length,
+                                                        mbedtls_ctr_drbg_random, &sCtrDrbg));
+    SuccessOrExit(ret = mbedtls_ecjpake_read_round_two(&client, message, length));
+    SuccessOrExit(ret = mbedtls_ecjpake_write_round_two(&client, message, sizeof(message), &length,
+                                                        mbedtls_ctr_drbg_random, &sCtrDrbg));
+    SuccessOrExit(ret = mbedtls_ecjpake_read_round_two(&server, message, length));
+
+    SuccessOrExit(ret = mbedtls_ecjpake_derive_secret(&client, clientSecret, sizeof(clientSecret), &length,
+                                                      mbedtls_ctr_drbg_random, &sCtrDrbg));
+    SuccessOrExit(ret = mbedtls_ecjpake_derive_secret(&server, serverSecret, sizeof(serverSecret), &length,
+                                                      mbedtls_ctr_drbg_random, &sCtrDrbg));
+    VerifyOrExit(memcmp(clientSecret, serverSecret, length) == 0, ret = -1);
+
+exit:
+    if (ret != 0)
+    {
+        sErrors++;
+    }
+
+    mbedtls_ecjpake_free(&server);
+    mbedtls_ecjpake_free(&client);
+
+    (void)aIteration;
+}
+
+void SetUpCcm(void)
+{
+    const uint8_t key[kSizeOfKey] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                                     0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10};
+
+    memset(sRecord, 0x5a, sizeof(sRecord));
+    memset(sNonce, 0, sizeof(sNonce));
+    memset(sAdditionalData, 0, sizeof(sAdditionalData));
+
+    mbedtls_ccm_init(&sCcm);
+
+    if (mbedtls_ccm_setkey(&sCcm, MBEDTLS_CIPHER_ID_AES, key, kSizeOfKey * 8) != 0 ||
+        mbedtls_ccm_encrypt_and_tag(&sCcm, sizeof(sRecord), sNonce, sizeof(sNonce), sAdditionalData,
+                                    sizeof(sAdditionalData), sRecord, sCipher, sTag, sizeof(sTag)) != 0)
+    {
+        sErrors++;
+    }
+}
+
+void TearDownCcm(void)
+{
+    mbedtls_ccm_free(&sCcm);
+}
+
+void RunCcmEncrypt(unsigned long aIteration)
+{
+    // the explicit nonce is the record sequence number
+    memcpy(sNonce + sizeof(sNonce) - sizeof(aIteration), &aIteration, sizeof(aIteration));
+
+    if (mbedtls_ccm_encrypt_and_tag(&sCcm, sizeof(sRecord), sNonce, sizeof(sNonce), sAdditionalData,
+                                    sizeof(sAdditionalData), sRecord, sCipher, sTag, sizeof(sTag)) != 0)
+    {
+        sErrors++;
+    }
+}
+
+void RunCcmDecrypt(unsigned long aIteration)
+{
+    uint8_t plain[kSizeOfRecord];
+
+    // the record set up is decrypted each time, so the tag keeps verifying
+    if (mbedtls_ccm_auth_decrypt(&sCcm, sizeof(sCipher), sNonce, sizeof(sNonce), sAdditionalData,
+                                 sizeof(sAdditionalData), sCipher, plain, sTag, sizeof(sTag)) != 0)
+    {
+        sErrors++;
+    }
+
+    (void)aIteration;
+}
+
+void RunPskc(unsigned long aIteration)
+{
+    const uint8_t extPanId[kSizeOfExtPanId] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+    ot::Psk::Pskc pskc;
+
+    // PBKDF2 with AES-CMAC-PRF-128, as the commissioner derives it from the passphrase
+    pskc.ComputePskc(extPanId, "OpenThread", "654321");
+
+    (void)aIteration;
+}
+
+const Benchmark sBenchmarks[] = {
+    {"ecjpake_handshake", NoSetUp, RunEcjpake, NoTearDown},
+    {"aes_ccm8_encrypt_record", SetUpCcm, RunCcmEncrypt, TearDownCcm},
+    {"aes_ccm8_decrypt_record", SetUpCcm, RunCcmDecrypt, TearDownCcm},
+    {"pskc_cmac", NoSetUp, RunPskc, NoTearDown},
+};
+
+unsigned long long GetNanoseconds(void)
+{
+    timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<unsigned long long>(now.tv_sec) * 1000000000ull + static_cast<unsigned long long>(now.tv_nsec);
+}
+
+bool HasAesni(void)
+{
+    bool hasAesni = false;
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+    hasAesni = mbedtls_aesni_has_support(MBEDTLS_AESNI_AES) != 0;
+#endif
+
+    return hasAesni;
+}
+
+void help(void)
+{
+    printf("crypto-benchmark - measure the cryptography of commissioning\n"
+           "SYNTAX:\n"
+           "    crypto-benchmark [MILLISECONDS [FILE]]\n"
+           "Each benchmark runs for MILLISECONDS. Results are written in JSON to FILE, or to stdout.\n"
+           "EXAMPLE:\n"
+           "    crypto-benchmark 2000 crypto.json\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int           ret      = -1;
+    unsigned long duration = kDefaultDuration;
+    FILE *        output   = stdout;
+    const size_t  count    = sizeof(sBenchmarks) / sizeof(sBenchmarks[0]);
+
+    mbedtls_entropy_init(&sEntropy);
+    mbedtls_ctr_drbg_init(&sCtrDrbg);
+
+    if (argc > 3 || (argc > 1 && (duration = strtoul(argv[1], NULL, 0)) == 0))
+    {
+        ExitNow(help());
+    }
+
+    if (argc == 3)
+    {
+        VerifyOrExit((output = fopen(argv[2], "w")) != NULL,
+                     fprintf(stderr, "Cannot open %s: %s\n", argv[2], strerror(errno)));
+    }
+
+    VerifyOrExit(mbedtls_ctr_drbg_seed(&sCtrDrbg, mbedtls_entropy_func, &sEntropy, NULL, 0) == 0,
+                 fprintf(stderr, "Cannot seed the random generator\n"));
+
+#if defined(OTBR_MBEDTLS_PROFILE_SPEED)
+    fprintf(output, "{\n  \"profile\": \"speed\",\n");
+#else
+    fprintf(output, "{\n  \"profile\": \"size\",\n");
+#endif
+    fprintf(output, "  \"aesni\": %s,\n  \"benchmarks\": [\n", HasAesni() ? "true" : "false");
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Benchmark &  benchmark = sBenchmarks[i];
+        unsigned long long start;
+        unsigned long long elapsed;
+        unsigned long      iterations = 0;
+
+        benchmark.mSetUp();
+
+        // An untimed run warms up caches, and builds the AES tables where they are generated on first use.
+        // EC-JPAKE sets up fresh contexts on every run, so its curve tables are part of each measurement.
+        benchmark.mRun(0);
+
+        start = GetNanoseconds();
+
+        // operations differ in cost by orders of magnitude, so each runs for the same time
+        do
+        {
+            benchmark.mRun(++iterations);
+            elapsed = GetNanoseconds() - start;
+        } while (elapsed < duration * 1000000ull);
+
+        benchmark.mTearDown();
+
+        fprintf(output, "    {\"name\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.1f}%s\n", benchmark.mName,
+                iterations, static_cast<double>(elapsed) / static_cast<double>(iterations), i + 1 < count ? "," : "");
+    }
+
+    fprintf(output, "  ]\n}\n");
+
+    VerifyOrExit(sErrors == 0, fprintf(stderr, "%lu operations failed\n", sErrors));
+    ret = 0;
+
+exit:
+    mbedtls_ctr_drbg_free(&sCtrDrbg);
+    mbedtls_entropy_free(&sEntropy);
+
+    if (output != NULL && output != stdout)
+    {
+        fclose(output);
+    }
+
+    return ret;
+}
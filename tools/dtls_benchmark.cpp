@@ -0,0 +1,553 @@
+/*
+ *    Copyright (c) 2017, The OpenThread Authors.
+ *    All rights reserved.
+ *
+ *    Redistribution and use in source and binary forms, with or without
+ *    modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *    3. Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *    POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file
+ *   This file implements a load test of DTLS handshakes with simulated joiners.
+ */
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/timing.h>
+
+#include "common/code_utils.hpp"
+#include "common/dtls.hpp"
+
+using namespace ot::BorderRouter;
+
+namespace {
+
+enum
+{
+    kDefaultJoiners        = 100,
+    kDefaultRate           = 10,      ///< Joiners arriving per second.
+    kServerPort            = 49999,   ///< Port of the DTLS server under test.
+    kPollInterval          = 10,      ///< Max wait of either loop in miniseconds.
+    kSampleInterval        = 100,     ///< Interval of sampling open fds of the server in miniseconds.
+    kHandshakeTimeoutMin   = 1000,    ///< Initial retransmission timeout of joiners in miniseconds.
+    kHandshakeTimeoutMax   = 16000,   ///< A joiner gives up once its retransmission timeout exceeds this.
+    kNanosecondsPerMilli   = 1000000,
+    kMillisecondsPerSecond = 1000,
+};
+
+const char kPskd[] = "J01NME";
+const char kSeed[] = "dtls-benchmark"; ///< Personalization of the random generator of the server.
+
+/**
+ * This structure reports the outcome of one joiner from the joiner process to the server process.
+ *
+ */
+struct Result
+{
+    int32_t  mError;    ///< 0 on success, otherwise the mbedTLS error.
+    uint64_t mStarted;  ///< When the joiner sent its first ClientHello, in nanoseconds since the start.
+    uint64_t mFinished; ///< When the joiner completed or gave up, in nanoseconds since the start.
+};
+
+struct Joiner
+{
+    mbedtls_ssl_context          mSsl;
+    mbedtls_timing_delay_context mTimer;
+    int                          mSocket;
+    uint64_t                     mStarted;
+};
+
+unsigned int sLoss   = 0; ///< Datagrams dropped each way, in 1/100 percent.
+uint32_t     sRandom = 0x12345678;
+unsigned int sReady  = 0;
+
+uint64_t GetNanoseconds(void)
+{
+    timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * This function decides whether to drop a datagram, the same way for every run.
+ *
+ */
+bool IsLost(void)
+{
+    // xorshift32
+    sRandom ^= sRandom << 13;
+    sRandom ^= sRandom >> 17;
+    sRandom ^= sRandom << 5;
+
+    return sRandom % 10000 < sLoss;
+}
+
+int SendJoiner(void *aContext, const unsigned char *aBuffer, size_t aLength)
+{
+    Joiner *joiner = static_cast<Joiner *>(aContext);
+    ssize_t rval;
+
+    VerifyOrExit(!IsLost(), rval = static_cast<ssize_t>(aLength));
+
+    rval = send(joiner->mSocket, aBuffer, aLength, 0);
+
+    if (rval < 0)
+    {
+        rval = (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+exit:
+    return static_cast<int>(rval);
+}
+
+int ReceiveJoiner(void *aContext, unsigned char *aBuffer, size_t aLength)
+{
+    Joiner *joiner = static_cast<Joiner *>(aContext);
+    ssize_t rval   = recv(joiner->mSocket, aBuffer, aLength, 0);
+
+    if (rval < 0)
+    {
+        rval = (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_RECV_FAILED;
+    }
+    else if (IsLost())
+    {
+        rval = MBEDTLS_ERR_SSL_WANT_READ;
+    }
+
+    return static_cast<int>(rval);
+}
+
+Joiner *StartJoiner(mbedtls_ssl_config &aConf, uint64_t aNow)
+{
+    Joiner *     joiner = new Joiner;
+    sockaddr_in6 server;
+    int          rval;
+
+    memset(&server, 0, sizeof(server));
+    server.sin6_family = AF_INET6;
+    server.sin6_addr   = in6addr_loopback;
+    server.sin6_port   = htons(kServerPort);
+
+    joiner->mStarted = aNow;
+    mbedtls_ssl_init(&joiner->mSsl);
+    VerifyOrExit((joiner->mSocket = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK, 0)) >= 0,
+                 perror("socket"), rval = -1);
+    VerifyOrExit((rval = connect(joiner->mSocket, reinterpret_cast<sockaddr *>(&server), sizeof(server))) == 0,
+                 perror("connect"));
+
+    SuccessOrExit(rval = mbedtls_ssl_setup(&joiner->mSsl, &aConf));
+    SuccessOrExit(rval = mbedtls_ssl_set_hs_ecjpake_password(&joiner->mSsl, reinterpret_cast<const uint8_t *>(kPskd),
+                                                             sizeof(kPskd) - 1));
+    mbedtls_ssl_set_bio(&joiner->mSsl, joiner, SendJoiner, ReceiveJoiner, NULL);
+    mbedtls_ssl_set_timer_cb(&joiner->mSsl, &joiner->mTimer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+
+exit:
+    if (rval != 0)
+    {
+        if (joiner->mSocket >= 0)
+        {
+            close(joiner->mSocket);
+        }
+
+        mbedtls_ssl_free(&joiner->mSsl);
+        delete joiner;
+        joiner = NULL;
+    }
+
+    return joiner;
+}
+
+void StopJoiner(Joiner *aJoiner, int aError, uint64_t aNow, int aResultFd)
+{
+    Result result;
+
+    if (aError == 0)
+    {
+        // let the server free the session rather than wait for it to expire
+        mbedtls_ssl_close_notify(&aJoiner->mSsl);
+    }
+
+    result.mError    = aError;
+    result.mStarted  = aJoiner->mStarted;
+    result.mFinished = aNow;
+
+    if (write(aResultFd, &result, sizeof(result)) != sizeof(result))
+    {
+        perror("write");
+    }
+
+    close(aJoiner->mSocket);
+    mbedtls_ssl_free(&aJoiner->mSsl);
+    delete aJoiner;
+}
+
+/**
+ * This function runs the joiners, each starting a handshake at its arrival time.
+ *
+ */
+int RunJoiners(unsigned long aCount, unsigned long aRate, int aStartFd, int aResultFd)
+{
+    static const int         ciphersuites[] = {MBEDTLS_TLS_ECJPAKE_WITH_AES_128_CCM_8, 0};
+    mbedtls_entropy_context  entropy;
+    mbedtls_ctr_drbg_context ctrDrbg;
+    mbedtls_ssl_config       conf;
+    std::vector<Joiner *>    joiners;
+    unsigned long            started = 0;
+    uint64_t                 begin   = 0;
+    char                     go;
+    int                      rval;
+
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&ctrDrbg);
+    mbedtls_ssl_config_init(&conf);
+
+    SuccessOrExit(rval = mbedtls_ctr_drbg_seed(&ctrDrbg, mbedtls_entropy_func, &entropy, NULL, 0));
+    SuccessOrExit(rval = mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_DATAGRAM,
+                                                     MBEDTLS_SSL_PRESET_DEFAULT));
+    mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctrDrbg);
+    mbedtls_ssl_conf_min_version(&conf, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
+    mbedtls_ssl_conf_max_version(&conf, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
+    mbedtls_ssl_conf_ciphersuites(&conf, ciphersuites);
+    mbedtls_ssl_conf_handshake_timeout(&conf, kHandshakeTimeoutMin, kHandshakeTimeoutMax);
+
+    // wait until the server is listening
+    VerifyOrExit(read(aStartFd, &go, sizeof(go)) == sizeof(go), rval = -1);
+    begin = GetNanoseconds();
+
+    while (started < aCount || !joiners.empty())
+    {
+        uint64_t now   = GetNanoseconds() - begin;
+        int      maxFd = -1;
+        fd_set   readFdSet;
+        timeval  timeout;
+
+        while (started < aCount && now >= started * kMillisecondsPerSecond * kNanosecondsPerMilli / aRate)
+        {
+            Joiner *joiner = StartJoiner(conf, now);
+
+            VerifyOrExit(joiner != NULL, rval = -1);
+            joiners.push_back(joiner);
+            ++started;
+        }
+
+        // every joiner makes progress when its datagrams arrive or its retransmission timer fires
+        for (std::vector<Joiner *>::iterator it = joiners.begin(); it != joiners.end();)
+        {
+            Joiner *joiner = *it;
+
+            rval = mbedtls_ssl_handshake(&joiner->mSsl);
+
+            if (rval == MBEDTLS_ERR_SSL_WANT_READ || rval == MBEDTLS_ERR_SSL_WANT_WRITE)
+            {
+                ++it;
+                continue;
+            }
+
+            StopJoiner(joiner, rval, GetNanoseconds() - begin, aResultFd);
+            it = joiners.erase(it);
+        }
+
+        FD_ZERO(&readFdSet);
+
+        for (std::vector<Joiner *>::iterator it = joiners.begin(); it != joiners.end(); ++it)
+        {
+            FD_SET((*it)->mSocket, &readFdSet);
+            maxFd = std::max(maxFd, (*it)->mSocket);
+        }
+
+        timeout.tv_sec  = 0;
+        timeout.tv_usec = kPollInterval * 1000;
+        VerifyOrExit(select(maxFd + 1, &readFdSet, NULL, NULL, &timeout) >= 0 || errno == EINTR, perror("select"),
+                     rval = -1);
+    }
+
+    rval = 0;
+
+exit:
+    for (std::vector<Joiner *>::iterator it = joiners.begin(); it != joiners.end(); ++it)
+    {
+        StopJoiner(*it, MBEDTLS_ERR_SSL_TIMEOUT, GetNanoseconds() - begin, aResultFd);
+    }
+
+    mbedtls_ssl_config_free(&conf);
+    mbedtls_ctr_drbg_free(&ctrDrbg);
+    mbedtls_entropy_free(&entropy);
+
+    return rval;
+}
+
+void HandleSessionState(Dtls::Session &aSession, Dtls::Session::State aState, void *aContext)
+{
+    if (aState == Dtls::Session::kStateReady)
+    {
+        ++sReady;
+    }
+
+    (void)aSession;
+    (void)aContext;
+}
+
+unsigned int CountFds(void)
+{
+    unsigned int count = 0;
+    DIR *        dir   = opendir("/proc/self/fd");
+
+    VerifyOrExit(dir != NULL);
+
+    while (readdir(dir) != NULL)
+    {
+        ++count;
+    }
+
+    closedir(dir);
+
+    // ".", ".." and the descriptor of the directory itself
+    count -= 3;
+
+exit:
+    return count;
+}
+
+unsigned long GetPeakRss(void)
+{
+    unsigned long peak = 0;
+    char          line[128];
+    FILE *        status = fopen("/proc/self/status", "r");
+
+    VerifyOrExit(status != NULL);
+
+    while (fgets(line, sizeof(line), status) != NULL)
+    {
+        if (sscanf(line, "VmHWM: %lu kB", &peak) == 1)
+        {
+            break;
+        }
+    }
+
+    fclose(status);
+
+exit:
+    return peak;
+}
+
+double GetPercentile(const std::vector<uint64_t> &aSorted, unsigned int aPercent)
+{
+    double value = 0;
+
+    if (!aSorted.empty())
+    {
+        value = static_cast<double>(aSorted[(aSorted.size() - 1) * aPercent / 100]) / kNanosecondsPerMilli;
+    }
+
+    return value;
+}
+
+void help(void)
+{
+    printf("dtls-benchmark - measure DTLS handshakes of simulated joiners\n"
+           "SYNTAX:\n"
+           "    dtls-benchmark [JOINERS [RATE [LOSS [FILE]]]]\n"
+           "JOINERS joiners arrive at RATE per second, and LOSS percent of datagrams are dropped each way.\n"
+           "Results are written in JSON to FILE, or to stdout.\n"
+           "EXAMPLE:\n"
+           "    dtls-benchmark 200 20 5 dtls.json\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int                   ret          = -1;
+    unsigned long         count        = kDefaultJoiners;
+    unsigned long         rate         = kDefaultRate;
+    double                loss         = 0;
+    FILE *                output       = stdout;
+    Dtls::Server *        server       = NULL;
+    int                   startFds[2]  = {-1, -1};
+    int                   resultFds[2] = {-1, -1};
+    pid_t                 pid          = -1;
+    unsigned int          peakFds      = 0;
+    uint64_t              lastSample   = 0;
+    uint64_t              lastFinished = 0;
+    unsigned long         failed       = 0;
+    std::vector<uint64_t> latencies;
+    Result                result;
+    ssize_t               rval;
+
+    if (argc > 5 || (argc > 1 && (count = strtoul(argv[1], NULL, 0)) == 0) ||
+        (argc > 2 && (rate = strtoul(argv[2], NULL, 0)) == 0) ||
+        (argc > 3 && ((loss = strtod(argv[3], NULL)) < 0 || loss > 100)))
+    {
+        ExitNow(help());
+    }
+
+    if (argc == 5)
+    {
+        VerifyOrExit((output = fopen(argv[4], "w")) != NULL,
+                     fprintf(stderr, "Cannot open %s: %s\n", argv[4], strerror(errno)));
+    }
+
+    sLoss = static_cast<unsigned int>(loss * 100);
+
+    // The joiners run in their own process, so that fds and memory measured here are the server's.
+    VerifyOrExit(pipe(startFds) == 0 && pipe(resultFds) == 0, perror("pipe"));
+    VerifyOrExit((pid = fork()) >= 0, perror("fork"));
+
+    if (pid == 0)
+    {
+        close(startFds[1]);
+        close(resultFds[0]);
+        _exit(RunJoiners(count, rate, startFds[0], resultFds[1]) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(startFds[0]);
+    close(resultFds[1]);
+    startFds[0] = resultFds[1] = -1;
+
+    server = Dtls::Server::Create(kServerPort, HandleSessionState, NULL);
+    VerifyOrExit(server->SetSeed(reinterpret_cast<const uint8_t *>(kSeed), sizeof(kSeed) - 1) == OTBR_ERROR_NONE);
+    VerifyOrExit(server->SetPSK(reinterpret_cast<const uint8_t *>(kPskd), sizeof(kPskd) - 1) == OTBR_ERROR_NONE);
+    VerifyOrExit(server->Start() == OTBR_ERROR_NONE, fprintf(stderr, "Failed to start the DTLS server\n"));
+    VerifyOrExit(write(startFds[1], "g", 1) == 1, perror("write"));
+
+    // serve until the joiner process has reported every joiner
+    while (true)
+    {
+        fd_set   readFdSet;
+        fd_set   writeFdSet;
+        fd_set   errorFdSet;
+        int      maxFd = resultFds[0];
+        timeval  timeout;
+        uint64_t now;
+
+        FD_ZERO(&readFdSet);
+        FD_ZERO(&writeFdSet);
+        FD_ZERO(&errorFdSet);
+        FD_SET(resultFds[0], &readFdSet);
+        timeout.tv_sec  = 0;
+        timeout.tv_usec = kPollInterval * 1000;
+
+        server->UpdateFdSet(readFdSet, writeFdSet, errorFdSet, maxFd, timeout);
+        VerifyOrExit(select(maxFd + 1, &readFdSet, &writeFdSet, &errorFdSet, &timeout) >= 0 || errno == EINTR,
+                     perror("select"));
+        server->Process(readFdSet, writeFdSet, errorFdSet);
+
+        now = GetNanoseconds();
+
+        if (now - lastSample >= static_cast<uint64_t>(kSampleInterval) * kNanosecondsPerMilli)
+        {
+            peakFds    = std::max(peakFds, CountFds());
+            lastSample = now;
+        }
+
+        if (FD_ISSET(resultFds[0], &readFdSet))
+        {
+            // a result is written at once, far below PIPE_BUF
+            VerifyOrExit((rval = read(resultFds[0], &result, sizeof(result))) != 0);
+            VerifyOrExit(rval == sizeof(result), perror("read"));
+
+            if (result.mError == 0)
+            {
+                latencies.push_back(result.mFinished - result.mStarted);
+                lastFinished = std::max(lastFinished, result.mFinished);
+            }
+            else
+            {
+                ++failed;
+            }
+        }
+    }
+
+exit:
+    if (pid > 0)
+    {
+        int status;
+
+        // a joiner process still waiting for the start gives up once the pipe is closed
+        close(startFds[1]);
+        startFds[1] = -1;
+        waitpid(pid, &status, 0);
+
+        if (latencies.size() + failed == count)
+        {
+            std::sort(latencies.begin(), latencies.end());
+
+            fprintf(output, "{\n  \"joiners\": %lu,\n  \"rate\": %lu,\n  \"loss\": %.2f,\n", count, rate, loss);
+            fprintf(output, "  \"succeeded\": %zu,\n  \"failed\": %lu,\n  \"ready_sessions\": %u,\n", latencies.size(),
+                    failed, sReady);
+            fprintf(output, "  \"handshakes_per_second\": %.2f,\n",
+                    lastFinished ? static_cast<double>(latencies.size()) * 1e9 / static_cast<double>(lastFinished) : 0);
+            fprintf(output,
+                    "  \"latency_ms\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f},\n",
+                    GetPercentile(latencies, 50), GetPercentile(latencies, 90), GetPercentile(latencies, 99),
+                    GetPercentile(latencies, 100));
+            fprintf(output, "  \"peak_fds\": %u,\n  \"peak_rss_kb\": %lu\n}\n", peakFds, GetPeakRss());
+
+            ret = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS ? 0 : -1;
+        }
+    }
+
+    if (server != NULL)
+    {
+        Dtls::Server::Destroy(server);
+    }
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        if (startFds[i] >= 0)
+        {
+            close(startFds[i]);
+        }
+
+        if (resultFds[i] >= 0)
+        {
+            close(resultFds[i]);
+        }
+    }
+
+    if (output != NULL && output != stdout)
+    {
+        fclose(output);
+    }
+
+    return ret;
+}
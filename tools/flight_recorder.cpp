@@ -26,31 +26,43 @@
  *    POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef LIBCOAP_H_
-#define LIBCOAP_H_
+/**
+ * @file
+ *   This file implements a simple tool to extract logs from a flight recorder file.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
 
-/// @cond
+#include "common/code_utils.hpp"
+#include "common/flight_recorder.hpp"
 
-#define WITH_POSIX 1
-#include "coap_config.h"
-#include <coap/coap.h>
+using namespace ot::BorderRouter;
 
-#define MAX_COAP_PACKET 1280
+void help(void)
+{
+    printf("flight-recorder - extract logs from a flight recorder file\n"
+           "SYNTAX:\n"
+           "    flight-recorder <FILE>\n"
+           "EXAMPLE:\n"
+           "    flight-recorder /tmp/otbr-agent.rec\n");
+}
 
-typedef struct coap_packet_t
+int main(int argc, char *argv[])
 {
-    coap_if_handle_t       hnd; /**< the interface handle */
-    coap_address_t         src; /**< the packet's source address */
-    coap_address_t         dst; /**< the packet's destination address */
-    const coap_endpoint_t *interface;
+    int ret = -1;
 
-    int   ifindex;
-    void *session; /**< opaque session data */
+    if (argc != 2)
+    {
+        ExitNow(help());
+    }
 
-    size_t        length;                   /**< length of payload */
-    unsigned char payload[MAX_COAP_PACKET]; /**< payload */
-} coap_packet_t;
+    VerifyOrExit(FlightRecorder::Dump(argv[1], stdout) == OTBR_ERROR_NONE,
+                 fprintf(stderr, "Cannot extract %s: %s\n", argv[1], strerror(errno)));
 
-/// @endcond
+    ret = 0;
 
-#endif
+exit:
+    return ret;
+}